@@ -25,8 +25,10 @@ namespace coyote
         NotExistingResource = 301,
         ClientAttached = 400,
         ClientNotAttached = 401,
+        UncontrolledThread = 402,
         InternalError = 500,
-        SchedulerDisabled = 501
+        SchedulerDisabled = 501,
+        InvalidCheckpoint = 502
     };
 }
 
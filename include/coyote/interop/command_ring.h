@@ -0,0 +1,151 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_COMMAND_RING_H
+#define COYOTE_COMMAND_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include "../error_code.h"
+
+namespace coyote
+{
+	// Types of non-blocking commands that a host can batch through a command ring.
+	enum class CommandType : uint32_t
+	{
+		None = 0,
+		CreateOperation,
+		CreateResource,
+		SignalResource,
+		SignalOperationResource,
+		DeleteResource
+	};
+
+	// A non-blocking scheduler command.
+	struct Command
+	{
+		// The type of this command.
+		CommandType type;
+
+		// The operation or resource id that this command targets.
+		uint64_t arg0;
+
+		// The operation id that is signaled by a 'SignalOperationResource' command, else unused.
+		uint64_t arg1;
+	};
+
+	// Bounded lock-free ring of non-blocking commands. Any number of host threads can enqueue commands
+	// without taking the scheduler lock, while the scheduler drains them in order, from a single thread at
+	// a time, at the next synchronous call. This is the bounded queue algorithm by Dmitry Vyukov, where
+	// each slot carries a sequence number that tells producers and the consumer whether it is free or full.
+	class CommandRing
+	{
+	private:
+		struct Slot
+		{
+			std::atomic<uint64_t> sequence;
+			Command command;
+		};
+
+		// The slots of the ring.
+		std::unique_ptr<Slot[]> slots;
+
+		// Mask used to map a position to a slot, which requires a power of two capacity.
+		const uint64_t mask;
+
+		// The next position that a producer will write to.
+		alignas(64) std::atomic<uint64_t> enqueue_pos;
+
+		// The next position that the consumer will read from.
+		alignas(64) uint64_t dequeue_pos;
+
+	public:
+		CommandRing(size_t capacity) :
+			slots(std::make_unique<Slot[]>(round_up_capacity(capacity))),
+			mask(round_up_capacity(capacity) - 1),
+			enqueue_pos(0),
+			dequeue_pos(0)
+		{
+			for (uint64_t i = 0; i <= mask; i++)
+			{
+				slots[i].sequence.store(i, std::memory_order_relaxed);
+			}
+		}
+
+		CommandRing(CommandRing&& ring) = delete;
+		CommandRing(CommandRing const&) = delete;
+
+		CommandRing& operator=(CommandRing&& ring) = delete;
+		CommandRing& operator=(CommandRing const&) = delete;
+
+		// Tries to enqueue the specified command. Returns false if the ring is full, in which case
+		// the host should make a synchronous scheduler call to drain it before trying again.
+		bool try_enqueue(CommandType type, uint64_t arg0, uint64_t arg1) noexcept
+		{
+			uint64_t pos = enqueue_pos.load(std::memory_order_relaxed);
+			while (true)
+			{
+				Slot& slot = slots[pos & mask];
+				uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+				int64_t diff = (int64_t)sequence - (int64_t)pos;
+				if (diff == 0)
+				{
+					if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+					{
+						slot.command.type = type;
+						slot.command.arg0 = arg0;
+						slot.command.arg1 = arg1;
+						slot.sequence.store(pos + 1, std::memory_order_release);
+						return true;
+					}
+				}
+				else if (diff < 0)
+				{
+					return false;
+				}
+				else
+				{
+					pos = enqueue_pos.load(std::memory_order_relaxed);
+				}
+			}
+		}
+
+		// Tries to dequeue the next command. This must only be called by one thread at a time.
+		bool try_dequeue(Command& command) noexcept
+		{
+			Slot& slot = slots[dequeue_pos & mask];
+			uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+			if (sequence != dequeue_pos + 1)
+			{
+				return false;
+			}
+
+			command = slot.command;
+			slot.sequence.store(dequeue_pos + mask + 1, std::memory_order_release);
+			dequeue_pos++;
+			return true;
+		}
+
+		// Returns the max number of commands that the ring can hold.
+		size_t capacity() const noexcept
+		{
+			return (size_t)mask + 1;
+		}
+
+	private:
+		static size_t round_up_capacity(size_t capacity) noexcept
+		{
+			size_t result = 2;
+			while (result < capacity)
+			{
+				result <<= 1;
+			}
+
+			return result;
+		}
+	};
+}
+
+#endif // COYOTE_COMMAND_RING_H
@@ -36,10 +36,31 @@ namespace coyote
 		// True if this operation is currently scheduled, else false.
 		bool is_scheduled;
 
+		// True if this operation has been scheduled at least once, else false.
+		bool was_scheduled;
+
+		// The symmetry class of this operation, if it has one.
+		size_t symmetry_class;
+
+		// True if this operation belongs to a symmetry class and was never scheduled, so it is interchangeable
+		// with the other such operations of its class, else false.
+		bool is_interchangeable;
+
+		// True if this operation waited for or signaled a resource, else false.
+		bool has_accessed_resource;
+
+		// The id of the resource that this operation last waited for or signaled, if it accessed one.
+		size_t last_resource_id;
+
 		Operation(size_t operation_id) noexcept :
 			id(operation_id),
 			status(OperationStatus::None),
-			is_scheduled(false)
+			is_scheduled(false),
+			was_scheduled(false),
+			symmetry_class(0),
+			is_interchangeable(false),
+			has_accessed_resource(false),
+			last_resource_id(0)
 		{
 		}
 
@@ -5,20 +5,35 @@
 #define COYOTE_SCHEDULER_H
 
 #include <iostream>
+#include <algorithm>
 #include <condition_variable>
 #include <cstdint>
+#include <filesystem>
 #include <map>
 #include <memory>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 #include "error_code.h"
 #include "settings.h"
+#include "interop/command_ring.h"
+#include "schedules/campaign_checkpoint.h"
+#include "schedules/failure_signature.h"
+#include "schedules/schedule_corpus.h"
+#include "schedules/schedule_trace.h"
+#include "tracing/tracer.h"
 #include "operations/operation.h"
 #include "operations/operations.h"
 #include "operations/operation_status.h"
 #include "strategies/strategy.h"
+#include "strategies/dfs_strategy.h"
+#include "strategies/fair_strategy.h"
 #include "strategies/random_strategy.h"
 #include "strategies/pct_strategy.h"
+#include "strategies/portfolio_strategy.h"
+#include "strategies/pos_strategy.h"
+#include "strategies/qlearning_strategy.h"
+#include "strategies/replay_strategy.h"
 
 namespace coyote
 {
@@ -37,12 +52,33 @@ namespace coyote
 		// Vector of enabled and disabled operation ids.
 		Operations operations;
 
+		// The enabled operations without the redundant interchangeable operations of each symmetry class.
+		Operations canonical_operations;
+
+		// Map from symmetry classes to their interchangeable enabled operation with the lowest id.
+		std::unordered_map<size_t, size_t> symmetry_representatives;
+
+		// Count of operations that are interchangeable with the other operations of their symmetry class.
+		size_t interchangeable_op_count;
+
 		// Map from unique resource ids to blocked operation ids.
 		std::map<size_t, std::shared_ptr<std::unordered_set<size_t>>> resource_map;
 
 		// Mutex that synchronizes access to the scheduler.
 		std::unique_ptr<std::mutex> mutex;
 
+		// Ring of non-blocking commands that are applied at the next synchronous call, if enabled.
+		std::unique_ptr<CommandRing> command_ring;
+
+		// Traces scheduler events to a file, if enabled.
+		std::unique_ptr<Tracer> tracer;
+
+		// Appends the schedule of each iteration to a corpus, if enabled.
+		std::unique_ptr<ScheduleCorpusWriter> corpus_writer;
+
+		// The choices made so far in the current testing iteration.
+		ScheduleTrace schedule;
+
 		// Conditional variable that can be used to block scheduling a next operation until all pending
 		// operations have started.
 		std::condition_variable pending_operations_cv;
@@ -53,6 +89,11 @@ namespace coyote
 		// Count of newly created operations that have not started yet.
 		size_t pending_start_operation_count;
 
+		// Ids of the operations created since the last scheduling point, in the order they were created.
+		// They start concurrently, so they are added to the enabled operations in this order at the next
+		// scheduling point, which keeps the choices of the strategy independent of thread timing.
+		std::vector<size_t> created_operation_ids;
+
 		// The id of the main operation.
 		const size_t main_op_id = 0;
 
@@ -65,6 +106,27 @@ namespace coyote
 		// The last assigned error code, else success.
 		ErrorCode last_error_code;
 
+		// The error of the first command of the ring that failed in the current iteration, else success.
+		ErrorCode command_error_code;
+
+		// The signature of the failure that the client reported in the current iteration, or '0'.
+		uint64_t reported_failure_signature;
+
+		// The signature of the failure of the last completed iteration, if it failed.
+		FailureSignature last_failure;
+
+		// True if the operation, resource and last schedule steps of a failure of the current iteration were
+		// recorded, else false.
+		bool is_failure_recorded;
+
+		// True if the checkpoint file of the settings could not be restored when the scheduler was created,
+		// such as because it belongs to a campaign with other settings, else false. The periodic checkpoints
+		// do not overwrite such a file, so that a mistake in the settings does not destroy the campaign.
+		bool is_checkpoint_rejected;
+
+		// True if each call is checked to come from the thread of the scheduled operation, else false.
+		const bool is_thread_validation_enabled;
+
 	public:
 		Scheduler() noexcept :
 			Scheduler(std::make_unique<Settings>())
@@ -74,14 +136,29 @@ namespace coyote
 		Scheduler(std::unique_ptr<Settings> settings) noexcept :
 			configuration(std::move(settings)),
 			strategy(create_strategy()),
+			interchangeable_op_count(0),
 			mutex(std::make_unique<std::mutex>()),
+			tracer(create_tracer()),
+			corpus_writer(create_corpus_writer()),
 			pending_operations_cv(),
 			scheduled_op_id(0),
 			pending_start_operation_count(0),
 			is_attached(false),
 			iteration_count(0),
-			last_error_code(ErrorCode::Success)
+			last_error_code(ErrorCode::Success),
+			command_error_code(ErrorCode::Success),
+			reported_failure_signature(0),
+			is_failure_recorded(false),
+			is_checkpoint_rejected(false),
+			is_thread_validation_enabled(configuration->thread_validation())
 		{
+			// Resume the campaign if it was checkpointed before, such as by a process that was pre-empted.
+			const std::string& checkpoint_path = configuration->checkpoint_file_path();
+			std::error_code error;
+			if (!checkpoint_path.empty() && std::filesystem::exists(checkpoint_path, error))
+			{
+				is_checkpoint_rejected = restore_checkpoint(checkpoint_path) != ErrorCode::Success;
+			}
 		}
 
 		// Attaches to the scheduler. This should be called at the beginning of a testing iteration.
@@ -108,6 +185,18 @@ namespace coyote
 				is_attached = true;
 				iteration_count += 1;
 				last_error_code = ErrorCode::Success;
+				command_error_code = ErrorCode::Success;
+				reported_failure_signature = 0;
+				last_failure = FailureSignature();
+				is_failure_recorded = false;
+				interchangeable_op_count = 0;
+				schedule.clear();
+				if (tracer != nullptr)
+				{
+					tracer->set_iteration(iteration_count);
+				}
+
+				trace(TraceEventType::Attach, main_op_id, iteration_count);
 
 				if (iteration_count > 1)
 				{
@@ -120,11 +209,11 @@ namespace coyote
 			}
 			catch (ErrorCode error_code)
 			{
-				last_error_code = error_code;
+				assign_error_code(error_code);
 			}
 			catch (...)
 			{
-				last_error_code = ErrorCode::Failure;
+				assign_error_code(ErrorCode::Failure);
 			}
 
 			return last_error_code;
@@ -152,6 +241,21 @@ namespace coyote
 				}
 
 				is_attached = false;
+				trace(TraceEventType::Detach, main_op_id, iteration_count);
+
+				// A failed command fails the iteration, unless the iteration already failed.
+				if (last_error_code == ErrorCode::Success)
+				{
+					last_error_code = command_error_code;
+				}
+
+				// A failure whose context was not recorded when it was found is recorded where the iteration ended.
+				if (last_error_code != ErrorCode::Success || reported_failure_signature != 0)
+				{
+					record_failure_inner();
+					last_failure.error_code = last_error_code;
+					last_failure.reported_failure = reported_failure_signature;
+				}
 
 				Operation* main_op = operation_map.at(main_op_id).get();
 				main_op->status = OperationStatus::Completed;
@@ -167,6 +271,7 @@ namespace coyote
 	#endif // COYOTE_DEBUG_LOG
 						// If the operation has not already completed, then cancel it.
 						next_op->is_scheduled = true;
+						next_op->was_scheduled = true;
 						next_op->status = OperationStatus::Completed;
 						operations.disable(next_op->id);
 						next_op->cv.notify_all();
@@ -177,14 +282,34 @@ namespace coyote
 				operations.clear();
 				resource_map.clear();
 				pending_start_operation_count = 0;
+				created_operation_ids.clear();
+
+				// Commands that were not drained belong to the completed iteration, so discard them.
+				discard_commands_inner();
+
+				uint64_t failure = reported_failure_signature != 0 ? reported_failure_signature : (uint64_t)last_error_code;
+				strategy->complete_iteration({ failure, schedule.view().hash(), schedule.size() });
+
+				if (corpus_writer != nullptr)
+				{
+					corpus_writer->append(schedule.view(), strategy->random_seed(), (uint64_t)last_error_code);
+				}
+
+				if (configuration->checkpoint_interval() > 0 && iteration_count % configuration->checkpoint_interval() == 0 &&
+					!is_checkpoint_rejected)
+				{
+					// A checkpoint that could not be saved is saved again at the next interval, as the campaign
+					// itself is not affected.
+					save_checkpoint_inner(configuration->checkpoint_file_path());
+				}
 			}
 			catch (ErrorCode error_code)
 			{
-				last_error_code = error_code;
+				assign_error_code(error_code);
 			}
 			catch (...)
 			{
-				last_error_code = ErrorCode::Failure;
+				assign_error_code(ErrorCode::Failure);
 			}
 
 			return last_error_code;
@@ -214,20 +339,128 @@ namespace coyote
 					throw ErrorCode::MainOperationExplicitlyCreated;
 				}
 
+				validate_thread_inner();
+				drain_commands_inner();
 				create_operation_inner(operation_id);
 			}
 			catch (ErrorCode error_code)
 			{
-				last_error_code = error_code;
+				assign_error_code(error_code);
 			}
 			catch (...)
 			{
-				last_error_code = ErrorCode::Failure;
+				assign_error_code(ErrorCode::Failure);
 			}
 
 			return last_error_code;
 		}
 		
+		// Creates new operations with the specified ids, taking the scheduler lock only once.
+		ErrorCode create_operations(const size_t* operation_ids, size_t size) noexcept
+		{
+			try
+			{
+				if (configuration->exploration_strategy() == StrategyType::None)
+				{
+					throw ErrorCode::SchedulerDisabled;
+				}
+
+				std::unique_lock<std::mutex> lock(*mutex);
+	#ifdef COYOTE_DEBUG_LOG
+				std::cout << "[coyote::create_operations] creating " << size << " operations" << std::endl;
+	#endif // COYOTE_DEBUG_LOG
+
+				if (!is_attached)
+				{
+					throw ErrorCode::ClientNotAttached;
+				}
+
+				validate_thread_inner();
+				drain_commands_inner();
+
+				for (size_t i = 0; i < size; i++)
+				{
+					size_t operation_id = *(operation_ids + i);
+					if (operation_id == main_op_id)
+					{
+						throw ErrorCode::MainOperationExplicitlyCreated;
+					}
+
+					create_operation_inner(operation_id);
+				}
+			}
+			catch (ErrorCode error_code)
+			{
+				assign_error_code(error_code);
+			}
+			catch (...)
+			{
+				assign_error_code(ErrorCode::Failure);
+			}
+
+			return last_error_code;
+		}
+
+		// Declares the operation with the specified id, which must not have been scheduled yet, as a member of
+		// the specified symmetry class. The operations of a class must be interchangeable: running one of them
+		// instead of another, before either has been scheduled, must lead to an equivalent execution, as is
+		// the case for identical workers. Until an operation of a class is first scheduled, the strategy only
+		// chooses among the interchangeable operations of the class the one with the lowest id, so schedules
+		// that only permute the operations of the class are not explored.
+		ErrorCode set_symmetry_class(size_t operation_id, size_t symmetry_class) noexcept
+		{
+			try
+			{
+				if (configuration->exploration_strategy() == StrategyType::None)
+				{
+					throw ErrorCode::SchedulerDisabled;
+				}
+
+				std::unique_lock<std::mutex> lock(*mutex);
+	#ifdef COYOTE_DEBUG_LOG
+				std::cout << "[coyote::set_symmetry_class] adding operation " << operation_id << " to symmetry class " <<
+					symmetry_class << std::endl;
+	#endif // COYOTE_DEBUG_LOG
+
+				if (!is_attached)
+				{
+					throw ErrorCode::ClientNotAttached;
+				}
+
+				validate_thread_inner();
+				drain_commands_inner();
+
+				auto it = operation_map.find(operation_id);
+				if (it == operation_map.end())
+				{
+					throw ErrorCode::NotExistingOperation;
+				}
+
+				Operation* op = it->second.get();
+				if (op->was_scheduled || op->status == OperationStatus::Completed)
+				{
+					throw ErrorCode::OperationAlreadyStarted;
+				}
+
+				op->symmetry_class = symmetry_class;
+				if (!op->is_interchangeable)
+				{
+					op->is_interchangeable = true;
+					interchangeable_op_count++;
+				}
+			}
+			catch (ErrorCode error_code)
+			{
+				assign_error_code(error_code);
+			}
+			catch (...)
+			{
+				assign_error_code(ErrorCode::Failure);
+			}
+
+			return last_error_code;
+		}
+
 		// Starts executing the operation with the specified id.
 		ErrorCode start_operation(size_t operation_id) noexcept
 		{
@@ -252,15 +485,18 @@ namespace coyote
 					throw ErrorCode::MainOperationExplicitlyStarted;
 				}
 
+				// Apply the queued commands, so that an operation that was created through the ring can start
+				// without a synchronous call in between. This never throws, so the operation always starts.
+				drain_commands_inner();
 				start_operation_inner(operation_id, lock);
 			}
 			catch (ErrorCode error_code)
 			{
-				last_error_code = error_code;
+				assign_error_code(error_code);
 			}
 			catch (...)
 			{
-				last_error_code = ErrorCode::Failure;
+				assign_error_code(ErrorCode::Failure);
 			}
 
 			return last_error_code;
@@ -286,6 +522,9 @@ namespace coyote
 					throw ErrorCode::ClientNotAttached;
 				}
 
+				validate_thread_inner();
+				drain_commands_inner();
+
 				auto it = operation_map.find(operation_id);
 				if (it == operation_map.end())
 				{
@@ -299,6 +538,7 @@ namespace coyote
 				if (join_op->status != OperationStatus::Completed)
 				{
 					join_op->blocked_operation_ids.insert(scheduled_op_id);
+					trace(TraceEventType::JoinOperation, scheduled_op_id, operation_id);
 
 					Operation* scheduled_op = operation_map.at(scheduled_op_id).get();
 					scheduled_op->join_operation(operation_id);
@@ -316,11 +556,11 @@ namespace coyote
 			}
 			catch (ErrorCode error_code)
 			{
-				last_error_code = error_code;
+				assign_error_code(error_code);
 			}
 			catch (...)
 			{
-				last_error_code = ErrorCode::Failure;
+				assign_error_code(ErrorCode::Failure);
 			}
 
 			return last_error_code;
@@ -355,6 +595,9 @@ namespace coyote
 					throw ErrorCode::ClientNotAttached;
 				}
 
+				validate_thread_inner();
+				drain_commands_inner();
+
 				std::vector<size_t> join_operations;
 				for (size_t i = 0; i < size; i++)
 				{
@@ -373,6 +616,7 @@ namespace coyote
 					{
 						join_op->blocked_operation_ids.insert(scheduled_op_id);
 						join_operations.push_back(operation_id);
+						trace(TraceEventType::JoinOperation, scheduled_op_id, operation_id);
 					}
 	#ifdef COYOTE_DEBUG_LOG
 					else
@@ -394,11 +638,11 @@ namespace coyote
 			}
 			catch (ErrorCode error_code)
 			{
-				last_error_code = error_code;
+				assign_error_code(error_code);
 			}
 			catch (...)
 			{
-				last_error_code = ErrorCode::Failure;
+				assign_error_code(ErrorCode::Failure);
 			}
 
 			return last_error_code;
@@ -428,6 +672,9 @@ namespace coyote
 					throw ErrorCode::MainOperationExplicitlyCompleted;
 				}
 
+				validate_thread_inner();
+				drain_commands_inner();
+
 				auto it = operation_map.find(operation_id);
 				if (it == operation_map.end())
 				{
@@ -449,6 +696,7 @@ namespace coyote
 
 				op->status = OperationStatus::Completed;
 				operations.remove(op->id);
+				trace(TraceEventType::CompleteOperation, op->id);
 
 				// Notify any operations that are waiting to join this operation.
 				for (const auto& blocked_id : op->blocked_operation_ids)
@@ -457,6 +705,7 @@ namespace coyote
 					if (blocked_op->on_join_operation(operation_id))
 					{
 						operations.enable(blocked_op->id);
+						trace(TraceEventType::EnableOperation, blocked_op->id, operation_id);
 					}
 				}
 
@@ -465,11 +714,11 @@ namespace coyote
 			}
 			catch (ErrorCode error_code)
 			{
-				last_error_code = error_code;
+				assign_error_code(error_code);
 			}
 			catch (...)
 			{
-				last_error_code = ErrorCode::Failure;
+				assign_error_code(ErrorCode::Failure);
 			}
 
 			return last_error_code;
@@ -495,22 +744,57 @@ namespace coyote
 					throw ErrorCode::ClientNotAttached;
 				}
 
-				auto it = resource_map.find(resource_id);
-				if (it != resource_map.end())
+				validate_thread_inner();
+				drain_commands_inner();
+				create_resource_inner(resource_id);
+			}
+			catch (ErrorCode error_code)
+			{
+				assign_error_code(error_code);
+			}
+			catch (...)
+			{
+				assign_error_code(ErrorCode::Failure);
+			}
+
+			return last_error_code;
+		}
+
+		// Creates new resources with the specified ids, taking the scheduler lock only once.
+		ErrorCode create_resources(const size_t* resource_ids, size_t size) noexcept
+		{
+			try
+			{
+				if (configuration->exploration_strategy() == StrategyType::None)
+				{
+					throw ErrorCode::SchedulerDisabled;
+				}
+
+				std::unique_lock<std::mutex> lock(*mutex);
+	#ifdef COYOTE_DEBUG_LOG
+				std::cout << "[coyote::create_resources] creating " << size << " resources" << std::endl;
+	#endif // COYOTE_DEBUG_LOG
+
+				if (!is_attached)
 				{
-					throw ErrorCode::DuplicateResource;
+					throw ErrorCode::ClientNotAttached;
 				}
 
-				resource_map.insert(std::pair<size_t, std::shared_ptr<std::unordered_set<size_t>>>(
-					resource_id, std::make_shared<std::unordered_set<size_t>>()));
+				validate_thread_inner();
+				drain_commands_inner();
+
+				for (size_t i = 0; i < size; i++)
+				{
+					create_resource_inner(*(resource_ids + i));
+				}
 			}
 			catch (ErrorCode error_code)
 			{
-				last_error_code = error_code;
+				assign_error_code(error_code);
 			}
 			catch (...)
 			{
-				last_error_code = ErrorCode::Failure;
+				assign_error_code(ErrorCode::Failure);
 			}
 
 			return last_error_code;
@@ -536,6 +820,9 @@ namespace coyote
 					throw ErrorCode::ClientNotAttached;
 				}
 
+				validate_thread_inner();
+				drain_commands_inner();
+
 				Operation* scheduled_op = operation_map.at(scheduled_op_id).get();
 				scheduled_op->wait_resource_signal(resource_id);
 				operations.disable(scheduled_op->id);
@@ -548,17 +835,20 @@ namespace coyote
 
 				std::shared_ptr<std::unordered_set<size_t>> blocked_operation_ids(it->second);
 				blocked_operation_ids->insert(scheduled_op_id);
+				trace(TraceEventType::WaitResource, scheduled_op_id, resource_id);
+				record_resource_access_inner(resource_id);
+				strategy->resource_accessed(scheduled_op_id, resource_id);
 
 				// Waiting for the resource to be released, so schedule the next enabled operation.
 				schedule_next_inner(lock);
 			}
 			catch (ErrorCode error_code)
 			{
-				last_error_code = error_code;
+				assign_error_code(error_code);
 			}
 			catch (...)
 			{
-				last_error_code = ErrorCode::Failure;
+				assign_error_code(ErrorCode::Failure);
 			}
 
 			return last_error_code;
@@ -593,6 +883,9 @@ namespace coyote
 					throw ErrorCode::ClientNotAttached;
 				}
 
+				validate_thread_inner();
+				drain_commands_inner();
+
 				Operation* scheduled_op = operation_map.at(scheduled_op_id).get();
 				scheduled_op->wait_resource_signals(resource_ids, size, wait_all);
 				operations.disable(scheduled_op->id);
@@ -608,6 +901,9 @@ namespace coyote
 
 					std::shared_ptr<std::unordered_set<size_t>> blocked_operation_ids(it->second);
 					blocked_operation_ids->insert(scheduled_op_id);
+					trace(TraceEventType::WaitResource, scheduled_op_id, resource_id);
+					record_resource_access_inner(resource_id);
+					strategy->resource_accessed(scheduled_op_id, resource_id);
 				}
 
 				// Waiting for the resources to be released, so schedule the next enabled operation.
@@ -615,11 +911,11 @@ namespace coyote
 			}
 			catch (ErrorCode error_code)
 			{
-				last_error_code = error_code;
+				assign_error_code(error_code);
 			}
 			catch (...)
 			{
-				last_error_code = ErrorCode::Failure;
+				assign_error_code(ErrorCode::Failure);
 			}
 
 			return last_error_code;
@@ -645,31 +941,17 @@ namespace coyote
 					throw ErrorCode::ClientNotAttached;
 				}
 
-				auto it = resource_map.find(resource_id);
-				if (it == resource_map.end())
-				{
-					throw ErrorCode::NotExistingResource;
-				}
-
-				std::shared_ptr<std::unordered_set<size_t>> blocked_operation_ids(it->second);
-				for (const auto& blocked_id : *blocked_operation_ids)
-				{
-					Operation* blocked_op = operation_map.at(blocked_id).get();
-					if (blocked_op->on_resource_signal(resource_id))
-					{
-						operations.enable(blocked_op->id);
-					}
-				}
-
-				blocked_operation_ids->clear();
+				validate_thread_inner();
+				drain_commands_inner();
+				signal_resource_inner(resource_id);
 			}
 			catch (ErrorCode error_code)
 			{
-				last_error_code = error_code;
+				assign_error_code(error_code);
 			}
 			catch (...)
 			{
-				last_error_code = ErrorCode::Failure;
+				assign_error_code(ErrorCode::Failure);
 			}
 
 			return last_error_code;
@@ -696,32 +978,58 @@ namespace coyote
 					throw ErrorCode::ClientNotAttached;
 				}
 
-				auto it = resource_map.find(resource_id);
-				if (it == resource_map.end())
+				validate_thread_inner();
+				drain_commands_inner();
+				signal_resource_inner(resource_id, operation_id);
+			}
+			catch (ErrorCode error_code)
+			{
+				assign_error_code(error_code);
+			}
+			catch (...)
+			{
+				assign_error_code(ErrorCode::Failure);
+			}
+
+			return last_error_code;
+		}
+
+		// Signals each waiting operation in the specified pairs that its paired resource is available,
+		// taking the scheduler lock only once.
+		ErrorCode signal_resources(const size_t* resource_ids, const size_t* operation_ids, size_t size) noexcept
+		{
+			try
+			{
+				if (configuration->exploration_strategy() == StrategyType::None)
 				{
-					throw ErrorCode::NotExistingResource;
+					throw ErrorCode::SchedulerDisabled;
 				}
 
-				std::shared_ptr<std::unordered_set<size_t>> blocked_operation_ids(it->second);
-				auto op_it = blocked_operation_ids->find(operation_id);
-				if (op_it != blocked_operation_ids->end())
+				std::unique_lock<std::mutex> lock(*mutex);
+	#ifdef COYOTE_DEBUG_LOG
+				std::cout << "[coyote::signal_resources] signaling " << size << " waiting operations" << std::endl;
+	#endif // COYOTE_DEBUG_LOG
+
+				if (!is_attached)
 				{
-					Operation* blocked_op = operation_map.at(operation_id).get();
-					if (blocked_op->on_resource_signal(resource_id))
-					{
-						operations.enable(blocked_op->id);
-					}
+					throw ErrorCode::ClientNotAttached;
+				}
+
+				validate_thread_inner();
+				drain_commands_inner();
 
-					blocked_operation_ids->erase(op_it);
+				for (size_t i = 0; i < size; i++)
+				{
+					signal_resource_inner(*(resource_ids + i), *(operation_ids + i));
 				}
 			}
 			catch (ErrorCode error_code)
 			{
-				last_error_code = error_code;
+				assign_error_code(error_code);
 			}
 			catch (...)
 			{
-				last_error_code = ErrorCode::Failure;
+				assign_error_code(ErrorCode::Failure);
 			}
 
 			return last_error_code;
@@ -747,21 +1055,57 @@ namespace coyote
 					throw ErrorCode::ClientNotAttached;
 				}
 
-				auto it = resource_map.find(resource_id);
-				if (it == resource_map.end())
+				validate_thread_inner();
+				drain_commands_inner();
+				delete_resource_inner(resource_id);
+			}
+			catch (ErrorCode error_code)
+			{
+				assign_error_code(error_code);
+			}
+			catch (...)
+			{
+				assign_error_code(ErrorCode::Failure);
+			}
+
+			return last_error_code;
+		}
+
+		// Deletes the resources with the specified ids, taking the scheduler lock only once.
+		ErrorCode delete_resources(const size_t* resource_ids, size_t size) noexcept
+		{
+			try
+			{
+				if (configuration->exploration_strategy() == StrategyType::None)
 				{
-					throw ErrorCode::NotExistingResource;
+					throw ErrorCode::SchedulerDisabled;
+				}
+
+				std::unique_lock<std::mutex> lock(*mutex);
+	#ifdef COYOTE_DEBUG_LOG
+				std::cout << "[coyote::delete_resources] deleting " << size << " resources" << std::endl;
+	#endif // COYOTE_DEBUG_LOG
+
+				if (!is_attached)
+				{
+					throw ErrorCode::ClientNotAttached;
 				}
 
-				resource_map.erase(resource_id);
+				validate_thread_inner();
+				drain_commands_inner();
+
+				for (size_t i = 0; i < size; i++)
+				{
+					delete_resource_inner(*(resource_ids + i));
+				}
 			}
 			catch (ErrorCode error_code)
 			{
-				last_error_code = error_code;
+				assign_error_code(error_code);
 			}
 			catch (...)
 			{
-				last_error_code = ErrorCode::Failure;
+				assign_error_code(ErrorCode::Failure);
 			}
 
 			return last_error_code;
@@ -785,50 +1129,424 @@ namespace coyote
 					throw ErrorCode::ClientNotAttached;
 				}
 
+				validate_thread_inner();
+				drain_commands_inner();
 				schedule_next_inner(lock);
 			}
 			catch (ErrorCode error_code)
 			{
-				last_error_code = error_code;
+				assign_error_code(error_code);
 			}
 			catch (...)
 			{
-				last_error_code = ErrorCode::Failure;
+				assign_error_code(ErrorCode::Failure);
 			}
 
 			return last_error_code;
 		}
 
-		// Returns a controlled nondeterministic boolean value.
-		bool next_boolean() noexcept
+		// Reports that the current iteration found a failure with the specified nonzero signature, such as
+		// a failed assertion of the test, so that adaptive strategies can reward the choices that led to it.
+		ErrorCode report_failure(uint64_t signature) noexcept
 		{
-	#ifdef COYOTE_DEBUG_LOG
-			std::cout << "[coyote::next_boolean] " << std::endl;
-	#endif // COYOTE_DEBUG_LOG
-			return strategy->next_boolean();
-		}
+			try
+			{
+				if (configuration->exploration_strategy() == StrategyType::None)
+				{
+					throw ErrorCode::SchedulerDisabled;
+				}
 
-		// Returns a controlled nondeterministic integer value chosen from the [0, max_value) range.
-		int next_integer(int max_value) noexcept
-		{
-	#ifdef COYOTE_DEBUG_LOG
-			std::cout << "[coyote::next_integer] " << std::endl;
-	#endif // COYOTE_DEBUG_LOG
-			return strategy->next_integer(max_value);
+				std::unique_lock<std::mutex> lock(*mutex);
+
+				if (!is_attached)
+				{
+					throw ErrorCode::ClientNotAttached;
+				}
+
+				validate_thread_inner();
+				reported_failure_signature = signature;
+				record_failure_inner();
+			}
+			catch (ErrorCode error_code)
+			{
+				assign_error_code(error_code);
+			}
+			catch (...)
+			{
+				assign_error_code(ErrorCode::Failure);
+			}
+
+			return last_error_code;
 		}
 
-		// Returns the id of the currently scheduled operation.
-		size_t scheduled_operation_id() noexcept
+		// Reports a hash of the program state at the current step, which strategies that learn from program
+		// states, such as the Q-learning strategy, include in their abstraction of the state, and which the
+		// DFS strategy uses to prune visited states if state caching is enabled.
+		ErrorCode report_state_hash(uint64_t hash) noexcept
 		{
+			try
+			{
+				if (configuration->exploration_strategy() == StrategyType::None)
+				{
+					throw ErrorCode::SchedulerDisabled;
+				}
+
+				std::unique_lock<std::mutex> lock(*mutex);
+
+				if (!is_attached)
+				{
+					throw ErrorCode::ClientNotAttached;
+				}
+
+				validate_thread_inner();
+				strategy->report_state_hash(hash);
+			}
+			catch (ErrorCode error_code)
+			{
+				assign_error_code(error_code);
+			}
+			catch (...)
+			{
+				assign_error_code(ErrorCode::Failure);
+			}
+
+			return last_error_code;
+		}
+
+		// Enables a ring with the specified capacity through which non-blocking commands can be submitted
+		// without taking the scheduler lock. Submitted commands are applied in order at the next synchronous
+		// call, including the 'start_operation' of an operation that was created through the ring. A failed
+		// command does not fail the call that applies it, but is returned by 'flush_commands' and 'detach'.
+		// Returns the ring, or nullptr if it could not be enabled.
+		CommandRing* enable_command_ring(size_t capacity) noexcept
+		{
+			try
+			{
+				std::unique_lock<std::mutex> lock(*mutex);
+				if (command_ring == nullptr)
+				{
+					command_ring = std::make_unique<CommandRing>(capacity);
+				}
+
+				return command_ring.get();
+			}
+			catch (...)
+			{
+				return nullptr;
+			}
+		}
+
+		// Applies all pending commands of the command ring, and returns the error of the first command that
+		// failed in the current iteration, if any. This should be called when the ring is full.
+		ErrorCode flush_commands() noexcept
+		{
+			try
+			{
+				if (configuration->exploration_strategy() == StrategyType::None)
+				{
+					throw ErrorCode::SchedulerDisabled;
+				}
+
+				std::unique_lock<std::mutex> lock(*mutex);
+
+				if (!is_attached)
+				{
+					throw ErrorCode::ClientNotAttached;
+				}
+
+				validate_thread_inner();
+				drain_commands_inner();
+				if (command_error_code != ErrorCode::Success)
+				{
+					throw command_error_code;
+				}
+			}
+			catch (ErrorCode error_code)
+			{
+				assign_error_code(error_code);
+			}
+			catch (...)
+			{
+				assign_error_code(ErrorCode::Failure);
+			}
+
+			return last_error_code;
+		}
+
+		// Returns a controlled nondeterministic boolean value. The choice is a step of the schedule, so it is
+		// recorded, traced and replayed like the scheduling choices. Returns false if there is an error.
+		bool next_boolean() noexcept
+		{
+			bool value = false;
+			try
+			{
+				if (configuration->exploration_strategy() == StrategyType::None)
+				{
+					throw ErrorCode::SchedulerDisabled;
+				}
+
+				std::unique_lock<std::mutex> lock(*mutex);
+	#ifdef COYOTE_DEBUG_LOG
+				std::cout << "[coyote::next_boolean] " << std::endl;
+	#endif // COYOTE_DEBUG_LOG
+
+				if (!is_attached)
+				{
+					throw ErrorCode::ClientNotAttached;
+				}
+
+				validate_thread_inner();
+				drain_commands_inner();
+
+				value = strategy->next_boolean();
+				schedule.add_boolean(value);
+				trace(TraceEventType::NextBoolean, scheduled_op_id, value ? 1 : 0);
+			}
+			catch (ErrorCode error_code)
+			{
+				assign_error_code(error_code);
+			}
+			catch (...)
+			{
+				assign_error_code(ErrorCode::Failure);
+			}
+
+			return value;
+		}
+
+		// Returns a controlled nondeterministic integer value chosen from the [0, max_value) range. The choice
+		// is a step of the schedule, so it is recorded, traced and replayed like the scheduling choices.
+		// Returns '0' if there is an error.
+		int next_integer(int max_value) noexcept
+		{
+			int value = 0;
+			try
+			{
+				if (configuration->exploration_strategy() == StrategyType::None)
+				{
+					throw ErrorCode::SchedulerDisabled;
+				}
+				else if (max_value <= 0)
+				{
+					throw ErrorCode::Failure;
+				}
+
+				std::unique_lock<std::mutex> lock(*mutex);
+	#ifdef COYOTE_DEBUG_LOG
+				std::cout << "[coyote::next_integer] " << max_value << std::endl;
+	#endif // COYOTE_DEBUG_LOG
+
+				if (!is_attached)
+				{
+					throw ErrorCode::ClientNotAttached;
+				}
+
+				validate_thread_inner();
+				drain_commands_inner();
+
+				value = strategy->next_integer(max_value);
+				schedule.add_integer(value);
+				trace(TraceEventType::NextInteger, scheduled_op_id, (uint64_t)(int64_t)value);
+			}
+			catch (ErrorCode error_code)
+			{
+				assign_error_code(error_code);
+			}
+			catch (...)
+			{
+				assign_error_code(ErrorCode::Failure);
+			}
+
+			return value;
+		}
+
+		// Writes the status of each operation with the specified ids to the statuses buffer, taking the
+		// scheduler lock only once. Operations that do not exist have the 'None' status.
+		ErrorCode operation_statuses(const size_t* operation_ids, size_t size, OperationStatus* statuses) noexcept
+		{
+			try
+			{
+				if (configuration->exploration_strategy() == StrategyType::None)
+				{
+					throw ErrorCode::SchedulerDisabled;
+				}
+
+				std::unique_lock<std::mutex> lock(*mutex);
+	#ifdef COYOTE_DEBUG_LOG
+				std::cout << "[coyote::operation_statuses] querying " << size << " operations" << std::endl;
+	#endif // COYOTE_DEBUG_LOG
+
+				if (!is_attached)
+				{
+					throw ErrorCode::ClientNotAttached;
+				}
+
+				validate_thread_inner();
+				drain_commands_inner();
+
+				for (size_t i = 0; i < size; i++)
+				{
+					auto it = operation_map.find(*(operation_ids + i));
+					*(statuses + i) = it == operation_map.end() ? OperationStatus::None : it->second->status;
+				}
+			}
+			catch (ErrorCode error_code)
+			{
+				assign_error_code(error_code);
+			}
+			catch (...)
+			{
+				assign_error_code(ErrorCode::Failure);
+			}
+
+			return last_error_code;
+		}
+
+		// Returns the id of the currently scheduled operation.
+		size_t scheduled_operation_id() noexcept
+		{
+			std::unique_lock<std::mutex> lock(*mutex);
 			return scheduled_op_id;
 		}
 
-		// Returns a seed that can be used to reproduce the current testing iteration.
+		// Saves the state of the campaign to the specified checkpoint file, such as the iteration count and the
+		// random state and learned estimates of the strategy. This must be called between iterations.
+		ErrorCode save_checkpoint(const std::string& path) noexcept
+		{
+			try
+			{
+				if (configuration->exploration_strategy() == StrategyType::None)
+				{
+					throw ErrorCode::SchedulerDisabled;
+				}
+
+				std::unique_lock<std::mutex> lock(*mutex);
+				if (is_attached)
+				{
+					throw ErrorCode::ClientAttached;
+				}
+
+				if (!save_checkpoint_inner(path))
+				{
+					throw ErrorCode::Failure;
+				}
+			}
+			catch (ErrorCode error_code)
+			{
+				assign_error_code(error_code);
+			}
+			catch (...)
+			{
+				assign_error_code(ErrorCode::Failure);
+			}
+
+			return last_error_code;
+		}
+
+		// Resumes the campaign from the specified checkpoint file, so that the next iteration is the one that
+		// followed the checkpoint. The checkpoint must be taken by a scheduler with the same settings, else the
+		// 'InvalidCheckpoint' error code is returned and the scheduler is left unchanged. This must be called
+		// between iterations.
+		ErrorCode restore_checkpoint(const std::string& path) noexcept
+		{
+			try
+			{
+				if (configuration->exploration_strategy() == StrategyType::None)
+				{
+					throw ErrorCode::SchedulerDisabled;
+				}
+
+				std::unique_lock<std::mutex> lock(*mutex);
+	#ifdef COYOTE_DEBUG_LOG
+				std::cout << "[coyote::restore_checkpoint] restoring the campaign from " << path << std::endl;
+	#endif // COYOTE_DEBUG_LOG
+
+				if (is_attached)
+				{
+					throw ErrorCode::ClientAttached;
+				}
+
+				CampaignCheckpoint checkpoint;
+				if (!checkpoint.load(path) || checkpoint.configuration != checkpoint_configuration())
+				{
+					throw ErrorCode::InvalidCheckpoint;
+				}
+
+				// The state is restored into a new strategy, so that an invalid state leaves the current one as is.
+				std::unique_ptr<Strategy> restored_strategy = create_strategy();
+				StrategyStateReader reader(checkpoint.state.data(), checkpoint.state.size());
+				restored_strategy->restore_state(reader);
+				if (!reader.is_done())
+				{
+					throw ErrorCode::InvalidCheckpoint;
+				}
+
+				strategy = std::move(restored_strategy);
+				iteration_count = (size_t)checkpoint.iteration_count;
+				if (path == configuration->checkpoint_file_path())
+				{
+					is_checkpoint_rejected = false;
+				}
+
+				last_error_code = ErrorCode::Success;
+			}
+			catch (ErrorCode error_code)
+			{
+				assign_error_code(error_code);
+			}
+			catch (...)
+			{
+				assign_error_code(ErrorCode::Failure);
+			}
+
+			return last_error_code;
+		}
+
+		// Returns the choices made so far in the current testing iteration, or in the last one if the
+		// client is detached.
+		const ScheduleTrace& schedule_trace() noexcept
+		{
+			return schedule;
+		}
+
+		// Returns a seed that can be used to reproduce the current testing iteration. Iterations of workers
+		// other than '0' of a parallel campaign are reproduced by 'reproduction_token' instead.
 		uint64_t random_seed() noexcept
 		{
 			return strategy->random_seed();
 		}
 
+		// Returns the installed exploration strategy, such as to query the statistics of a portfolio.
+		Strategy& exploration_strategy() noexcept
+		{
+			return *strategy;
+		}
+
+		// Returns a token that reproduces the current testing iteration when passed to 'Settings::reproduce',
+		// without running the iterations before it. If the strategy cannot reproduce the iteration directly,
+		// such as a Q-learning iteration after the first one, the token has no strategy, and the iteration
+		// must be reproduced from its schedule instead.
+		ReproductionToken reproduction_token() noexcept
+		{
+			return strategy->reproduction_token();
+		}
+
+		// Returns the signature of the failure of the last iteration, whose 'is_failure' is false if the
+		// iteration passed. This must be called after detaching. Failures with the same signature are most
+		// likely the same bug, even if they were found with different seeds.
+		FailureSignature failure_signature() noexcept
+		{
+			std::unique_lock<std::mutex> lock(*mutex);
+			return last_failure;
+		}
+
+		// Returns the number of testing iterations of the campaign so far, including the iterations before the
+		// checkpoint that the campaign was resumed from.
+		size_t iterations() noexcept
+		{
+			return iteration_count;
+		}
+
 		// Returns the last error code, if there is one assigned.
 		ErrorCode error_code() noexcept
 		{
@@ -842,16 +1560,178 @@ namespace coyote
 		Scheduler& operator=(Scheduler&& op) = delete;
 		Scheduler& operator=(Scheduler const&) = delete;
 
+		// Creates the exploration strategy, wrapped in a fair strategy if fair scheduling is enabled. A replayed
+		// schedule already contains its fair tail, so it is not wrapped.
 		std::unique_ptr<Strategy> create_strategy() noexcept
+		{
+			if (configuration->fair_scheduling_steps() > 0 &&
+				configuration->exploration_strategy() != StrategyType::Replay)
+			{
+				return std::make_unique<FairStrategy>(configuration.get(), create_exploration_strategy());
+			}
+
+			return create_exploration_strategy();
+		}
+
+		std::unique_ptr<Strategy> create_exploration_strategy() noexcept
 		{
 			if (configuration->exploration_strategy() == StrategyType::PCT)
 			{
 				return std::make_unique<PCTStrategy>(configuration.get());
 			}
+			else if (configuration->exploration_strategy() == StrategyType::Replay)
+			{
+				return std::make_unique<ReplayStrategy>(configuration.get());
+			}
+			else if (configuration->exploration_strategy() == StrategyType::POS)
+			{
+				return std::make_unique<POSStrategy>(configuration.get());
+			}
+			else if (configuration->exploration_strategy() == StrategyType::DFS)
+			{
+				return std::make_unique<DFSStrategy>(configuration.get());
+			}
+			else if (configuration->exploration_strategy() == StrategyType::QLearning)
+			{
+				return std::make_unique<QLearningStrategy>(configuration.get());
+			}
+			else if (configuration->exploration_strategy() == StrategyType::Portfolio ||
+				configuration->exploration_strategy() == StrategyType::Bandit)
+			{
+				return std::make_unique<PortfolioStrategy>(configuration.get());
+			}
 
 			return std::make_unique<RandomStrategy>(configuration.get());
 		}
 
+		// Writes the state of the campaign to the specified checkpoint file. Returns false if the write failed.
+		bool save_checkpoint_inner(const std::string& path)
+		{
+			StrategyStateWriter writer;
+			strategy->save_state(writer);
+
+			CampaignCheckpoint checkpoint;
+			checkpoint.configuration = checkpoint_configuration();
+			checkpoint.iteration_count = iteration_count;
+			checkpoint.state = writer.data();
+			return checkpoint.save(path);
+		}
+
+		// Returns a hash of the settings that determine the campaign, so that a checkpoint is only restored
+		// into a scheduler that runs the same campaign.
+		uint64_t checkpoint_configuration()
+		{
+			uint64_t values[] = {
+				(uint64_t)configuration->exploration_strategy(),
+				configuration->exploration_strategy_bound(),
+				configuration->random_seed(),
+				configuration->worker(),
+				configuration->first_iteration(),
+				configuration->schedule_length_estimate(),
+				configuration->fair_scheduling_steps(),
+				(uint64_t)configuration->fair_scheduling_mode(),
+				configuration->q_table_capacity(),
+				configuration->visited_state_capacity(),
+				configuration->replay_schedule().view().hash()
+			};
+
+			uint64_t hash = schedule_corpus::fnv1a(values, sizeof(values));
+			for (const PortfolioMember& member : configuration->portfolio_members())
+			{
+				uint64_t member_values[] = { (uint64_t)member.strategy, member.bound, member.weight };
+				hash = schedule_corpus::fnv1a(member_values, sizeof(member_values), hash);
+			}
+
+			return hash;
+		}
+
+		std::unique_ptr<Tracer> create_tracer() noexcept
+		{
+			try
+			{
+				if (!configuration->trace_file_path().empty())
+				{
+					auto result = std::make_unique<Tracer>(configuration->trace_file_path(),
+						configuration->trace_capacity());
+					if (result->is_open())
+					{
+						return result;
+					}
+				}
+			}
+			catch (...)
+			{
+			}
+
+			return nullptr;
+		}
+
+		std::unique_ptr<ScheduleCorpusWriter> create_corpus_writer() noexcept
+		{
+			try
+			{
+				if (!configuration->schedule_corpus_path().empty())
+				{
+					auto result = std::make_unique<ScheduleCorpusWriter>();
+					if (result->open(configuration->schedule_corpus_path()))
+					{
+						return result;
+					}
+	#ifdef COYOTE_DEBUG_LOG
+					std::cout << "[coyote::create_corpus_writer] failed to open the corpus, which must be compacted "
+						"if it has a corrupted record" << std::endl;
+	#endif // COYOTE_DEBUG_LOG
+				}
+			}
+			catch (...)
+			{
+			}
+
+			return nullptr;
+		}
+
+		// The operation that the current thread runs, which is assigned when the thread starts the operation.
+		struct ThreadBinding
+		{
+			const Scheduler* scheduler;
+			size_t iteration;
+			size_t operation_id;
+		};
+
+		static ThreadBinding& thread_binding() noexcept
+		{
+			static thread_local ThreadBinding binding = { nullptr, 0, 0 };
+			return binding;
+		}
+
+		// Throws the 'UncontrolledThread' error code if thread validation is enabled and the current thread
+		// does not run the scheduled operation of the current iteration.
+		void validate_thread_inner() const
+		{
+			if (is_thread_validation_enabled)
+			{
+				const ThreadBinding& binding = thread_binding();
+				if (binding.operation_id != scheduled_op_id || binding.scheduler != this ||
+					binding.iteration != iteration_count)
+				{
+	#ifdef COYOTE_DEBUG_LOG
+					std::cout << "[coyote::validate_thread] call from a thread that does not run operation " <<
+						scheduled_op_id << std::endl;
+	#endif // COYOTE_DEBUG_LOG
+					throw ErrorCode::UncontrolledThread;
+				}
+			}
+		}
+
+		// Records the specified event, if tracing is enabled.
+		void trace(TraceEventType type, size_t operation_id, uint64_t value = 0) noexcept
+		{
+			if (tracer != nullptr)
+			{
+				tracer->record(type, operation_id, value);
+			}
+		}
+
 		void create_operation_inner(size_t operation_id)
 		{
 			auto it = operation_map.find(operation_id);
@@ -864,6 +1744,7 @@ namespace coyote
 					// This is the first operation, so schedule it.
 					scheduled_op_id = operation_id;
 					result.first->second->is_scheduled = true;
+					result.first->second->was_scheduled = true;
 				}
 			}
 			else
@@ -873,6 +1754,7 @@ namespace coyote
 				{
 					existing_op->status = OperationStatus::None;
 					existing_op->is_scheduled = false;
+					existing_op->was_scheduled = false;
 				}
 				else
 				{
@@ -887,10 +1769,226 @@ namespace coyote
 				// This is the first operation, so schedule it.
 				scheduled_op_id = operation_id;
 				result.first->second->is_scheduled = true;
+				result.first->second->was_scheduled = true;
 			}
 
 			// Increment the count of created operations that have not yet started.
 			pending_start_operation_count += 1;
+			if (operation_id != main_op_id)
+			{
+				created_operation_ids.push_back(operation_id);
+			}
+			trace(TraceEventType::CreateOperation, operation_id, scheduled_op_id);
+		}
+
+		void create_resource_inner(size_t resource_id)
+		{
+			auto it = resource_map.find(resource_id);
+			if (it != resource_map.end())
+			{
+				throw ErrorCode::DuplicateResource;
+			}
+
+			resource_map.insert(std::pair<size_t, std::shared_ptr<std::unordered_set<size_t>>>(
+				resource_id, std::make_shared<std::unordered_set<size_t>>()));
+			trace(TraceEventType::CreateResource, scheduled_op_id, resource_id);
+		}
+
+		// Assigns the error code of a failed call. If the call failed during an iteration, the context of the
+		// failure is recorded where it happened, instead of where the iteration ended. The mutex must not be
+		// held, as it is released when the error unwinds the call.
+		void assign_error_code(ErrorCode error_code) noexcept
+		{
+			last_error_code = error_code;
+			if (error_code != ErrorCode::Success)
+			{
+				std::unique_lock<std::mutex> lock(*mutex);
+				if (is_attached)
+				{
+					record_failure_inner();
+				}
+			}
+		}
+
+		// Records that the scheduled operation accessed the specified resource, which becomes the resource of
+		// a failure of the operation.
+		void record_resource_access_inner(size_t resource_id)
+		{
+			auto it = operation_map.find(scheduled_op_id);
+			if (it != operation_map.end())
+			{
+				it->second->has_accessed_resource = true;
+				it->second->last_resource_id = resource_id;
+			}
+		}
+
+		// Records the scheduled operation, the resource that it last accessed and a hash of the last schedule
+		// steps as the context of the failure of the current iteration, unless an earlier failure of the
+		// iteration was already recorded.
+		void record_failure_inner()
+		{
+			if (is_failure_recorded)
+			{
+				return;
+			}
+
+			is_failure_recorded = true;
+			last_failure.operation_id = scheduled_op_id;
+			auto it = operation_map.find(scheduled_op_id);
+			if (it != operation_map.end() && it->second->has_accessed_resource)
+			{
+				last_failure.resource_id = it->second->last_resource_id;
+			}
+
+			size_t tail_size = std::min(configuration->failure_signature_steps(), schedule.size());
+			last_failure.tail_hash = ScheduleView(schedule.data() + schedule.size() - tail_size, tail_size).hash();
+		}
+
+		void signal_resource_inner(size_t resource_id)
+		{
+			auto it = resource_map.find(resource_id);
+			if (it == resource_map.end())
+			{
+				throw ErrorCode::NotExistingResource;
+			}
+
+			trace(TraceEventType::SignalResource, scheduled_op_id, resource_id);
+			record_resource_access_inner(resource_id);
+			strategy->resource_accessed(scheduled_op_id, resource_id);
+			std::shared_ptr<std::unordered_set<size_t>> blocked_operation_ids(it->second);
+			for (const auto& blocked_id : *blocked_operation_ids)
+			{
+				Operation* blocked_op = operation_map.at(blocked_id).get();
+				if (blocked_op->on_resource_signal(resource_id))
+				{
+					operations.enable(blocked_op->id);
+					trace(TraceEventType::EnableOperation, blocked_op->id, scheduled_op_id);
+				}
+			}
+
+			blocked_operation_ids->clear();
+		}
+
+		void signal_resource_inner(size_t resource_id, size_t operation_id)
+		{
+			auto it = resource_map.find(resource_id);
+			if (it == resource_map.end())
+			{
+				throw ErrorCode::NotExistingResource;
+			}
+
+			trace(TraceEventType::SignalResource, scheduled_op_id, resource_id);
+			record_resource_access_inner(resource_id);
+			strategy->resource_accessed(scheduled_op_id, resource_id);
+			std::shared_ptr<std::unordered_set<size_t>> blocked_operation_ids(it->second);
+			auto op_it = blocked_operation_ids->find(operation_id);
+			if (op_it != blocked_operation_ids->end())
+			{
+				Operation* blocked_op = operation_map.at(operation_id).get();
+				if (blocked_op->on_resource_signal(resource_id))
+				{
+					operations.enable(blocked_op->id);
+					trace(TraceEventType::EnableOperation, blocked_op->id, scheduled_op_id);
+				}
+
+				blocked_operation_ids->erase(op_it);
+			}
+		}
+
+		void delete_resource_inner(size_t resource_id)
+		{
+			auto it = resource_map.find(resource_id);
+			if (it == resource_map.end())
+			{
+				throw ErrorCode::NotExistingResource;
+			}
+
+			resource_map.erase(it);
+			trace(TraceEventType::DeleteResource, scheduled_op_id, resource_id);
+		}
+
+		// Applies all pending commands of the command ring, if there is one, in the order they were submitted.
+		// A failed command does not stop the others or the calling operation; the first failure is recorded
+		// and reported by 'flush_commands' and 'detach'.
+		void drain_commands_inner() noexcept
+		{
+			if (command_ring == nullptr)
+			{
+				return;
+			}
+
+			Command command;
+			while (command_ring->try_dequeue(command))
+			{
+	#ifdef COYOTE_DEBUG_LOG
+				std::cout << "[coyote::drain_commands] applying command " << static_cast<uint32_t>(command.type) <<
+					" (" << command.arg0 << ", " << command.arg1 << ")" << std::endl;
+	#endif // COYOTE_DEBUG_LOG
+				try
+				{
+					apply_command_inner(command);
+				}
+				catch (ErrorCode error_code)
+				{
+					record_command_error_inner(error_code);
+				}
+				catch (...)
+				{
+					record_command_error_inner(ErrorCode::Failure);
+				}
+			}
+		}
+
+		void apply_command_inner(const Command& command)
+		{
+			switch (command.type)
+			{
+			case CommandType::CreateOperation:
+				if ((size_t)command.arg0 == main_op_id)
+				{
+					throw ErrorCode::MainOperationExplicitlyCreated;
+				}
+
+				create_operation_inner((size_t)command.arg0);
+				break;
+			case CommandType::CreateResource:
+				create_resource_inner((size_t)command.arg0);
+				break;
+			case CommandType::SignalResource:
+				signal_resource_inner((size_t)command.arg0);
+				break;
+			case CommandType::SignalOperationResource:
+				signal_resource_inner((size_t)command.arg0, (size_t)command.arg1);
+				break;
+			case CommandType::DeleteResource:
+				delete_resource_inner((size_t)command.arg0);
+				break;
+			default:
+				throw ErrorCode::Failure;
+			}
+		}
+
+		void record_command_error_inner(ErrorCode error_code) noexcept
+		{
+	#ifdef COYOTE_DEBUG_LOG
+			std::cout << "[coyote::drain_commands] command failed with error " << static_cast<int>(error_code) << std::endl;
+	#endif // COYOTE_DEBUG_LOG
+			if (command_error_code == ErrorCode::Success)
+			{
+				command_error_code = error_code;
+			}
+		}
+
+		// Drops all pending commands of the command ring, if there is one.
+		void discard_commands_inner()
+		{
+			if (command_ring != nullptr)
+			{
+				Command command;
+				while (command_ring->try_dequeue(command))
+				{
+				}
+			}
 		}
 
 		void start_operation_inner(size_t operation_id, std::unique_lock<std::mutex>& lock)
@@ -916,6 +2014,11 @@ namespace coyote
 				throw ErrorCode::OperationAlreadyStarted;
 			}
 
+			if (is_thread_validation_enabled)
+			{
+				thread_binding() = { this, iteration_count, operation_id };
+			}
+
 			// Decrement the count of pending operations.
 			pending_start_operation_count -= 1;
 	#ifdef COYOTE_DEBUG_LOG
@@ -930,7 +2033,12 @@ namespace coyote
 			if (op->status != OperationStatus::Completed)
 			{
 				op->status = OperationStatus::Enabled;
-				operations.insert(op->id);
+				if (op->id == main_op_id)
+				{
+					operations.insert(op->id);
+				}
+
+				trace(TraceEventType::StartOperation, op->id);
 				op->cv.notify_all();
 				while (!op->is_scheduled)
 				{
@@ -949,6 +2057,42 @@ namespace coyote
 			}
 		}
 
+		// Returns the enabled operations without the interchangeable operations of each symmetry class, except
+		// for the one with the lowest id, as scheduling any of them leads to an equivalent execution.
+		Operations& canonical_operations_inner()
+		{
+			if (interchangeable_op_count == 0)
+			{
+				return operations;
+			}
+
+			symmetry_representatives.clear();
+			for (size_t idx = 0; idx < operations.size(); idx++)
+			{
+				const Operation* op = operation_map.at(operations[idx]).get();
+				if (op->is_interchangeable)
+				{
+					auto result = symmetry_representatives.emplace(op->symmetry_class, op->id);
+					if (!result.second && op->id < result.first->second)
+					{
+						result.first->second = op->id;
+					}
+				}
+			}
+
+			canonical_operations.clear();
+			for (size_t idx = 0; idx < operations.size(); idx++)
+			{
+				const Operation* op = operation_map.at(operations[idx]).get();
+				if (!op->is_interchangeable || symmetry_representatives[op->symmetry_class] == op->id)
+				{
+					canonical_operations.insert(op->id);
+				}
+			}
+
+			return canonical_operations;
+		}
+
 		void schedule_next_inner(std::unique_lock<std::mutex>& lock)
 		{
 	#ifdef COYOTE_DEBUG_LOG
@@ -956,15 +2100,33 @@ namespace coyote
 	#endif // COYOTE_DEBUG_LOG
 
 			// Wait for any recently created operations to start.
-			while (pending_start_operation_count > 0)
+			if (pending_start_operation_count > 0)
 			{
+				trace(TraceEventType::WaitPendingOperations, scheduled_op_id, pending_start_operation_count);
+				while (pending_start_operation_count > 0)
+				{
 	#ifdef COYOTE_DEBUG_LOG
-				std::cout << "[coyote::schedule_next] waiting " << pending_start_operation_count <<
-					" pending operations" << std::endl;
+					std::cout << "[coyote::schedule_next] waiting " << pending_start_operation_count <<
+						" pending operations" << std::endl;
 	#endif // COYOTE_DEBUG_LOG
-				pending_operations_cv.wait(lock);
+					pending_operations_cv.wait(lock);
+				}
+
+				trace(TraceEventType::ResumePendingOperations, scheduled_op_id);
+			}
+
+			// Enable the operations that started since the last scheduling point in the order they were created.
+			for (size_t id : created_operation_ids)
+			{
+				auto it = operation_map.find(id);
+				if (it != operation_map.end() && it->second->status == OperationStatus::Enabled)
+				{
+					operations.insert(id);
+				}
 			}
 
+			created_operation_ids.clear();
+
 			// Check if the schedule has finished or if there is a deadlock.
 			if (operations.size() == 0)
 			{
@@ -973,6 +2135,8 @@ namespace coyote
 	#ifdef COYOTE_DEBUG_LOG
 					std::cout << "[coyote::schedule_next] deadlock detected" << std::endl;
 	#endif // COYOTE_DEBUG_LOG
+					trace(TraceEventType::DeadlockDetected, scheduled_op_id);
+					record_failure_inner();
 					throw ErrorCode::DeadlockDetected;
 				}
 
@@ -983,11 +2147,18 @@ namespace coyote
 			}
 
 			// Ask the strategy for the next operation to schedule.
-			size_t next_id = strategy->next_operation(operations, scheduled_op_id);
+			size_t next_id = strategy->next_operation(canonical_operations_inner(), scheduled_op_id);
 			Operation* next_op = operation_map.at(next_id).get();
+			if (next_op->is_interchangeable)
+			{
+				next_op->is_interchangeable = false;
+				interchangeable_op_count--;
+			}
 
 			const size_t previous_id = scheduled_op_id;
 			scheduled_op_id = next_id;
+			schedule.add_operation(next_id);
+			trace(TraceEventType::ScheduleNext, previous_id, next_id);
 
 	#ifdef COYOTE_DEBUG_LOG
 			std::cout << "[coyote::schedule_next] next operation " << next_id << std::endl;
@@ -997,6 +2168,7 @@ namespace coyote
 			{
 				// Resume the next operation.
 				next_op->is_scheduled = true;
+				next_op->was_scheduled = true;
 				next_op->cv.notify_all();
 
 				// Pause the previous operation.
@@ -0,0 +1,136 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_CAMPAIGN_CHECKPOINT_H
+#define COYOTE_CAMPAIGN_CHECKPOINT_H
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <vector>
+#include "schedule_corpus.h"
+
+namespace coyote
+{
+	// Header at the start of a checkpoint file, which is followed by the state of the strategy.
+	struct CampaignCheckpointHeader
+	{
+		// Identifies the file as a checkpoint.
+		char magic[8];
+
+		// The version of the checkpoint format.
+		uint32_t version;
+
+		// Padding, must be zero.
+		uint32_t reserved;
+
+		// Hash of the settings of the campaign, which the resuming scheduler must have as well.
+		uint64_t configuration;
+
+		// Number of iterations that completed before the checkpoint.
+		uint64_t iteration_count;
+
+		// The size of the state of the strategy in bytes.
+		uint64_t state_size;
+
+		// Checksum of the state of the strategy.
+		uint64_t checksum;
+	};
+
+	static_assert(sizeof(CampaignCheckpointHeader) == 48, "unexpected checkpoint header size");
+
+	constexpr char CAMPAIGN_CHECKPOINT_MAGIC[8] = { 'C', 'O', 'Y', 'C', 'K', 'P', 'T', '\0' };
+	constexpr uint32_t CAMPAIGN_CHECKPOINT_VERSION = 1;
+
+	// The state of a testing campaign between two iterations, from which the scheduler resumes the campaign
+	// exactly, such as after the process was pre-empted.
+	struct CampaignCheckpoint
+	{
+		// Hash of the settings of the campaign.
+		uint64_t configuration = 0;
+
+		// Number of iterations that completed before the checkpoint.
+		uint64_t iteration_count = 0;
+
+		// The state of the strategy, as written by 'Strategy::save_state'.
+		std::vector<uint8_t> state;
+
+		// Writes the checkpoint to the specified file. The checkpoint is written to a temporary file that then
+		// replaces the file, so a process that is killed while saving leaves the previous checkpoint intact.
+		// Returns false if the write failed.
+		bool save(const std::string& path) const
+		{
+			std::string temporary_path = path + ".tmp";
+			{
+				std::ofstream file(temporary_path, std::ios::binary | std::ios::trunc);
+				if (!file.is_open())
+				{
+					return false;
+				}
+
+				CampaignCheckpointHeader header;
+				std::memcpy(header.magic, CAMPAIGN_CHECKPOINT_MAGIC, sizeof(header.magic));
+				header.version = CAMPAIGN_CHECKPOINT_VERSION;
+				header.reserved = 0;
+				header.configuration = configuration;
+				header.iteration_count = iteration_count;
+				header.state_size = state.size();
+				header.checksum = schedule_corpus::fnv1a(state.data(), state.size());
+				file.write((const char*)&header, sizeof(header));
+				file.write((const char*)state.data(), state.size());
+				file.flush();
+				if (!file.good())
+				{
+					return false;
+				}
+			}
+
+			std::error_code error;
+			std::filesystem::rename(temporary_path, path, error);
+			return !error;
+		}
+
+		// Reads the checkpoint from the specified file. Returns false if the file could not be read, or if it
+		// is not a complete checkpoint with a valid checksum.
+		bool load(const std::string& path)
+		{
+			std::ifstream file(path, std::ios::binary);
+			if (!file.is_open())
+			{
+				return false;
+			}
+
+			CampaignCheckpointHeader header;
+			if (!file.read((char*)&header, sizeof(header)) ||
+				std::memcmp(header.magic, CAMPAIGN_CHECKPOINT_MAGIC, sizeof(header.magic)) != 0 ||
+				header.version != CAMPAIGN_CHECKPOINT_VERSION || header.reserved != 0)
+			{
+				return false;
+			}
+
+			std::error_code error;
+			uintmax_t file_size = std::filesystem::file_size(path, error);
+			if (error || file_size != sizeof(header) + header.state_size)
+			{
+				return false;
+			}
+
+			std::vector<uint8_t> bytes((size_t)header.state_size);
+			if (!file.read((char*)bytes.data(), bytes.size()) ||
+				schedule_corpus::fnv1a(bytes.data(), bytes.size()) != header.checksum)
+			{
+				return false;
+			}
+
+			configuration = header.configuration;
+			iteration_count = header.iteration_count;
+			state = std::move(bytes);
+			return true;
+		}
+	};
+}
+
+#endif // COYOTE_CAMPAIGN_CHECKPOINT_H
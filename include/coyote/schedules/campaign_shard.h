@@ -0,0 +1,223 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_CAMPAIGN_SHARD_H
+#define COYOTE_CAMPAIGN_SHARD_H
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <unordered_set>
+#include <vector>
+#include "../scheduler.h"
+
+namespace coyote
+{
+	// A deterministic part of a campaign that is split across machines. All shards share the strategy, seed
+	// and bound of the campaign, and each shard runs the first iterations of its own worker, whose random
+	// streams never overlap with those of the other workers. A shard therefore explores the same schedules
+	// on any machine, and can be run again if its machine is lost.
+	struct CampaignShard
+	{
+		// The index of the shard in the campaign.
+		uint64_t index;
+
+		StrategyType strategy;
+		uint64_t seed;
+
+		// The worker of the campaign that the shard runs.
+		uint64_t worker;
+
+		uint64_t bound;
+
+		// Number of iterations of the shard.
+		uint64_t iterations;
+
+		// Installs the strategy of the shard.
+		void configure(Settings& settings) const
+		{
+			settings.reproduce({ strategy, seed, worker, 1, 0, bound });
+		}
+	};
+
+	// A failure that a shard found, together with the token that reproduces it on any machine.
+	struct ShardFailure
+	{
+		// The nonzero signature of the failure.
+		uint64_t signature;
+
+		ReproductionToken token;
+	};
+
+	// The outcome of a shard.
+	struct ShardResult
+	{
+		// Number of iterations that were run.
+		uint64_t iterations = 0;
+
+		// Number of iterations that failed.
+		uint64_t failures = 0;
+
+		// The first failure of each signature that the shard found.
+		std::vector<ShardFailure> bugs;
+
+		// The hashes of the distinct schedules that the shard explored, in increasing order.
+		std::vector<uint64_t> coverage;
+
+		// Appends the result to the specified words, so that it can be sent to a coordinator.
+		void to_words(std::vector<uint64_t>& words) const
+		{
+			words.push_back(iterations);
+			words.push_back(failures);
+			words.push_back(bugs.size());
+			for (const ShardFailure& bug : bugs)
+			{
+				words.insert(words.end(), { bug.signature, (uint64_t)bug.token.strategy, bug.token.seed,
+					bug.token.worker, bug.token.iteration, bug.token.schedule_length, bug.token.bound });
+			}
+
+			words.push_back(coverage.size());
+			words.insert(words.end(), coverage.begin(), coverage.end());
+		}
+
+		// Parses a result from the words written by 'to_words'. Returns false if they are not a result.
+		static bool from_words(const uint64_t* words, size_t size, ShardResult& result)
+		{
+			size_t position = 3;
+			if (size < position || words[2] > (size - position) / 7)
+			{
+				return false;
+			}
+
+			result.iterations = words[0];
+			result.failures = words[1];
+			result.bugs.resize((size_t)words[2]);
+			for (ShardFailure& bug : result.bugs)
+			{
+				const uint64_t* fields = words + position;
+				if (fields[1] > (uint64_t)StrategyType::DFS)
+				{
+					return false;
+				}
+
+				bug = { fields[0], { (StrategyType)fields[1], fields[2], fields[3], fields[4], fields[5], fields[6] } };
+				position += 7;
+			}
+
+			if (position == size || words[position] != size - position - 1)
+			{
+				return false;
+			}
+
+			result.coverage.assign(words + position + 1, words + size);
+			return true;
+		}
+	};
+
+	// The merged results of the completed shards of a campaign.
+	struct CampaignSummary
+	{
+		// Number of shards that completed.
+		size_t completed_shards = 0;
+
+		// Number of iterations of the completed shards.
+		uint64_t iterations = 0;
+
+		// Number of iterations that failed.
+		uint64_t failures = 0;
+
+		// The failure of each signature with the lowest worker and iteration, so that the bugs do not depend
+		// on the order in which the shards completed.
+		std::map<uint64_t, ShardFailure> bugs;
+
+		// The hashes of the distinct schedules that the campaign explored.
+		std::unordered_set<uint64_t> coverage;
+
+		// Merges the result of a completed shard.
+		void merge(const ShardResult& result)
+		{
+			completed_shards++;
+			iterations += result.iterations;
+			failures += result.failures;
+			for (const ShardFailure& bug : result.bugs)
+			{
+				auto it = bugs.find(bug.signature);
+				if (it == bugs.end())
+				{
+					bugs.emplace(bug.signature, bug);
+				}
+				else if (std::make_pair(bug.token.worker, bug.token.iteration) <
+					std::make_pair(it->second.token.worker, it->second.token.iteration))
+				{
+					it->second = bug;
+				}
+			}
+
+			coverage.insert(result.coverage.begin(), result.coverage.end());
+		}
+	};
+
+	// Runs the shards of a campaign. As for the schedule minimizer, the test must attach to and detach from
+	// the scheduler that it is given, and return a nonzero failure signature if the iteration failed.
+	class ShardRunner
+	{
+	private:
+		// Runs an iteration of the test.
+		std::function<uint64_t(Scheduler&)> test;
+
+	public:
+		ShardRunner(std::function<uint64_t(Scheduler&)> test) :
+			test(std::move(test))
+		{
+		}
+
+		ShardRunner(ShardRunner&& runner) = delete;
+		ShardRunner(ShardRunner const&) = delete;
+
+		ShardRunner& operator=(ShardRunner&& runner) = delete;
+		ShardRunner& operator=(ShardRunner const&) = delete;
+
+		// Runs the iterations of the specified shard on a new scheduler, and returns the outcome.
+		ShardResult run(const CampaignShard& shard)
+		{
+			auto settings = std::make_unique<Settings>();
+			shard.configure(*settings);
+			Scheduler scheduler(std::move(settings));
+
+			ShardResult result;
+			std::unordered_set<uint64_t> schedule_hashes;
+			std::unordered_set<uint64_t> signatures;
+			for (uint64_t i = 0; i < shard.iterations; i++)
+			{
+				uint64_t failure;
+				try
+				{
+					failure = test(scheduler);
+				}
+				catch (...)
+				{
+					failure = (uint64_t)ErrorCode::Failure;
+				}
+
+				result.iterations++;
+				schedule_hashes.insert(scheduler.schedule_trace().view().hash());
+				if (failure != 0)
+				{
+					result.failures++;
+					if (signatures.insert(failure).second)
+					{
+						result.bugs.push_back({ failure, scheduler.reproduction_token() });
+					}
+				}
+			}
+
+			result.coverage.assign(schedule_hashes.begin(), schedule_hashes.end());
+			std::sort(result.coverage.begin(), result.coverage.end());
+			return result;
+		}
+	};
+}
+
+#endif // COYOTE_CAMPAIGN_SHARD_H
@@ -0,0 +1,243 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_DETERMINISM_CHECKER_H
+#define COYOTE_DETERMINISM_CHECKER_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "schedule_diff.h"
+#include "schedule_trace.h"
+#include "../scheduler.h"
+#include "../tracing/trace_reader.h"
+
+namespace coyote
+{
+	// The result of checking if a test is deterministic under the scheduler.
+	struct DeterminismReport
+	{
+		// True if both runs made the same decisions and produced the same events, else false.
+		bool is_deterministic = true;
+
+		// The seed that both runs used.
+		uint64_t seed = 0;
+
+		// The failure signatures of the first and second run. A replay check only sets the second one.
+		uint64_t failures[2] = { 0, 0 };
+
+		// The index of the first step where the schedules diverged, or the length of the shorter schedule
+		// if only the events or the lengths differ.
+		size_t divergent_step = 0;
+
+		// The decision of the first run at the divergent step.
+		ScheduleDecision decision = { 0, 0, 0 };
+
+		// True if the events of both runs were traced completely and compared, else false, in which case
+		// only the decisions were compared. This is false if the tracer dropped events of a run, or if the
+		// trace of a run could not be read.
+		bool are_events_complete = true;
+
+		// True if the event streams diverged, in which case the fields below describe the first divergence.
+		bool has_divergent_event = false;
+
+		// The index of the first divergent event in the normalized event stream of the iteration.
+		size_t divergent_event = 0;
+
+		// Number of scheduling points that both runs passed before the divergent event.
+		size_t scheduling_point = 0;
+
+		// The divergent events of the first and second run, which have the 'None' type if a run has no
+		// event at this index.
+		TraceRecord events[2] = {};
+	};
+
+	// Checks that a test does not have uncontrolled concurrency or randomness, which would prevent the
+	// scheduler from reproducing its schedules. The test is run twice on new schedulers with the same
+	// settings, and the decisions and events of the two runs are compared step by step.
+	class DeterminismChecker
+	{
+	private:
+		// The test, which must attach to and detach from the scheduler that it is given, and return a
+		// nonzero failure signature if it failed.
+		std::function<uint64_t(Scheduler&)> test;
+
+		// Directory of the temporary trace files.
+		std::filesystem::path trace_directory;
+
+	public:
+		DeterminismChecker(std::function<uint64_t(Scheduler&)> test) :
+			test(std::move(test)),
+			trace_directory(std::filesystem::temp_directory_path())
+		{
+		}
+
+		DeterminismChecker(DeterminismChecker&& checker) = delete;
+		DeterminismChecker(DeterminismChecker const&) = delete;
+
+		DeterminismChecker& operator=(DeterminismChecker&& checker) = delete;
+		DeterminismChecker& operator=(DeterminismChecker const&) = delete;
+
+		// Runs the test twice with settings that are configured by the specified function, such as by
+		// installing a strategy with a sampled seed, and compares the runs.
+		DeterminismReport check(const std::function<void(Settings&)>& configure)
+		{
+			DeterminismReport report;
+			ScheduleTrace schedules[2];
+			std::vector<TraceRecord> events[2];
+			for (size_t i = 0; i < 2; i++)
+			{
+				auto settings = std::make_unique<Settings>();
+				configure(*settings);
+				bool is_trace_complete = false;
+				report.failures[i] = run(std::move(settings), schedules[i], events[i], report.seed, is_trace_complete);
+				report.are_events_complete = report.are_events_complete && is_trace_complete;
+			}
+
+			compare(schedules[0], schedules[1], report);
+			if (report.are_events_complete)
+			{
+				// A gap in either event stream would be reported as a divergence at the event after it.
+				compare(events[0], events[1], report);
+			}
+
+			return report;
+		}
+
+		// Replays the specified recorded schedule with the specified seed, and compares the executed
+		// schedule to the recording. Only the decisions are compared, because the recording has no events.
+		DeterminismReport check_replay(const ScheduleTrace& schedule, uint64_t seed)
+		{
+			DeterminismReport report;
+			ScheduleTrace executed_schedule;
+			std::vector<TraceRecord> events;
+			auto settings = std::make_unique<Settings>();
+			settings->use_replay_strategy(schedule, seed);
+			bool is_trace_complete = false;
+			report.failures[1] = run(std::move(settings), executed_schedule, events, report.seed, is_trace_complete);
+			report.are_events_complete = false;
+			compare(schedule, executed_schedule, report);
+			return report;
+		}
+
+	private:
+		// Runs the test on a new scheduler that traces its events to a temporary file, and returns its
+		// failure signature along with its schedule and events, and whether the trace has all its events.
+		uint64_t run(std::unique_ptr<Settings> settings, ScheduleTrace& schedule, std::vector<TraceRecord>& events,
+			uint64_t& seed, bool& is_trace_complete)
+		{
+			static std::atomic<uint64_t> trace_count(0);
+			std::string path = (trace_directory / ("coyote_determinism_" +
+				std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()) + "_" +
+				std::to_string(trace_count++) + ".bin")).string();
+			settings->enable_tracing(path);
+
+			uint64_t failure = 0;
+			{
+				Scheduler scheduler(std::move(settings));
+				failure = test(scheduler);
+				schedule = scheduler.schedule_trace();
+				seed = scheduler.random_seed();
+			}
+
+			// Deleting the scheduler flushed the trace.
+			TraceReader reader;
+			is_trace_complete = reader.open(path);
+			if (is_trace_complete)
+			{
+				TraceRecord record;
+				while (reader.next(record))
+				{
+					is_trace_complete = is_trace_complete && record.type != TraceEventType::DroppedEvents;
+					events.push_back(record);
+				}
+			}
+
+			std::remove(path.c_str());
+			return failure;
+		}
+
+		static void compare(const ScheduleTrace& expected, const ScheduleTrace& actual, DeterminismReport& report)
+		{
+			report.divergent_step = ScheduleDiff::first_divergence(expected.view(), actual.view());
+			if (report.divergent_step < expected.size() || report.divergent_step < actual.size())
+			{
+				report.is_deterministic = false;
+				const ScheduleTrace& schedule = report.divergent_step < expected.size() ? expected : actual;
+				report.decision = ScheduleDiff::decision(schedule.view(), report.divergent_step);
+			}
+		}
+
+		// Compares the events, ignoring their timestamps and iterations.
+		static void compare(const std::vector<TraceRecord>& expected, const std::vector<TraceRecord>& actual,
+			DeterminismReport& report)
+		{
+			std::vector<TraceRecord> expected_events = normalize(expected);
+			std::vector<TraceRecord> actual_events = normalize(actual);
+			size_t scheduling_point = 0;
+			for (size_t i = 0; i < expected_events.size() || i < actual_events.size(); i++)
+			{
+				TraceRecord left = i < expected_events.size() ? expected_events[i] : TraceRecord{};
+				TraceRecord right = i < actual_events.size() ? actual_events[i] : TraceRecord{};
+				if (left.type != right.type || left.operation_id != right.operation_id || left.value != right.value)
+				{
+					report.is_deterministic = false;
+					report.has_divergent_event = true;
+					report.divergent_event = i;
+					report.scheduling_point = scheduling_point;
+					report.events[0] = left;
+					report.events[1] = right;
+					return;
+				}
+				else if (left.type == TraceEventType::ScheduleNext)
+				{
+					scheduling_point++;
+				}
+			}
+		}
+
+		// Returns the events in an order that does not depend on thread timing. Between two scheduling
+		// points, a newly created operation starts concurrently with the operation that created it, so the
+		// events of each such window are grouped by operation, keeping the order of the events of each
+		// operation. Waiting for pending operations to start also depends on timing, so it is dropped, and
+		// so are the records of dropped events, as traces with dropped events are not compared.
+		static std::vector<TraceRecord> normalize(const std::vector<TraceRecord>& events)
+		{
+			std::vector<TraceRecord> result;
+			size_t window_start = 0;
+			for (const TraceRecord& record : events)
+			{
+				if (record.type == TraceEventType::WaitPendingOperations ||
+					record.type == TraceEventType::ResumePendingOperations ||
+					record.type == TraceEventType::DroppedEvents)
+				{
+					continue;
+				}
+				else if (record.type == TraceEventType::ScheduleNext)
+				{
+					std::stable_sort(result.begin() + window_start, result.end(),
+						[](const TraceRecord& left, const TraceRecord& right) { return left.operation_id < right.operation_id; });
+					result.push_back(record);
+					window_start = result.size();
+				}
+				else
+				{
+					result.push_back(record);
+				}
+			}
+
+			std::stable_sort(result.begin() + window_start, result.end(),
+				[](const TraceRecord& left, const TraceRecord& right) { return left.operation_id < right.operation_id; });
+			return result;
+		}
+	};
+}
+
+#endif // COYOTE_DETERMINISM_CHECKER_H
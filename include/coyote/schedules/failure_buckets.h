@@ -0,0 +1,157 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_FAILURE_BUCKETS_H
+#define COYOTE_FAILURE_BUCKETS_H
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <system_error>
+#include "failure_signature.h"
+#include "schedule_corpus.h"
+#include "schedule_trace.h"
+#include "../scheduler.h"
+
+namespace coyote
+{
+	// The failures of a campaign that share a signature, which are most likely the same bug.
+	struct FailureBucket
+	{
+		FailureSignature signature;
+
+		// Number of failures with the signature.
+		uint64_t count;
+
+		// The shortest schedule that failed with the signature, which is the cheapest one to replay and debug.
+		ScheduleTrace schedule;
+
+		// The token that reproduces the iteration of the shortest schedule.
+		ReproductionToken token;
+	};
+
+	// Buckets the failures of a campaign by their signature, keeping only the shortest schedule of each bucket,
+	// so that the memory and the report of a campaign grow with the number of distinct bugs instead of the
+	// number of failed iterations.
+	class FailureBuckets
+	{
+	private:
+		// Map from the hashes of the signatures to their buckets.
+		std::map<uint64_t, FailureBucket> buckets;
+
+		// Number of failures that were added.
+		uint64_t failure_count;
+
+	public:
+		FailureBuckets() noexcept :
+			failure_count(0)
+		{
+		}
+
+		FailureBuckets(FailureBuckets&& buckets) = delete;
+		FailureBuckets(FailureBuckets const&) = delete;
+
+		FailureBuckets& operator=(FailureBuckets&& buckets) = delete;
+		FailureBuckets& operator=(FailureBuckets const&) = delete;
+
+		// Adds a failure with the specified signature, schedule and token. Returns true if it is the first
+		// failure of its signature, or if its schedule is shorter than the kept one, else false.
+		bool add(const FailureSignature& signature, ScheduleView schedule, const ReproductionToken& token)
+		{
+			failure_count++;
+			auto it = buckets.find(signature.hash());
+			if (it == buckets.end())
+			{
+				buckets.emplace(signature.hash(), FailureBucket{ signature, 1, ScheduleTrace(schedule), token });
+				return true;
+			}
+
+			FailureBucket& bucket = it->second;
+			bucket.count++;
+			if (schedule.size() >= bucket.schedule.size())
+			{
+				return false;
+			}
+
+			bucket.schedule = ScheduleTrace(schedule);
+			bucket.token = token;
+			return true;
+		}
+
+		// Adds the failure of the last iteration of the specified scheduler, if it failed. This must be called
+		// after detaching. Returns true if the failure is new or shorter than the kept one of its bucket.
+		bool add(Scheduler& scheduler)
+		{
+			FailureSignature signature = scheduler.failure_signature();
+			if (!signature.is_failure())
+			{
+				return false;
+			}
+
+			return add(signature, scheduler.schedule_trace().view(), scheduler.reproduction_token());
+		}
+
+		// Returns the bucket of the specified signature, or null if no failure had the signature.
+		const FailureBucket* find(const FailureSignature& signature) const noexcept
+		{
+			auto it = buckets.find(signature.hash());
+			return it != buckets.end() ? &it->second : nullptr;
+		}
+
+		// Returns the buckets, ordered by the hashes of their signatures.
+		const std::map<uint64_t, FailureBucket>& all() const noexcept
+		{
+			return buckets;
+		}
+
+		// Returns the number of buckets.
+		size_t size() const noexcept
+		{
+			return buckets.size();
+		}
+
+		// Returns the number of failures that were added.
+		uint64_t failures() const noexcept
+		{
+			return failure_count;
+		}
+
+		// Writes the shortest schedule of each bucket to the specified schedule corpus, replacing the file, with
+		// the seed of its token and the hash of its signature as tag. The corpus is written to a temporary file
+		// that then replaces the file, so a failed write leaves the previous report intact. Returns false if
+		// the write failed.
+		bool save(const std::string& path) const
+		{
+			std::string temporary_path = path + ".tmp";
+			{
+				std::error_code error;
+				std::filesystem::remove(temporary_path, error);
+				ScheduleCorpusWriter writer;
+				if (error || !writer.open(temporary_path))
+				{
+					return false;
+				}
+
+				for (const auto& kvp : buckets)
+				{
+					if (!writer.append(kvp.second.schedule.view(), kvp.second.token.seed, kvp.first))
+					{
+						return false;
+					}
+				}
+
+				if (!writer.flush())
+				{
+					return false;
+				}
+			}
+
+			std::error_code error;
+			std::filesystem::rename(temporary_path, path, error);
+			return !error;
+		}
+	};
+}
+
+#endif // COYOTE_FAILURE_BUCKETS_H
@@ -0,0 +1,61 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_FAILURE_SIGNATURE_H
+#define COYOTE_FAILURE_SIGNATURE_H
+
+#include <cstdint>
+#include "schedule_corpus.h"
+#include "../error_code.h"
+
+namespace coyote
+{
+	// The resource of a failure whose operation did not wait for or signal any resource.
+	constexpr uint64_t NO_RESOURCE_ID = ~0ull;
+
+	// Identifies a failure independently of the seed and iteration that found it, so that the many iterations
+	// of a campaign that hit the same bug can be bucketed together.
+	struct FailureSignature
+	{
+		// The error code of the iteration, such as 'DeadlockDetected', else success.
+		ErrorCode error_code = ErrorCode::Success;
+
+		// The failure that the client reported, such as the id of the failed assertion or monitor, else '0'.
+		uint64_t reported_failure = 0;
+
+		// The id of the operation that was scheduled when the failure was found.
+		uint64_t operation_id = 0;
+
+		// The resource that this operation last waited for or signaled, else 'NO_RESOURCE_ID'.
+		uint64_t resource_id = NO_RESOURCE_ID;
+
+		// Hash of the last steps of the schedule before the failure was found.
+		uint64_t tail_hash = 0;
+
+		// Returns true if the signature describes a failure, else false.
+		bool is_failure() const noexcept
+		{
+			return error_code != ErrorCode::Success || reported_failure != 0;
+		}
+
+		// Returns the 64-bit FNV-1a hash of the fields, which identifies the bucket of the failure.
+		uint64_t hash() const noexcept
+		{
+			uint64_t values[] = { (uint64_t)error_code, reported_failure, operation_id, resource_id, tail_hash };
+			return schedule_corpus::fnv1a(values, sizeof(values));
+		}
+
+		bool operator==(const FailureSignature& other) const noexcept
+		{
+			return error_code == other.error_code && reported_failure == other.reported_failure &&
+				operation_id == other.operation_id && resource_id == other.resource_id && tail_hash == other.tail_hash;
+		}
+
+		bool operator!=(const FailureSignature& other) const noexcept
+		{
+			return !(*this == other);
+		}
+	};
+}
+
+#endif // COYOTE_FAILURE_SIGNATURE_H
@@ -0,0 +1,162 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_MAPPED_FILE_H
+#define COYOTE_MAPPED_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif // NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // _WIN32
+
+namespace coyote
+{
+	// Read-only memory mapping of a whole file.
+	class MappedFile
+	{
+	private:
+		// The first byte of the mapping, or null if no file is mapped.
+		const uint8_t* bytes;
+
+		// The size of the mapping in bytes.
+		size_t length;
+
+#ifdef _WIN32
+		HANDLE file_handle;
+		HANDLE mapping_handle;
+#endif // _WIN32
+
+	public:
+		MappedFile() noexcept :
+			bytes(nullptr),
+			length(0)
+#ifdef _WIN32
+			, file_handle(INVALID_HANDLE_VALUE),
+			mapping_handle(nullptr)
+#endif // _WIN32
+		{
+		}
+
+		MappedFile(MappedFile&& file) = delete;
+		MappedFile(MappedFile const&) = delete;
+
+		MappedFile& operator=(MappedFile&& file) = delete;
+		MappedFile& operator=(MappedFile const&) = delete;
+
+		~MappedFile()
+		{
+			close();
+		}
+
+		// Maps the specified file. Returns false if the file does not exist, is empty, or cannot be mapped.
+		bool open(const std::string& path) noexcept
+		{
+			close();
+#ifdef _WIN32
+			file_handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+				OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+			LARGE_INTEGER file_size;
+			if (file_handle == INVALID_HANDLE_VALUE || !GetFileSizeEx(file_handle, &file_size) ||
+				file_size.QuadPart == 0)
+			{
+				close();
+				return false;
+			}
+
+			mapping_handle = CreateFileMappingA(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			void* view = mapping_handle != nullptr ? MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0) : nullptr;
+			if (view == nullptr)
+			{
+				close();
+				return false;
+			}
+
+			bytes = static_cast<const uint8_t*>(view);
+			length = (size_t)file_size.QuadPart;
+#else
+			int fd = ::open(path.c_str(), O_RDONLY);
+			if (fd < 0)
+			{
+				return false;
+			}
+
+			struct stat file_stat;
+			if (fstat(fd, &file_stat) != 0 || file_stat.st_size == 0)
+			{
+				::close(fd);
+				return false;
+			}
+
+			// The mapping stays valid after the descriptor is closed.
+			void* view = mmap(nullptr, (size_t)file_stat.st_size, PROT_READ, MAP_SHARED, fd, 0);
+			::close(fd);
+			if (view == MAP_FAILED)
+			{
+				return false;
+			}
+
+			bytes = static_cast<const uint8_t*>(view);
+			length = (size_t)file_stat.st_size;
+#endif // _WIN32
+			return true;
+		}
+
+		// Unmaps the file, invalidating all pointers into it.
+		void close() noexcept
+		{
+#ifdef _WIN32
+			if (bytes != nullptr)
+			{
+				UnmapViewOfFile(bytes);
+			}
+
+			if (mapping_handle != nullptr)
+			{
+				CloseHandle(mapping_handle);
+				mapping_handle = nullptr;
+			}
+
+			if (file_handle != INVALID_HANDLE_VALUE)
+			{
+				CloseHandle(file_handle);
+				file_handle = INVALID_HANDLE_VALUE;
+			}
+#else
+			if (bytes != nullptr)
+			{
+				munmap(const_cast<uint8_t*>(bytes), length);
+			}
+#endif // _WIN32
+			bytes = nullptr;
+			length = 0;
+		}
+
+		bool is_open() const noexcept
+		{
+			return bytes != nullptr;
+		}
+
+		const uint8_t* data() const noexcept
+		{
+			return bytes;
+		}
+
+		size_t size() const noexcept
+		{
+			return length;
+		}
+	};
+}
+
+#endif // COYOTE_MAPPED_FILE_H
@@ -0,0 +1,247 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_PARALLEL_EXPLORER_H
+#define COYOTE_PARALLEL_EXPLORER_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "schedule_trace.h"
+#include "../scheduler.h"
+#include "../strategies/dfs_strategy.h"
+
+namespace coyote
+{
+	// The outcome of a parallel exploration.
+	struct ExplorationResult
+	{
+		// Number of iterations that were run.
+		size_t iterations = 0;
+
+		// Number of iterations that failed.
+		size_t failures = 0;
+
+		// Number of times that a worker gave part of its subtree to an idle worker.
+		size_t splits = 0;
+
+		// True if all schedules were enumerated, else false.
+		bool is_complete = false;
+
+		// Signature of the first failure that was found, or zero if there was none.
+		uint64_t failure = 0;
+
+		// The schedule of the first failure that was found.
+		ScheduleTrace failing_schedule;
+	};
+
+	// Enumerates the schedules of a test with the DFS strategy on several threads. The tree of schedules is
+	// split into subtrees, each identified by a prefix of choices, which are shared through a work queue.
+	// Each worker runs the test on its own scheduler, replaying the prefix of its subtree and enumerating
+	// the rest. While some worker is idle, the busy workers give it the upper half of the alternatives
+	// left at the shallowest choice point of their subtree, between two iterations, so the work is spread
+	// without knowing the shape of the tree in advance.
+	class ParallelExplorer
+	{
+	private:
+		// Runs an iteration of the test.
+		std::function<uint64_t(Scheduler&)> test;
+
+		// Number of worker threads.
+		size_t parallelism;
+
+		// Max number of choice points per iteration, or zero if unbounded.
+		size_t max_depth;
+
+		// Max number of iterations, or zero if unbounded.
+		size_t max_iterations;
+
+		// True if the exploration stops at the first failure, else false.
+		bool is_stopping_on_failure;
+
+		// Protects the work queue and the result.
+		std::mutex mutex;
+
+		// Notifies idle workers that there is work or that the exploration is done.
+		std::condition_variable work_cv;
+
+		// Prefixes of the subtrees that no worker has started yet.
+		std::deque<std::vector<ChoicePoint>> work_queue;
+
+		// Number of workers that wait for a subtree.
+		std::atomic<size_t> idle_count;
+
+		// Number of iterations that were started.
+		std::atomic<size_t> iteration_count;
+
+		// True if the workers should stop, else false.
+		std::atomic<bool> is_stopped;
+
+		// True if all workers are idle and there is no work left, else false.
+		bool is_done;
+
+		ExplorationResult result;
+
+	public:
+		// Creates an explorer that runs the specified test on up to the specified number of threads, or on one
+		// thread per core if it is zero. The test must attach to and detach from the scheduler that it is
+		// given, keep all its state local, and return a nonzero failure signature if the iteration failed.
+		ParallelExplorer(std::function<uint64_t(Scheduler&)> test, size_t parallelism = 0, size_t max_depth = 0,
+			size_t max_iterations = 0, bool is_stopping_on_failure = true) :
+			test(std::move(test)),
+			parallelism(parallelism > 0 ? parallelism : std::max<size_t>(1, std::thread::hardware_concurrency())),
+			max_depth(max_depth),
+			max_iterations(max_iterations),
+			is_stopping_on_failure(is_stopping_on_failure),
+			idle_count(0),
+			iteration_count(0),
+			is_stopped(false),
+			is_done(false)
+		{
+		}
+
+		ParallelExplorer(ParallelExplorer&& explorer) = delete;
+		ParallelExplorer(ParallelExplorer const&) = delete;
+
+		ParallelExplorer& operator=(ParallelExplorer&& explorer) = delete;
+		ParallelExplorer& operator=(ParallelExplorer const&) = delete;
+
+		// Enumerates the schedules of the test, and returns the outcome.
+		ExplorationResult explore()
+		{
+			result = ExplorationResult();
+			work_queue.clear();
+			work_queue.push_back({});
+			idle_count = 0;
+			iteration_count = 0;
+			is_stopped = false;
+			is_done = false;
+
+			std::vector<std::thread> workers;
+			for (size_t i = 1; i < parallelism; i++)
+			{
+				workers.emplace_back([this]() { work(); });
+			}
+
+			work();
+			for (auto& worker : workers)
+			{
+				worker.join();
+			}
+
+			result.is_complete = !is_stopped;
+			return result;
+		}
+
+	private:
+		// Runs the subtrees of the work queue until the exploration is done.
+		void work()
+		{
+			auto settings = std::make_unique<Settings>();
+			settings->use_dfs_strategy(max_depth);
+			Scheduler scheduler(std::move(settings));
+			auto& strategy = dynamic_cast<DFSStrategy&>(scheduler.exploration_strategy());
+
+			std::vector<ChoicePoint> prefix;
+			while (take_work(prefix))
+			{
+				strategy.enumerate_subtree(prefix);
+				while (strategy.enumerations() == 0 && !is_stopped)
+				{
+					if (max_iterations > 0 && iteration_count++ >= max_iterations)
+					{
+						stop();
+						break;
+					}
+
+					run_iteration(scheduler);
+					if (idle_count > 0 && strategy.enumerations() == 0 && strategy.split(prefix))
+					{
+						std::unique_lock<std::mutex> lock(mutex);
+						work_queue.push_back(prefix);
+						result.splits++;
+						work_cv.notify_one();
+					}
+				}
+			}
+		}
+
+		void run_iteration(Scheduler& scheduler)
+		{
+			uint64_t failure;
+			try
+			{
+				failure = test(scheduler);
+			}
+			catch (...)
+			{
+				failure = (uint64_t)ErrorCode::Failure;
+			}
+
+			std::unique_lock<std::mutex> lock(mutex);
+			result.iterations++;
+			if (failure != 0)
+			{
+				result.failures++;
+				if (result.failure == 0)
+				{
+					result.failure = failure;
+					result.failing_schedule = scheduler.schedule_trace();
+				}
+
+				if (is_stopping_on_failure)
+				{
+					is_stopped = true;
+					work_cv.notify_all();
+				}
+			}
+		}
+
+		// Writes the prefix of the next subtree, waiting until there is one. Returns false if the exploration
+		// is done, else true.
+		bool take_work(std::vector<ChoicePoint>& prefix)
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			idle_count++;
+			while (work_queue.empty() && !is_done && !is_stopped)
+			{
+				if (idle_count == parallelism)
+				{
+					// No worker is left to split its subtree, so every schedule was enumerated.
+					is_done = true;
+					work_cv.notify_all();
+				}
+				else
+				{
+					work_cv.wait(lock);
+				}
+			}
+
+			idle_count--;
+			if (is_done || is_stopped)
+			{
+				return false;
+			}
+
+			prefix = std::move(work_queue.front());
+			work_queue.pop_front();
+			return true;
+		}
+
+		void stop()
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			is_stopped = true;
+			work_cv.notify_all();
+		}
+	};
+}
+
+#endif // COYOTE_PARALLEL_EXPLORER_H
@@ -0,0 +1,437 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_SCHEDULE_CORPUS_H
+#define COYOTE_SCHEDULE_CORPUS_H
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <unordered_map>
+#include <vector>
+#include "mapped_file.h"
+#include "schedule_trace.h"
+
+namespace coyote
+{
+	// Header at the start of a schedule corpus file.
+	//
+	// A corpus is append-only: the header is followed by records, each of which is a fixed-size
+	// 'ScheduleRecordHeader' that is immediately followed by its steps. All sizes are multiples of
+	// eight bytes, so a memory-mapped corpus can be read in place without copying or parsing.
+	struct ScheduleCorpusHeader
+	{
+		// Identifies the file as a schedule corpus.
+		char magic[8];
+
+		// The version of the corpus format.
+		uint32_t version;
+
+		// The size of each schedule step in bytes.
+		uint32_t step_size;
+
+		// The size of each record header in bytes.
+		uint32_t record_header_size;
+
+		// Padding, must be zero.
+		uint32_t reserved;
+	};
+
+	// Header of a single schedule in a corpus.
+	struct ScheduleRecordHeader
+	{
+		// Marks the start of a record, which helps detect torn or misaligned writes.
+		uint32_t marker;
+
+		// Padding, must be zero.
+		uint32_t reserved;
+
+		// The number of steps that follow this header.
+		uint64_t step_count;
+
+		// The seed of the iteration that produced the schedule.
+		uint64_t seed;
+
+		// User-defined tag, such as the error code that the iteration ended with.
+		uint64_t tag;
+
+		// Checksum of the step count, seed, tag and steps of the record.
+		uint64_t checksum;
+	};
+
+	static_assert(sizeof(ScheduleCorpusHeader) == 24, "unexpected schedule corpus header size");
+	static_assert(sizeof(ScheduleRecordHeader) == 40, "unexpected schedule record header size");
+
+	constexpr char SCHEDULE_CORPUS_MAGIC[8] = { 'C', 'O', 'Y', 'S', 'C', 'H', 'E', 'D' };
+	constexpr uint32_t SCHEDULE_CORPUS_VERSION = 1;
+	constexpr uint32_t SCHEDULE_RECORD_MARKER = 0x43455253;
+
+	namespace schedule_corpus
+	{
+		// Updates the specified 64-bit FNV-1a hash with the specified bytes.
+		inline uint64_t fnv1a(const void* data, size_t size, uint64_t hash = 14695981039346656037ull) noexcept
+		{
+			const uint8_t* bytes = static_cast<const uint8_t*>(data);
+			for (size_t i = 0; i < size; i++)
+			{
+				hash ^= bytes[i];
+				hash *= 1099511628211ull;
+			}
+
+			return hash;
+		}
+
+		inline uint64_t checksum(const ScheduleRecordHeader& header, const ScheduleStep* steps) noexcept
+		{
+			uint64_t hash = fnv1a(&header.step_count, sizeof(header.step_count));
+			hash = fnv1a(&header.seed, sizeof(header.seed), hash);
+			hash = fnv1a(&header.tag, sizeof(header.tag), hash);
+			return fnv1a(steps, (size_t)header.step_count * sizeof(ScheduleStep), hash);
+		}
+
+		// Returns true if the specified bytes start with a compatible corpus header.
+		inline bool has_valid_header(const uint8_t* data, size_t size) noexcept
+		{
+			ScheduleCorpusHeader header;
+			if (size < sizeof(header))
+			{
+				return false;
+			}
+
+			std::memcpy(&header, data, sizeof(header));
+			return std::memcmp(header.magic, SCHEDULE_CORPUS_MAGIC, sizeof(header.magic)) == 0 &&
+				header.version == SCHEDULE_CORPUS_VERSION &&
+				header.step_size == sizeof(ScheduleStep) &&
+				header.record_header_size == sizeof(ScheduleRecordHeader) &&
+				header.reserved == 0;
+		}
+
+		// Walks the record headers that follow the corpus header, adding the offset of each complete
+		// record to the specified index, if any. Returns the offset where the complete records end, which
+		// is less than the size if the last append was torn. Steps are not read, so this is cheap.
+		inline size_t scan(const uint8_t* data, size_t size, std::vector<uint64_t>* offsets) noexcept
+		{
+			size_t offset = sizeof(ScheduleCorpusHeader);
+			while (size - offset >= sizeof(ScheduleRecordHeader))
+			{
+				const ScheduleRecordHeader* header = reinterpret_cast<const ScheduleRecordHeader*>(data + offset);
+				size_t available = (size - offset - sizeof(ScheduleRecordHeader)) / sizeof(ScheduleStep);
+				if (header->marker != SCHEDULE_RECORD_MARKER || header->reserved != 0 ||
+					header->step_count > available)
+				{
+					break;
+				}
+
+				if (offsets != nullptr)
+				{
+					offsets->push_back(offset);
+				}
+
+				offset += sizeof(ScheduleRecordHeader) + (size_t)header->step_count * sizeof(ScheduleStep);
+			}
+
+			return offset;
+		}
+
+		// Returns true if the bytes after the specified end of the complete records cannot hold a complete
+		// record, which is left behind if the last append was torn, else false if a record is corrupted.
+		inline bool is_torn(const uint8_t* data, size_t size, size_t end) noexcept
+		{
+			if (size - end < sizeof(ScheduleRecordHeader))
+			{
+				return true;
+			}
+
+			const ScheduleRecordHeader* header = reinterpret_cast<const ScheduleRecordHeader*>(data + end);
+			size_t available = (size - end - sizeof(ScheduleRecordHeader)) / sizeof(ScheduleStep);
+			return header->marker == SCHEDULE_RECORD_MARKER && header->reserved == 0 &&
+				header->step_count > available;
+		}
+	}
+
+	// Appends schedules to a corpus file, creating the file if it does not exist.
+	class ScheduleCorpusWriter
+	{
+	private:
+		std::ofstream file;
+
+	public:
+		ScheduleCorpusWriter() noexcept
+		{
+		}
+
+		ScheduleCorpusWriter(ScheduleCorpusWriter&& writer) = delete;
+		ScheduleCorpusWriter(ScheduleCorpusWriter const&) = delete;
+
+		ScheduleCorpusWriter& operator=(ScheduleCorpusWriter&& writer) = delete;
+		ScheduleCorpusWriter& operator=(ScheduleCorpusWriter const&) = delete;
+
+		// Opens the specified corpus for appending. A torn record at the end of an existing corpus, which
+		// is left behind if a previous writer crashed, is truncated. Returns false if the file exists but
+		// is not a compatible corpus, if it has a corrupted record, which must first be dropped with
+		// 'ScheduleCorpus::compact', or if it cannot be written.
+		bool open(const std::string& path)
+		{
+			file.close();
+			std::error_code error;
+			if (std::filesystem::exists(path, error) && std::filesystem::file_size(path, error) > 0)
+			{
+				size_t valid_size = 0;
+				{
+					MappedFile mapping;
+					if (!mapping.open(path) || !schedule_corpus::has_valid_header(mapping.data(), mapping.size()))
+					{
+						return false;
+					}
+
+					valid_size = schedule_corpus::scan(mapping.data(), mapping.size(), nullptr);
+					if (valid_size == mapping.size())
+					{
+						valid_size = 0;
+					}
+					else if (!schedule_corpus::is_torn(mapping.data(), mapping.size(), valid_size))
+					{
+						// Truncating would also drop the valid records that follow the corrupted one.
+						return false;
+					}
+				}
+
+				if (valid_size > 0)
+				{
+					std::filesystem::resize_file(path, valid_size, error);
+					if (error)
+					{
+						return false;
+					}
+				}
+
+				file.open(path, std::ios::binary | std::ios::app);
+			}
+			else
+			{
+				file.open(path, std::ios::binary | std::ios::trunc);
+				ScheduleCorpusHeader header;
+				std::memcpy(header.magic, SCHEDULE_CORPUS_MAGIC, sizeof(header.magic));
+				header.version = SCHEDULE_CORPUS_VERSION;
+				header.step_size = sizeof(ScheduleStep);
+				header.record_header_size = sizeof(ScheduleRecordHeader);
+				header.reserved = 0;
+				file.write((const char*)&header, sizeof(header));
+			}
+
+			return file.good();
+		}
+
+		// Appends the specified schedule. Returns false if the write failed.
+		bool append(ScheduleView schedule, uint64_t seed, uint64_t tag)
+		{
+			ScheduleRecordHeader header;
+			header.marker = SCHEDULE_RECORD_MARKER;
+			header.reserved = 0;
+			header.step_count = schedule.size();
+			header.seed = seed;
+			header.tag = tag;
+			header.checksum = schedule_corpus::checksum(header, schedule.data());
+			file.write((const char*)&header, sizeof(header));
+			file.write((const char*)schedule.data(), schedule.size() * sizeof(ScheduleStep));
+			return file.good();
+		}
+
+		// Writes all appended schedules to the file.
+		bool flush()
+		{
+			file.flush();
+			return file.good();
+		}
+
+		void close()
+		{
+			file.close();
+		}
+
+		bool is_open() const noexcept
+		{
+			return file.is_open();
+		}
+	};
+
+	// Memory-mapped, read-only view of a schedule corpus. Opening a corpus walks the record headers to
+	// index them, after which each schedule is returned as a view into the mapping, without any copy
+	// or allocation. Checksums are only validated on request, so that streaming a trusted corpus does
+	// not touch every page twice.
+	class ScheduleCorpus
+	{
+	private:
+		// The mapped corpus file.
+		MappedFile mapping;
+
+		// The offset of each complete record in the file.
+		std::vector<uint64_t> offsets;
+
+		// True if the file ends with a torn record, else false.
+		bool has_torn_record;
+
+	public:
+		ScheduleCorpus() noexcept :
+			has_torn_record(false)
+		{
+		}
+
+		ScheduleCorpus(ScheduleCorpus&& corpus) = delete;
+		ScheduleCorpus(ScheduleCorpus const&) = delete;
+
+		ScheduleCorpus& operator=(ScheduleCorpus&& corpus) = delete;
+		ScheduleCorpus& operator=(ScheduleCorpus const&) = delete;
+
+		// Maps the specified corpus. Returns false if it is not a valid corpus file.
+		bool open(const std::string& path)
+		{
+			close();
+			if (!mapping.open(path) || !schedule_corpus::has_valid_header(mapping.data(), mapping.size()))
+			{
+				close();
+				return false;
+			}
+
+			size_t end = schedule_corpus::scan(mapping.data(), mapping.size(), &offsets);
+			has_torn_record = end != mapping.size();
+			return true;
+		}
+
+		// Unmaps the corpus, invalidating all views into it.
+		void close() noexcept
+		{
+			mapping.close();
+			offsets.clear();
+			has_torn_record = false;
+		}
+
+		// Returns the number of complete schedules in the corpus.
+		size_t size() const noexcept
+		{
+			return offsets.size();
+		}
+
+		// Returns true if the corpus ends with an incomplete record, which is ignored.
+		bool is_truncated() const noexcept
+		{
+			return has_torn_record;
+		}
+
+		// Returns the header of the schedule at the specified index.
+		const ScheduleRecordHeader& header(size_t index) const noexcept
+		{
+			return *reinterpret_cast<const ScheduleRecordHeader*>(mapping.data() + offsets[index]);
+		}
+
+		// Returns the steps of the schedule at the specified index, which are valid until the corpus is closed.
+		ScheduleView schedule(size_t index) const noexcept
+		{
+			const uint8_t* record = mapping.data() + offsets[index];
+			return ScheduleView(reinterpret_cast<const ScheduleStep*>(record + sizeof(ScheduleRecordHeader)),
+				(size_t)header(index).step_count);
+		}
+
+		uint64_t seed(size_t index) const noexcept
+		{
+			return header(index).seed;
+		}
+
+		uint64_t tag(size_t index) const noexcept
+		{
+			return header(index).tag;
+		}
+
+		// Returns true if the checksum of the schedule at the specified index matches its contents.
+		bool is_valid(size_t index) const noexcept
+		{
+			return schedule_corpus::checksum(header(index), schedule(index).data()) == header(index).checksum;
+		}
+
+		// Returns true if all schedules in the corpus are intact.
+		bool verify() const noexcept
+		{
+			for (size_t i = 0; i < offsets.size(); i++)
+			{
+				if (!is_valid(i))
+				{
+					return false;
+				}
+			}
+
+			return true;
+		}
+
+		// Rewrites the specified corpus in place, dropping corrupted records, a torn last record, and
+		// records whose steps, seed and tag all duplicate an earlier record. Returns false if the corpus
+		// could not be read or written, in which case it is left unchanged.
+		static bool compact(const std::string& path)
+		{
+			std::string compacted_path = path + ".compact";
+			{
+				ScheduleCorpus corpus;
+				if (!corpus.open(path))
+				{
+					return false;
+				}
+
+				std::error_code error;
+				std::filesystem::remove(compacted_path, error);
+				ScheduleCorpusWriter writer;
+				if (!writer.open(compacted_path))
+				{
+					return false;
+				}
+
+				// Map from the hash of the steps of each kept schedule to the indexes of all such schedules.
+				std::unordered_map<uint64_t, std::vector<size_t>> kept_schedules;
+				for (size_t i = 0; i < corpus.size(); i++)
+				{
+					if (!corpus.is_valid(i))
+					{
+						continue;
+					}
+
+					ScheduleView schedule = corpus.schedule(i);
+					uint64_t hash = schedule_corpus::fnv1a(schedule.data(), schedule.size() * sizeof(ScheduleStep));
+					auto& candidates = kept_schedules[hash];
+					bool is_duplicate = false;
+					for (size_t candidate : candidates)
+					{
+						ScheduleView other = corpus.schedule(candidate);
+						if (corpus.seed(candidate) == corpus.seed(i) && corpus.tag(candidate) == corpus.tag(i) &&
+							other.size() == schedule.size() &&
+							std::memcmp(other.data(), schedule.data(), schedule.size() * sizeof(ScheduleStep)) == 0)
+						{
+							is_duplicate = true;
+							break;
+						}
+					}
+
+					if (!is_duplicate)
+					{
+						candidates.push_back(i);
+						if (!writer.append(schedule, corpus.seed(i), corpus.tag(i)))
+						{
+							return false;
+						}
+					}
+				}
+
+				if (!writer.flush())
+				{
+					return false;
+				}
+			}
+
+			std::error_code error;
+			std::filesystem::rename(compacted_path, path, error);
+			return !error;
+		}
+	};
+}
+
+#endif // COYOTE_SCHEDULE_CORPUS_H
@@ -0,0 +1,271 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_SCHEDULE_DIFF_H
+#define COYOTE_SCHEDULE_DIFF_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "schedule_minimizer.h"
+#include "schedule_trace.h"
+
+namespace coyote
+{
+	// A contiguous range of steps that differs between two schedules. The steps in the
+	// [left_start, left_start + left_count) range of the left schedule are replaced by the steps in the
+	// [right_start, right_start + right_count) range of the right schedule.
+	struct ScheduleHunk
+	{
+		size_t left_start;
+		size_t left_count;
+		size_t right_start;
+		size_t right_count;
+	};
+
+	// Identifies a step of a schedule by the operation that was scheduled when the choice was made, and by
+	// the number of choices that this operation had made before, which is how the replay strategy matches
+	// choices across runs.
+	struct ScheduleDecision
+	{
+		// The index of the step.
+		size_t step;
+
+		// The operation that was scheduled when the choice was made.
+		uint64_t operation_id;
+
+		// The number of choices made by the operation before this one.
+		size_t choice;
+	};
+
+	// The result of bisecting the differences between a passing and a failing schedule.
+	struct ScheduleBisection
+	{
+		// The index of the first hunk that makes the passing schedule fail, if applied together with all
+		// hunks before it, or the number of hunks if the failure was not reproduced.
+		size_t hunk;
+
+		// The executed schedule of the first failing hybrid schedule.
+		ScheduleTrace schedule;
+
+		// Number of replays that were needed.
+		size_t evaluations;
+	};
+
+	// Compares the schedules of two runs of the same test, such as a passing and a failing one.
+	class ScheduleDiff
+	{
+	public:
+		// Returns the index of the first step where the schedules differ, or the size of the shorter
+		// schedule if it is a prefix of the other one.
+		static size_t first_divergence(ScheduleView left, ScheduleView right) noexcept
+		{
+			size_t size = std::min(left.size(), right.size());
+			for (size_t i = 0; i < size; i++)
+			{
+				if (left[i] != right[i])
+				{
+					return i;
+				}
+			}
+
+			return size;
+		}
+
+		// Returns the decision that the specified step of the schedule made.
+		static ScheduleDecision decision(ScheduleView schedule, size_t step)
+		{
+			std::unordered_map<uint64_t, size_t> choice_counts;
+			uint64_t current = 0;
+			size_t choice = 0;
+			for (size_t i = 0; i <= step && i < schedule.size(); i++)
+			{
+				if (schedule[i].kind == ScheduleStepKind::Operation)
+				{
+					choice = choice_counts[current]++;
+					if (i < step)
+					{
+						current = schedule[i].value;
+					}
+				}
+			}
+
+			return { step, current, choice };
+		}
+
+		// Returns the smallest set of hunks that turns the left schedule into the right one, using the
+		// Myers diff algorithm after trimming the common prefix and suffix. If the schedules differ in
+		// more than the specified number of steps, a single hunk that spans all differing steps is
+		// returned instead, which bounds the quadratic memory of the algorithm.
+		static std::vector<ScheduleHunk> diff(ScheduleView left, ScheduleView right, size_t max_cost = 1024)
+		{
+			size_t prefix = first_divergence(left, right);
+			size_t suffix = 0;
+			while (suffix < left.size() - prefix && suffix < right.size() - prefix &&
+				left[left.size() - suffix - 1] == right[right.size() - suffix - 1])
+			{
+				suffix++;
+			}
+
+			ScheduleView a(left.data() + prefix, left.size() - prefix - suffix);
+			ScheduleView b(right.data() + prefix, right.size() - prefix - suffix);
+			std::vector<ScheduleHunk> hunks;
+			if (a.empty() && b.empty())
+			{
+				return hunks;
+			}
+
+			const long n = (long)a.size();
+			const long m = (long)b.size();
+			const long offset = n + m + 1;
+			std::vector<long> v((size_t)(2 * offset + 1), 0);
+			std::vector<std::vector<long>> history;
+			long cost = -1;
+			for (long d = 0; d <= n + m && d <= (long)max_cost && cost < 0; d++)
+			{
+				for (long k = -d; k <= d; k += 2)
+				{
+					long x = (k == -d || (k != d && v[offset + k - 1] < v[offset + k + 1])) ?
+						v[offset + k + 1] : v[offset + k - 1] + 1;
+					long y = x - k;
+					while (x < n && y < m && a[(size_t)x] == b[(size_t)y])
+					{
+						x++;
+						y++;
+					}
+
+					v[offset + k] = x;
+					if (x >= n && y >= m)
+					{
+						cost = d;
+					}
+				}
+
+				history.emplace_back(v.begin() + (offset - d), v.begin() + (offset + d + 1));
+			}
+
+			if (cost < 0)
+			{
+				hunks.push_back({ prefix, a.size(), prefix, b.size() });
+				return hunks;
+			}
+
+			// Walk back from the end to recover the edits in reverse order. Each edit is the (x, y) position
+			// before it, and either inserts 'b[y]' or deletes 'a[x]'.
+			struct Edit
+			{
+				long x;
+				long y;
+				bool is_insertion;
+			};
+
+			std::vector<Edit> edits;
+			long x = n;
+			long y = m;
+			for (long d = cost; d > 0; d--)
+			{
+				const std::vector<long>& previous = history[(size_t)(d - 1)];
+				long k = x - y;
+				bool is_insertion = k == -d ||
+					(k != d && previous[(size_t)(k - 1 + d - 1)] < previous[(size_t)(k + 1 + d - 1)]);
+				long previous_k = is_insertion ? k + 1 : k - 1;
+				long previous_x = previous[(size_t)(previous_k + d - 1)];
+				long previous_y = previous_x - previous_k;
+				edits.push_back({ previous_x, previous_y, is_insertion });
+				x = previous_x;
+				y = previous_y;
+			}
+
+			// Group adjacent edits into hunks.
+			for (auto it = edits.rbegin(); it != edits.rend(); it++)
+			{
+				size_t left_start = prefix + (size_t)it->x;
+				size_t right_start = prefix + (size_t)it->y;
+				if (!hunks.empty() && hunks.back().left_start + hunks.back().left_count == left_start &&
+					hunks.back().right_start + hunks.back().right_count == right_start)
+				{
+					(it->is_insertion ? hunks.back().right_count : hunks.back().left_count)++;
+				}
+				else
+				{
+					hunks.push_back({ left_start, it->is_insertion ? 0u : 1u, right_start, it->is_insertion ? 1u : 0u });
+				}
+			}
+
+			return hunks;
+		}
+
+		// Returns the left schedule with the first count hunks replaced by the steps of the right schedule.
+		static ScheduleTrace apply(ScheduleView left, ScheduleView right, const std::vector<ScheduleHunk>& hunks,
+			size_t count)
+		{
+			ScheduleTrace result;
+			size_t position = 0;
+			for (size_t i = 0; i < count && i < hunks.size(); i++)
+			{
+				const ScheduleHunk& hunk = hunks[i];
+				for (; position < hunk.left_start; position++)
+				{
+					result.push_back(left[position]);
+				}
+
+				for (size_t j = 0; j < hunk.right_count; j++)
+				{
+					result.push_back(right[hunk.right_start + j]);
+				}
+
+				position += hunk.left_count;
+			}
+
+			for (; position < left.size(); position++)
+			{
+				result.push_back(left[position]);
+			}
+
+			return result;
+		}
+
+		// Bisects the hunks between a passing and a failing schedule, by replaying the passing schedule with
+		// a growing number of hunks applied, to find the hunk that introduces the failure with the specified
+		// signature. This assumes that applying more hunks never hides the failure.
+		static ScheduleBisection bisect(ScheduleView passing, ScheduleView failing, const std::vector<ScheduleHunk>& hunks,
+			const ScheduleEvaluator& evaluator, uint64_t failure)
+		{
+			ScheduleBisection result = { hunks.size(), ScheduleTrace(), 0 };
+
+			// Find the smallest number of applied hunks in the (low, high] range that reproduces the failure.
+			size_t low = 0;
+			size_t high = hunks.size();
+			ScheduleOutcome outcome = evaluator(apply(passing, failing, hunks, high));
+			result.evaluations++;
+			if (outcome.failure != failure)
+			{
+				return result;
+			}
+
+			result.schedule = std::move(outcome.schedule);
+			while (high - low > 1)
+			{
+				size_t middle = low + (high - low) / 2;
+				outcome = evaluator(apply(passing, failing, hunks, middle));
+				result.evaluations++;
+				if (outcome.failure == failure)
+				{
+					high = middle;
+					result.schedule = std::move(outcome.schedule);
+				}
+				else
+				{
+					low = middle;
+				}
+			}
+
+			result.hunk = high - 1;
+			return result;
+		}
+	};
+}
+
+#endif // COYOTE_SCHEDULE_DIFF_H
@@ -0,0 +1,270 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_SCHEDULE_MINIMIZER_H
+#define COYOTE_SCHEDULE_MINIMIZER_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "schedule_trace.h"
+#include "../scheduler.h"
+
+namespace coyote
+{
+	// The outcome of running a candidate schedule.
+	struct ScheduleOutcome
+	{
+		// Signature of the failure that the run ended with, or zero if it passed.
+		uint64_t failure = 0;
+
+		// The schedule that was actually executed.
+		ScheduleTrace schedule;
+	};
+
+	// Runs a candidate schedule and returns its outcome.
+	using ScheduleEvaluator = std::function<ScheduleOutcome(const ScheduleTrace&)>;
+
+	// Minimizes a failing schedule with delta debugging. The minimizer repeatedly drops subsets of the
+	// context switches of the schedule, replays each candidate, and keeps any candidate that fails with
+	// the same signature and has fewer context switches or steps than the current schedule. The
+	// candidates of each round are evaluated in parallel, and the first one in a fixed order that
+	// succeeds is kept, so the result does not depend on timing.
+	class ScheduleMinimizer
+	{
+	private:
+		// Runs the candidate schedules.
+		ScheduleEvaluator evaluator;
+
+		// Max number of candidates that are evaluated concurrently.
+		size_t parallelism;
+
+		// Max number of evaluations, or zero if unbounded.
+		size_t max_evaluations;
+
+		// Number of evaluations so far.
+		size_t evaluation_count;
+
+	public:
+		// Creates a minimizer that runs candidates with the specified evaluator on up to the specified
+		// number of threads, or on one thread per core if it is zero. The evaluator must be safe to call
+		// concurrently.
+		ScheduleMinimizer(ScheduleEvaluator evaluator, size_t parallelism = 0, size_t max_evaluations = 0) :
+			evaluator(std::move(evaluator)),
+			parallelism(parallelism > 0 ? parallelism : std::max<size_t>(1, std::thread::hardware_concurrency())),
+			max_evaluations(max_evaluations),
+			evaluation_count(0)
+		{
+		}
+
+		ScheduleMinimizer(ScheduleMinimizer&& minimizer) = delete;
+		ScheduleMinimizer(ScheduleMinimizer const&) = delete;
+
+		ScheduleMinimizer& operator=(ScheduleMinimizer&& minimizer) = delete;
+		ScheduleMinimizer& operator=(ScheduleMinimizer const&) = delete;
+
+		// Returns an evaluator that replays each candidate on a new scheduler using the specified seed for
+		// data choices, and runs the specified test on it. The test must attach to and detach from the
+		// scheduler, and return a nonzero failure signature, such as an error code, if the run failed.
+		static ScheduleEvaluator replay_evaluator(std::function<uint64_t(Scheduler&)> test, uint64_t seed)
+		{
+			return [test, seed](const ScheduleTrace& candidate)
+			{
+				auto settings = std::make_unique<Settings>();
+				settings->use_replay_strategy(candidate, seed);
+				Scheduler scheduler(std::move(settings));
+				uint64_t failure = test(scheduler);
+				return ScheduleOutcome{ failure, scheduler.schedule_trace() };
+			};
+		}
+
+		// Returns the indexes of the operation steps that are not skipped and schedule a different operation
+		// than the previous operation step, starting from the main operation.
+		static std::vector<size_t> context_switches(const ScheduleTrace& schedule)
+		{
+			std::vector<size_t> switches;
+			uint64_t current = 0;
+			for (size_t i = 0; i < schedule.size(); i++)
+			{
+				if (schedule[i].kind == ScheduleStepKind::Operation)
+				{
+					if (schedule[i].value != current && (schedule[i].flags & SCHEDULE_STEP_SKIPPED) == 0)
+					{
+						switches.push_back(i);
+					}
+
+					current = schedule[i].value;
+				}
+			}
+
+			return switches;
+		}
+
+		// Minimizes the specified schedule, which fails with the specified signature, and returns the
+		// smallest failing schedule that was found.
+		ScheduleTrace minimize(const ScheduleTrace& schedule, uint64_t failure)
+		{
+			ScheduleTrace current = schedule;
+			std::vector<size_t> switches = context_switches(current);
+			size_t granularity = 2;
+			while (switches.size() > 0 && !is_exhausted())
+			{
+				granularity = std::min(granularity, switches.size());
+				size_t chunk_size = (switches.size() + granularity - 1) / granularity;
+				size_t chunk_count = (switches.size() + chunk_size - 1) / chunk_size;
+
+				// Candidates that keep a single chunk come before candidates that drop a single chunk. With
+				// two chunks both kinds are the same, so only the latter are tried.
+				std::vector<ScheduleTrace> candidates;
+				if (chunk_count > 2)
+				{
+					for (size_t chunk = 0; chunk < chunk_count; chunk++)
+					{
+						candidates.push_back(build_candidate(current, switches, chunk * chunk_size,
+							std::min(switches.size(), (chunk + 1) * chunk_size), true));
+					}
+				}
+
+				size_t complements_start = candidates.size();
+				for (size_t chunk = 0; chunk < chunk_count; chunk++)
+				{
+					candidates.push_back(build_candidate(current, switches, chunk * chunk_size,
+						std::min(switches.size(), (chunk + 1) * chunk_size), false));
+				}
+
+				ScheduleOutcome outcome;
+				size_t index = evaluate(candidates, current, failure, outcome);
+				if (index < candidates.size())
+				{
+					current = std::move(outcome.schedule);
+					switches = context_switches(current);
+					granularity = index < complements_start ? 2 : std::max<size_t>(granularity - 1, 2);
+				}
+				else if (granularity >= switches.size())
+				{
+					break;
+				}
+				else
+				{
+					granularity = std::min(granularity * 2, switches.size());
+				}
+			}
+
+			return current;
+		}
+
+		// Returns the number of candidates that were evaluated so far.
+		size_t evaluations() const noexcept
+		{
+			return evaluation_count;
+		}
+
+	private:
+		bool is_exhausted() const noexcept
+		{
+			return max_evaluations > 0 && evaluation_count >= max_evaluations;
+		}
+
+		// Returns a copy of the schedule that only keeps the context switches in the [start, end) range
+		// of the switches, if keep is true, or all other context switches, if keep is false. Dropped
+		// context switches are skipped, so that the replay strategy keeps running the current operation.
+		static ScheduleTrace build_candidate(const ScheduleTrace& schedule, const std::vector<size_t>& switches,
+			size_t start, size_t end, bool keep)
+		{
+			ScheduleTrace candidate = schedule;
+			for (size_t i = 0; i < switches.size(); i++)
+			{
+				bool is_in_range = i >= start && i < end;
+				if (is_in_range != keep)
+				{
+					candidate[switches[i]].flags |= SCHEDULE_STEP_SKIPPED;
+				}
+			}
+
+			return candidate;
+		}
+
+		// Returns true if the outcome reproduces the failure with a smaller schedule than the current one.
+		static bool is_improvement(const ScheduleOutcome& outcome, const ScheduleTrace& current, uint64_t failure)
+		{
+			if (outcome.failure != failure)
+			{
+				return false;
+			}
+
+			size_t switch_count = context_switches(outcome.schedule).size();
+			size_t current_switch_count = context_switches(current).size();
+			return switch_count < current_switch_count ||
+				(switch_count == current_switch_count && outcome.schedule.size() < current.size());
+		}
+
+		// Evaluates the candidates in parallel, and returns the index of the first candidate that is an
+		// improvement, writing its outcome, or the number of candidates if there is none. Candidates after
+		// an improvement that was already found are skipped.
+		size_t evaluate(const std::vector<ScheduleTrace>& candidates, const ScheduleTrace& current, uint64_t failure,
+			ScheduleOutcome& result)
+		{
+			size_t count = candidates.size();
+			if (max_evaluations > 0)
+			{
+				count = std::min(count, max_evaluations - evaluation_count);
+			}
+
+			std::vector<ScheduleOutcome> outcomes(count);
+			std::atomic<size_t> next_index(0);
+			std::atomic<size_t> best_index(candidates.size());
+			std::atomic<size_t> completed_count(0);
+			auto work = [&]()
+			{
+				for (size_t index = next_index++; index < count && index < best_index; index = next_index++)
+				{
+					try
+					{
+						outcomes[index] = evaluator(candidates[index]);
+					}
+					catch (...)
+					{
+						outcomes[index].failure = 0;
+					}
+
+					completed_count++;
+
+					if (is_improvement(outcomes[index], current, failure))
+					{
+						size_t best = best_index.load();
+						while (index < best && !best_index.compare_exchange_weak(best, index))
+						{
+						}
+					}
+				}
+			};
+
+			std::vector<std::thread> workers;
+			for (size_t i = 1; i < std::min(parallelism, count); i++)
+			{
+				workers.emplace_back(work);
+			}
+
+			work();
+			for (auto& worker : workers)
+			{
+				worker.join();
+			}
+
+			evaluation_count += completed_count.load();
+			size_t index = best_index.load();
+			if (index < candidates.size())
+			{
+				result = std::move(outcomes[index]);
+			}
+
+			return index;
+		}
+	};
+}
+
+#endif // COYOTE_SCHEDULE_MINIMIZER_H
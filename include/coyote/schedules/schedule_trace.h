@@ -0,0 +1,207 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_SCHEDULE_TRACE_H
+#define COYOTE_SCHEDULE_TRACE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace coyote
+{
+	// Kinds of nondeterministic choices that a schedule consists of.
+	enum class ScheduleStepKind : uint32_t
+	{
+		Operation = 0,
+		Boolean,
+		Integer
+	};
+
+	// Flag of a step that only preserves the progress of the replayed schedule, but whose operation
+	// choice is not enforced, which is how edited schedules drop context switches.
+	constexpr uint32_t SCHEDULE_STEP_SKIPPED = 1;
+
+	// A single choice of a schedule, such as the id of the operation that was scheduled next.
+	struct ScheduleStep
+	{
+		// The kind of the choice.
+		ScheduleStepKind kind;
+
+		// Flags of the step, such as 'SCHEDULE_STEP_SKIPPED'.
+		uint32_t flags;
+
+		// The chosen operation id, boolean or integer.
+		uint64_t value;
+	};
+
+	static_assert(sizeof(ScheduleStep) == 16, "unexpected schedule step size");
+
+	inline bool operator==(const ScheduleStep& left, const ScheduleStep& right) noexcept
+	{
+		return left.kind == right.kind && left.flags == right.flags && left.value == right.value;
+	}
+
+	inline bool operator!=(const ScheduleStep& left, const ScheduleStep& right) noexcept
+	{
+		return !(left == right);
+	}
+
+	// Read-only view of a sequence of schedule steps that are owned by someone else, such as a
+	// 'ScheduleTrace' or a memory-mapped schedule corpus.
+	class ScheduleView
+	{
+	private:
+		const ScheduleStep* steps;
+		size_t count;
+
+	public:
+		ScheduleView() noexcept :
+			steps(nullptr),
+			count(0)
+		{
+		}
+
+		ScheduleView(const ScheduleStep* steps, size_t count) noexcept :
+			steps(steps),
+			count(count)
+		{
+		}
+
+		const ScheduleStep* data() const noexcept
+		{
+			return steps;
+		}
+
+		size_t size() const noexcept
+		{
+			return count;
+		}
+
+		bool empty() const noexcept
+		{
+			return count == 0;
+		}
+
+		const ScheduleStep& operator[](size_t index) const noexcept
+		{
+			return steps[index];
+		}
+
+		const ScheduleStep* begin() const noexcept
+		{
+			return steps;
+		}
+
+		const ScheduleStep* end() const noexcept
+		{
+			return steps + count;
+		}
+
+		// Returns the 64-bit FNV-1a hash of the kinds and values of the steps, which identifies the schedule
+		// independently of the flags of its steps.
+		uint64_t hash() const noexcept
+		{
+			uint64_t result = 14695981039346656037ull;
+			for (size_t i = 0; i < count; i++)
+			{
+				uint64_t words[2] = { (uint64_t)steps[i].kind, steps[i].value };
+				for (uint64_t word : words)
+				{
+					for (unsigned shift = 0; shift < 64; shift += 8)
+					{
+						result ^= (word >> shift) & 0xff;
+						result *= 1099511628211ull;
+					}
+				}
+			}
+
+			return result;
+		}
+	};
+
+	// Records the sequence of choices that were made during a testing iteration.
+	class ScheduleTrace
+	{
+	private:
+		std::vector<ScheduleStep> steps;
+
+	public:
+		ScheduleTrace() noexcept
+		{
+		}
+
+		ScheduleTrace(ScheduleView view) :
+			steps(view.begin(), view.end())
+		{
+		}
+
+		void add_operation(size_t operation_id)
+		{
+			steps.push_back({ ScheduleStepKind::Operation, 0, (uint64_t)operation_id });
+		}
+
+		void add_boolean(bool value)
+		{
+			steps.push_back({ ScheduleStepKind::Boolean, 0, value ? 1u : 0u });
+		}
+
+		void add_integer(int value)
+		{
+			steps.push_back({ ScheduleStepKind::Integer, 0, (uint64_t)(int64_t)value });
+		}
+
+		void push_back(const ScheduleStep& step)
+		{
+			steps.push_back(step);
+		}
+
+		// Removes all steps, keeping the allocated memory for the next iteration.
+		void clear() noexcept
+		{
+			steps.clear();
+		}
+
+		const ScheduleStep* data() const noexcept
+		{
+			return steps.data();
+		}
+
+		size_t size() const noexcept
+		{
+			return steps.size();
+		}
+
+		bool empty() const noexcept
+		{
+			return steps.empty();
+		}
+
+		ScheduleStep& operator[](size_t index) noexcept
+		{
+			return steps[index];
+		}
+
+		const ScheduleStep& operator[](size_t index) const noexcept
+		{
+			return steps[index];
+		}
+
+		ScheduleView view() const noexcept
+		{
+			return ScheduleView(steps.data(), steps.size());
+		}
+
+		bool operator==(const ScheduleTrace& other) const noexcept
+		{
+			return steps == other.steps;
+		}
+
+		bool operator!=(const ScheduleTrace& other) const noexcept
+		{
+			return !(*this == other);
+		}
+	};
+}
+
+#endif // COYOTE_SCHEDULE_TRACE_H
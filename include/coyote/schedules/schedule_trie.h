@@ -0,0 +1,655 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_SCHEDULE_TRIE_H
+#define COYOTE_SCHEDULE_TRIE_H
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "mapped_file.h"
+#include "../strategies/dfs_strategy.h"
+
+namespace coyote
+{
+	// Header at the start of a schedule trie file, which is followed by the nodes and then by the labels.
+	// The nodes and labels are stored as they are in memory, so a memory-mapped trie can be queried in
+	// place without copying or parsing.
+	struct ScheduleTrieHeader
+	{
+		// Identifies the file as a schedule trie.
+		char magic[8];
+
+		// The version of the trie format.
+		uint32_t version;
+
+		// The size of each node in bytes.
+		uint32_t node_size;
+
+		// The number of nodes.
+		uint64_t node_count;
+
+		// The size of the labels in bytes.
+		uint64_t label_size;
+	};
+
+	// A node of a schedule trie. Each node, except for the root, holds a label of one or more choice points,
+	// and its children continue the branch after the last of them. Children are kept in a list that is
+	// sorted by the index of their first choice.
+	struct ScheduleTrieNode
+	{
+		// The offset and size in bytes of the label in the labels of the trie.
+		uint32_t label_offset;
+		uint32_t label_size;
+
+		// The first child and the next sibling, or '0' if there is none, as the root is never a child.
+		uint32_t first_child;
+		uint32_t next_sibling;
+
+		// The index of the first choice of the label, so that children are found without decoding labels.
+		uint32_t first_index;
+
+		// Flags of the node, such as 'SCHEDULE_TRIE_EXPLORED'.
+		uint32_t flags;
+	};
+
+	static_assert(sizeof(ScheduleTrieHeader) == 32, "unexpected schedule trie header size");
+	static_assert(sizeof(ScheduleTrieNode) == 24, "unexpected schedule trie node size");
+
+	constexpr char SCHEDULE_TRIE_MAGIC[8] = { 'C', 'O', 'Y', 'T', 'R', 'I', 'E', '\0' };
+	constexpr uint32_t SCHEDULE_TRIE_VERSION = 1;
+
+	// Flag of a node whose branches after its label are all explored.
+	constexpr uint32_t SCHEDULE_TRIE_TAIL_EXPLORED = 1;
+
+	// Flag of a node whose branches after its first choice are all explored, which also requires the
+	// other choice points of its label to have no other alternative.
+	constexpr uint32_t SCHEDULE_TRIE_EXPLORED = 2;
+
+	namespace schedule_trie
+	{
+		// Appends the specified value as a LEB128 varint, so that small choices take a single byte.
+		inline void encode(std::vector<uint8_t>& bytes, uint64_t value)
+		{
+			while (value >= 0x80)
+			{
+				bytes.push_back((uint8_t)(value | 0x80));
+				value >>= 7;
+			}
+
+			bytes.push_back((uint8_t)value);
+		}
+
+		// Decodes a LEB128 varint at the specified position, advancing the position.
+		inline uint64_t decode(const uint8_t* bytes, size_t& position) noexcept
+		{
+			uint64_t value = 0;
+			for (unsigned shift = 0; shift < 64; shift += 7)
+			{
+				uint8_t byte = bytes[position++];
+				value |= (uint64_t)(byte & 0x7f) << shift;
+				if ((byte & 0x80) == 0)
+				{
+					break;
+				}
+			}
+
+			return value;
+		}
+	}
+
+	// Read-only view of a schedule trie whose nodes and labels are owned by someone else, such as a
+	// 'ScheduleTrie' or a memory-mapped trie file.
+	class ScheduleTrieView
+	{
+	private:
+		const ScheduleTrieNode* nodes;
+		size_t node_count;
+		const uint8_t* labels;
+		size_t label_size;
+
+	public:
+		ScheduleTrieView() noexcept :
+			nodes(nullptr),
+			node_count(0),
+			labels(nullptr),
+			label_size(0)
+		{
+		}
+
+		ScheduleTrieView(const ScheduleTrieNode* nodes, size_t node_count, const uint8_t* labels, size_t label_size) noexcept :
+			nodes(nodes),
+			node_count(node_count),
+			labels(labels),
+			label_size(label_size)
+		{
+		}
+
+		const ScheduleTrieNode* node_data() const noexcept
+		{
+			return nodes;
+		}
+
+		size_t size() const noexcept
+		{
+			return node_count;
+		}
+
+		const uint8_t* label_data() const noexcept
+		{
+			return labels;
+		}
+
+		size_t label_bytes() const noexcept
+		{
+			return label_size;
+		}
+
+		// Returns true if all branches that start with the specified prefix are explored, else false. Only
+		// the indexes of the prefix are compared.
+		bool is_explored(const std::vector<ChoicePoint>& prefix) const noexcept
+		{
+			return is_explored(prefix, prefix.empty() ? 0 : prefix.back().index);
+		}
+
+		// Writes the lowest index after the index of the last choice point of the specified prefix, at the
+		// same choice point, whose branches are not all explored. Returns false if there is none, else true.
+		bool next_unexplored(const std::vector<ChoicePoint>& prefix, size_t& index) const noexcept
+		{
+			if (prefix.empty())
+			{
+				return false;
+			}
+
+			for (size_t next = prefix.back().index + 1; next < prefix.back().count; next++)
+			{
+				if (!is_explored(prefix, next))
+				{
+					index = next;
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		// Returns true if the nodes and labels are consistent, so that queries stay within their bounds and
+		// end. The children and next sibling of each node must come after it, as they do in saved tries, so
+		// that the links cannot form a cycle.
+		bool is_valid() const noexcept
+		{
+			if (node_count == 0)
+			{
+				return false;
+			}
+
+			for (size_t i = 0; i < node_count; i++)
+			{
+				const ScheduleTrieNode& node = nodes[i];
+				if (node.first_child >= node_count || node.next_sibling >= node_count ||
+					(node.first_child != 0 && node.first_child <= i) ||
+					(node.next_sibling != 0 && node.next_sibling <= i) ||
+					(uint64_t)node.label_offset + node.label_size > label_size ||
+					(i > 0 && node.label_size == 0) ||
+					(node.label_size > 0 && (labels[node.label_offset + node.label_size - 1] & 0x80) != 0))
+				{
+					return false;
+				}
+
+				// Each choice point of the label is a count and an index, so decoding stays within the label.
+				size_t position = node.label_offset;
+				size_t end = node.label_offset + node.label_size;
+				while (position < end)
+				{
+					schedule_trie::decode(labels, position);
+					if (position == end)
+					{
+						return false;
+					}
+
+					schedule_trie::decode(labels, position);
+				}
+			}
+
+			return true;
+		}
+
+	private:
+		// Returns true if all branches that start with the specified prefix, with the index of its last choice
+		// point replaced by the specified index, are explored.
+		bool is_explored(const std::vector<ChoicePoint>& prefix, size_t last_index) const noexcept
+		{
+			if (node_count == 0)
+			{
+				return false;
+			}
+
+			uint32_t node = 0;
+			size_t i = 0;
+			while (true)
+			{
+				// The whole label of the node was matched, so the prefix continues after it.
+				if ((nodes[node].flags & SCHEDULE_TRIE_TAIL_EXPLORED) != 0)
+				{
+					return true;
+				}
+				else if (i == prefix.size())
+				{
+					return false;
+				}
+
+				size_t index = i + 1 == prefix.size() ? last_index : prefix[i].index;
+				uint32_t child = nodes[node].first_child;
+				while (child != 0 && nodes[child].first_index < index)
+				{
+					child = nodes[child].next_sibling;
+				}
+
+				if (child == 0 || nodes[child].first_index != index)
+				{
+					return false;
+				}
+				else if ((nodes[child].flags & SCHEDULE_TRIE_EXPLORED) != 0)
+				{
+					return true;
+				}
+
+				// Match the label of the child with the prefix.
+				const ScheduleTrieNode& child_node = nodes[child];
+				size_t position = child_node.label_offset;
+				size_t end = child_node.label_offset + child_node.label_size;
+				while (position < end)
+				{
+					if (i == prefix.size())
+					{
+						// The prefix ends inside the label, so the remaining choice points of the label must
+						// have no other alternative.
+						while (position < end)
+						{
+							if (schedule_trie::decode(labels, position) != 1)
+							{
+								return false;
+							}
+
+							schedule_trie::decode(labels, position);
+						}
+
+						return (child_node.flags & SCHEDULE_TRIE_TAIL_EXPLORED) != 0;
+					}
+
+					schedule_trie::decode(labels, position);
+					size_t label_index = (size_t)schedule_trie::decode(labels, position);
+					if (label_index != (i + 1 == prefix.size() ? last_index : prefix[i].index))
+					{
+						return false;
+					}
+
+					i++;
+				}
+
+				node = child;
+			}
+		}
+	};
+
+	// A trie of the explored branches of the schedule tree of a test, where each branch is the sequence of
+	// choice points of a schedule, as enumerated by the DFS strategy. Chains of choice points without other
+	// explored alternatives are stored as a single node, whose label encodes the count and index of each
+	// choice point as varints, so a branch of small choices takes about two bytes per choice point plus a
+	// node per divergence. Nodes and labels are kept in flat arrays, which can be saved to a file and
+	// queried in place once it is memory-mapped.
+	//
+	// Once all alternatives of a choice point are explored, the whole subtree is known to be explored, so
+	// queries stop there. The trie is not synchronized, so concurrent users must lock it.
+	class ScheduleTrie
+	{
+	private:
+		std::vector<ScheduleTrieNode> nodes;
+		std::vector<uint8_t> labels;
+
+	public:
+		ScheduleTrie() :
+			nodes(1, ScheduleTrieNode{ 0, 0, 0, 0, 0, 0 })
+		{
+		}
+
+		ScheduleTrie(ScheduleTrieView view) :
+			nodes(view.node_data(), view.node_data() + view.size()),
+			labels(view.label_data(), view.label_data() + view.label_bytes())
+		{
+			if (nodes.empty())
+			{
+				nodes.push_back({ 0, 0, 0, 0, 0, 0 });
+			}
+		}
+
+		ScheduleTrie(ScheduleTrie&& trie) = delete;
+		ScheduleTrie(ScheduleTrie const&) = delete;
+
+		ScheduleTrie& operator=(ScheduleTrie&& trie) = delete;
+		ScheduleTrie& operator=(ScheduleTrie const&) = delete;
+
+		// Marks all branches that start with the specified prefix as explored, such as the branch of a
+		// schedule that completed. Only the indexes of the prefix are compared with the trie.
+		void mark_explored(const std::vector<ChoicePoint>& prefix)
+		{
+			std::vector<uint32_t> trail(1, 0);
+			uint32_t node = 0;
+			size_t i = 0;
+			while ((nodes[node].flags & SCHEDULE_TRIE_TAIL_EXPLORED) == 0)
+			{
+				if (i == prefix.size())
+				{
+					nodes[node].flags |= SCHEDULE_TRIE_TAIL_EXPLORED;
+					break;
+				}
+
+				// Find the child with the next choice, or the sibling that it goes after.
+				uint32_t previous = 0;
+				uint32_t child = nodes[node].first_child;
+				while (child != 0 && nodes[child].first_index < prefix[i].index)
+				{
+					previous = child;
+					child = nodes[child].next_sibling;
+				}
+
+				if (child == 0 || nodes[child].first_index != prefix[i].index)
+				{
+					uint32_t leaf = add_node(prefix, i, child);
+					if (previous == 0)
+					{
+						nodes[node].first_child = leaf;
+					}
+					else
+					{
+						nodes[previous].next_sibling = leaf;
+					}
+
+					nodes[leaf].flags |= SCHEDULE_TRIE_TAIL_EXPLORED;
+					trail.push_back(leaf);
+					break;
+				}
+				else if ((nodes[child].flags & SCHEDULE_TRIE_EXPLORED) != 0)
+				{
+					break;
+				}
+
+				// Split the label of the child where the prefix ends or diverges from it.
+				size_t matched = 0;
+				size_t position = nodes[child].label_offset;
+				size_t end = nodes[child].label_offset + nodes[child].label_size;
+				while (position < end && i + matched < prefix.size())
+				{
+					size_t choice_start = position;
+					schedule_trie::decode(labels.data(), position);
+					if (schedule_trie::decode(labels.data(), position) != prefix[i + matched].index)
+					{
+						position = choice_start;
+						break;
+					}
+
+					matched++;
+				}
+
+				if (position < end)
+				{
+					split(child, position - nodes[child].label_offset);
+				}
+
+				trail.push_back(child);
+				node = child;
+				i += matched;
+			}
+
+			for (size_t t = trail.size(); t > 0; t--)
+			{
+				update(trail[t - 1]);
+			}
+		}
+
+		// Returns true if all branches that start with the specified prefix are explored, else false.
+		bool is_explored(const std::vector<ChoicePoint>& prefix) const noexcept
+		{
+			return view().is_explored(prefix);
+		}
+
+		// Writes the lowest index after the index of the last choice point of the specified prefix, at the
+		// same choice point, whose branches are not all explored. Returns false if there is none, else true.
+		bool next_unexplored(const std::vector<ChoicePoint>& prefix, size_t& index) const noexcept
+		{
+			return view().next_unexplored(prefix, index);
+		}
+
+		// Returns the number of nodes, including the root.
+		size_t size() const noexcept
+		{
+			return nodes.size();
+		}
+
+		// Returns the number of bytes of the nodes and labels.
+		size_t memory_size() const noexcept
+		{
+			return nodes.size() * sizeof(ScheduleTrieNode) + labels.size();
+		}
+
+		ScheduleTrieView view() const noexcept
+		{
+			return ScheduleTrieView(nodes.data(), nodes.size(), labels.data(), labels.size());
+		}
+
+		// Writes the trie to the specified file, replacing it. Returns false if the write failed. The nodes are
+		// written in depth-first order, so that the children and next sibling of each node come after it.
+		bool save(const std::string& path) const
+		{
+			std::ofstream file(path, std::ios::binary | std::ios::trunc);
+			if (!file.is_open())
+			{
+				return false;
+			}
+
+			// New nodes are linked before older siblings and splits move children to new nodes, so the nodes
+			// are renumbered in the order in which they are visited.
+			std::vector<uint32_t> order;
+			std::vector<uint32_t> new_ids(nodes.size(), 0);
+			std::vector<uint32_t> stack(1, 0);
+			while (!stack.empty())
+			{
+				uint32_t node = stack.back();
+				stack.pop_back();
+				new_ids[node] = (uint32_t)order.size();
+				order.push_back(node);
+
+				// The next sibling is pushed first, so that the subtree of the node is visited before it.
+				if (nodes[node].next_sibling != 0)
+				{
+					stack.push_back(nodes[node].next_sibling);
+				}
+
+				if (nodes[node].first_child != 0)
+				{
+					stack.push_back(nodes[node].first_child);
+				}
+			}
+
+			std::vector<ScheduleTrieNode> ordered_nodes;
+			ordered_nodes.reserve(order.size());
+			for (uint32_t node : order)
+			{
+				ScheduleTrieNode ordered_node = nodes[node];
+				ordered_node.first_child = new_ids[ordered_node.first_child];
+				ordered_node.next_sibling = new_ids[ordered_node.next_sibling];
+				ordered_nodes.push_back(ordered_node);
+			}
+
+			ScheduleTrieHeader header;
+			std::memcpy(header.magic, SCHEDULE_TRIE_MAGIC, sizeof(header.magic));
+			header.version = SCHEDULE_TRIE_VERSION;
+			header.node_size = sizeof(ScheduleTrieNode);
+			header.node_count = ordered_nodes.size();
+			header.label_size = labels.size();
+			file.write((const char*)&header, sizeof(header));
+			file.write((const char*)ordered_nodes.data(), ordered_nodes.size() * sizeof(ScheduleTrieNode));
+			file.write((const char*)labels.data(), labels.size());
+			file.flush();
+			return file.good();
+		}
+
+	private:
+		// Adds a node whose label holds the choice points of the prefix from the specified position, before
+		// the specified sibling, and returns it.
+		uint32_t add_node(const std::vector<ChoicePoint>& prefix, size_t start, uint32_t next_sibling)
+		{
+			size_t offset = labels.size();
+			for (size_t i = start; i < prefix.size(); i++)
+			{
+				schedule_trie::encode(labels, prefix[i].count);
+				schedule_trie::encode(labels, prefix[i].index);
+			}
+
+			nodes.push_back({ (uint32_t)offset, (uint32_t)(labels.size() - offset), 0, next_sibling,
+				(uint32_t)prefix[start].index, 0 });
+			return (uint32_t)(nodes.size() - 1);
+		}
+
+		// Splits the label of the specified node at the specified byte offset, moving the rest of the label
+		// and the children of the node into a new child.
+		void split(uint32_t node, size_t offset)
+		{
+			size_t position = nodes[node].label_offset + offset;
+			size_t index_position = position;
+			schedule_trie::decode(labels.data(), index_position);
+			uint32_t first_index = (uint32_t)schedule_trie::decode(labels.data(), index_position);
+
+			ScheduleTrieNode rest = { (uint32_t)position, (uint32_t)(nodes[node].label_size - offset),
+				nodes[node].first_child, 0, first_index, nodes[node].flags & SCHEDULE_TRIE_TAIL_EXPLORED };
+			nodes.push_back(rest);
+			uint32_t child = (uint32_t)(nodes.size() - 1);
+			update(child);
+
+			nodes[node].label_size = (uint32_t)offset;
+			nodes[node].first_child = child;
+			nodes[node].flags = 0;
+		}
+
+		// Updates the flags of the specified node from its children.
+		void update(uint32_t node)
+		{
+			ScheduleTrieNode& current = nodes[node];
+			if ((current.flags & SCHEDULE_TRIE_TAIL_EXPLORED) == 0 && current.first_child != 0)
+			{
+				// The children are the alternatives of the same choice point, so they have the same count.
+				size_t position = nodes[current.first_child].label_offset;
+				size_t count = (size_t)schedule_trie::decode(labels.data(), position);
+				size_t explored_count = 0;
+				for (uint32_t child = current.first_child; child != 0; child = nodes[child].next_sibling)
+				{
+					if ((nodes[child].flags & SCHEDULE_TRIE_EXPLORED) != 0)
+					{
+						explored_count++;
+					}
+				}
+
+				if (explored_count >= count)
+				{
+					current.flags |= SCHEDULE_TRIE_TAIL_EXPLORED;
+				}
+			}
+
+			if ((current.flags & SCHEDULE_TRIE_TAIL_EXPLORED) != 0)
+			{
+				// The other choice points of the label must have no other alternative.
+				bool is_explored = true;
+				size_t position = current.label_offset;
+				size_t end = current.label_offset + current.label_size;
+				bool is_first = true;
+				while (position < end)
+				{
+					size_t count = (size_t)schedule_trie::decode(labels.data(), position);
+					schedule_trie::decode(labels.data(), position);
+					if (!is_first && count != 1)
+					{
+						is_explored = false;
+						break;
+					}
+
+					is_first = false;
+				}
+
+				if (is_explored)
+				{
+					current.flags |= SCHEDULE_TRIE_EXPLORED;
+				}
+			}
+		}
+	};
+
+	// A schedule trie file that is memory-mapped and queried in place.
+	class ScheduleTrieFile
+	{
+	private:
+		MappedFile mapping;
+		ScheduleTrieView trie;
+
+	public:
+		ScheduleTrieFile() noexcept
+		{
+		}
+
+		ScheduleTrieFile(ScheduleTrieFile&& file) = delete;
+		ScheduleTrieFile(ScheduleTrieFile const&) = delete;
+
+		ScheduleTrieFile& operator=(ScheduleTrieFile&& file) = delete;
+		ScheduleTrieFile& operator=(ScheduleTrieFile const&) = delete;
+
+		// Maps the specified trie file. Returns false if the file does not exist or is not a valid trie.
+		bool open(const std::string& path) noexcept
+		{
+			trie = ScheduleTrieView();
+			if (!mapping.open(path) || mapping.size() < sizeof(ScheduleTrieHeader))
+			{
+				mapping.close();
+				return false;
+			}
+
+			ScheduleTrieHeader header;
+			std::memcpy(&header, mapping.data(), sizeof(header));
+			uint64_t node_bytes = header.node_count * sizeof(ScheduleTrieNode);
+			if (std::memcmp(header.magic, SCHEDULE_TRIE_MAGIC, sizeof(header.magic)) != 0 ||
+				header.version != SCHEDULE_TRIE_VERSION || header.node_size != sizeof(ScheduleTrieNode) ||
+				header.node_count > mapping.size() / sizeof(ScheduleTrieNode) ||
+				sizeof(header) + node_bytes + header.label_size != mapping.size())
+			{
+				mapping.close();
+				return false;
+			}
+
+			const uint8_t* data = mapping.data() + sizeof(header);
+			ScheduleTrieView view(reinterpret_cast<const ScheduleTrieNode*>(data), (size_t)header.node_count,
+				data + node_bytes, (size_t)header.label_size);
+			if (!view.is_valid())
+			{
+				mapping.close();
+				return false;
+			}
+
+			trie = view;
+			return true;
+		}
+
+		// Returns the mapped trie, which is valid until the file is closed.
+		ScheduleTrieView view() const noexcept
+		{
+			return trie;
+		}
+
+		void close() noexcept
+		{
+			trie = ScheduleTrieView();
+			mapping.close();
+		}
+	};
+}
+
+#endif // COYOTE_SCHEDULE_TRIE_H
@@ -0,0 +1,448 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_CAMPAIGN_COORDINATOR_H
+#define COYOTE_CAMPAIGN_COORDINATOR_H
+
+#ifndef _WIN32
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "connection_threads.h"
+#include "local_socket.h"
+#include "protocol.h"
+#include "../schedules/campaign_shard.h"
+
+namespace coyote
+{
+	// Splits a campaign into deterministic shards and hands them out to workers, which may run on other
+	// machines that share the socket, such as through a forwarded socket, or in other processes. Each
+	// connection holds the shards that it took until it completes them, and the shards of a connection
+	// that closes early are handed out again, so a lost worker only loses the iterations of its shard. The
+	// results of the completed shards are merged into a summary.
+	class CampaignCoordinator
+	{
+	private:
+		// The shard that each index describes, except for its index and worker.
+		const CampaignShard plan;
+
+		// Number of shards of the campaign.
+		const size_t shard_count;
+
+		// The path of the listening socket.
+		const std::string socket_path;
+
+		// The listening socket, or -1 if the coordinator is not running.
+		int listen_fd;
+
+		// Thread that accepts new worker connections.
+		std::thread accept_thread;
+
+		// Threads that serve accepted worker connections.
+		ConnectionThreads connections;
+
+		// Protects the shards and the summary.
+		std::mutex mutex;
+
+		// Notifies waiting workers and callers of 'wait' that a shard was returned or completed.
+		std::condition_variable shards_cv;
+
+		// Indexes of the shards that are not assigned to any worker.
+		std::deque<uint64_t> pending_shards;
+
+		// True for each shard that completed, else false.
+		std::vector<bool> completed_shards;
+
+		CampaignSummary campaign_summary;
+
+		// True if the coordinator is stopping, else false.
+		std::atomic<bool> is_stopping;
+
+	public:
+		// Creates a coordinator of a campaign with the specified randomized strategy, seed and bound, which
+		// is split into the specified number of shards of the specified number of iterations each.
+		CampaignCoordinator(std::string socket_path, StrategyType strategy, uint64_t seed, uint64_t bound,
+			size_t shard_count, uint64_t shard_iterations) :
+			plan({ 0, strategy, seed, 0, bound, shard_iterations }),
+			shard_count(shard_count),
+			socket_path(std::move(socket_path)),
+			listen_fd(-1),
+			completed_shards(shard_count, false),
+			is_stopping(false)
+		{
+			if (strategy == StrategyType::None || strategy == StrategyType::Replay || strategy == StrategyType::DFS)
+			{
+				throw std::invalid_argument("received a strategy that is not randomized");
+			}
+			else if (strategy == StrategyType::QLearning)
+			{
+				// Q-learning iterations depend on the values learned in the earlier iterations, so the token of
+				// a bug would not reproduce it.
+				throw std::invalid_argument("received a strategy whose iterations cannot be reproduced from a token");
+			}
+			else if (shard_count == 0 || shard_iterations == 0)
+			{
+				throw std::invalid_argument("received an empty campaign");
+			}
+
+			for (uint64_t i = 0; i < shard_count; i++)
+			{
+				pending_shards.push_back(i);
+			}
+		}
+
+		CampaignCoordinator(CampaignCoordinator&& coordinator) = delete;
+		CampaignCoordinator(CampaignCoordinator const&) = delete;
+
+		CampaignCoordinator& operator=(CampaignCoordinator&& coordinator) = delete;
+		CampaignCoordinator& operator=(CampaignCoordinator const&) = delete;
+
+		~CampaignCoordinator()
+		{
+			stop();
+		}
+
+		// Starts accepting worker connections.
+		ErrorCode start() noexcept
+		{
+			try
+			{
+				if (listen_fd >= 0)
+				{
+					throw ErrorCode::Failure;
+				}
+
+				listen_fd = local_socket::listen(socket_path);
+				is_stopping = false;
+				accept_thread = std::thread(&CampaignCoordinator::accept_connections, this);
+			}
+			catch (ErrorCode error_code)
+			{
+				return error_code;
+			}
+			catch (...)
+			{
+				return ErrorCode::Failure;
+			}
+
+			return ErrorCode::Success;
+		}
+
+		// Stops accepting worker connections and closes all accepted connections.
+		void stop() noexcept
+		{
+			if (listen_fd < 0)
+			{
+				return;
+			}
+
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				is_stopping = true;
+				shards_cv.notify_all();
+			}
+
+			::shutdown(listen_fd, SHUT_RDWR);
+			if (accept_thread.joinable())
+			{
+				accept_thread.join();
+			}
+
+			::close(listen_fd);
+			listen_fd = -1;
+			connections.shutdown_all();
+			::unlink(socket_path.c_str());
+		}
+
+		// Waits until all shards completed or the coordinator stopped, and returns the merged results.
+		CampaignSummary wait()
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			while (campaign_summary.completed_shards < shard_count && !is_stopping)
+			{
+				shards_cv.wait(lock);
+			}
+
+			return campaign_summary;
+		}
+
+		// Returns the merged results of the shards that completed so far.
+		CampaignSummary summary()
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			return campaign_summary;
+		}
+
+		// Returns the shard with the specified index.
+		CampaignShard shard(uint64_t index) const noexcept
+		{
+			CampaignShard result = plan;
+			result.index = index;
+			result.worker = index;
+			return result;
+		}
+
+	private:
+		void accept_connections()
+		{
+			while (!is_stopping)
+			{
+				int fd = ::accept(listen_fd, nullptr, nullptr);
+				if (fd < 0)
+				{
+					if (errno == EINTR)
+					{
+						continue;
+					}
+
+					break;
+				}
+
+				connections.serve(fd, [this](int connection_fd) { serve_connection(connection_fd); });
+			}
+		}
+
+		void serve_connection(int fd)
+		{
+			// The shards that this worker took and did not complete yet.
+			std::vector<uint64_t> leased_shards;
+			CoordinatorRequest request;
+			std::vector<uint64_t> words;
+			while (local_socket::receive_all(fd, &request, sizeof(request)))
+			{
+				if (request.count > MAX_COORDINATOR_REQUEST_WORDS)
+				{
+					break;
+				}
+
+				words.resize(request.count);
+				if (request.count > 0 && !local_socket::receive_all(fd, words.data(), words.size() * sizeof(uint64_t)))
+				{
+					break;
+				}
+
+				CoordinatorResponse response = { 0, 0, 0, 0, 0, 0, 0, 0 };
+				ErrorCode error_code = ErrorCode::Success;
+				if (request.opcode == CoordinatorOpcode::RequestShard)
+				{
+					uint64_t index;
+					if (take_shard(index))
+					{
+						leased_shards.push_back(index);
+						CampaignShard assigned = shard(index);
+						response.is_assigned = 1;
+						response.shard = assigned.index;
+						response.strategy = (uint64_t)assigned.strategy;
+						response.seed = assigned.seed;
+						response.worker = assigned.worker;
+						response.bound = assigned.bound;
+						response.iterations = assigned.iterations;
+					}
+				}
+				else if (request.opcode == CoordinatorOpcode::CompleteShard)
+				{
+					auto it = std::find(leased_shards.begin(), leased_shards.end(), request.shard);
+					ShardResult result;
+					if (it == leased_shards.end() || !ShardResult::from_words(words.data(), words.size(), result))
+					{
+						error_code = ErrorCode::Failure;
+					}
+					else
+					{
+						leased_shards.erase(it);
+						complete_shard(request.shard, result);
+					}
+				}
+				else
+				{
+					error_code = ErrorCode::Failure;
+				}
+
+				response.error_code = static_cast<std::underlying_type_t<ErrorCode>>(error_code);
+				if (!local_socket::send_all(fd, &response, sizeof(response)))
+				{
+					break;
+				}
+			}
+
+			// The worker was lost, so its shards are handed out again.
+			std::unique_lock<std::mutex> lock(mutex);
+			for (uint64_t index : leased_shards)
+			{
+				pending_shards.push_front(index);
+			}
+
+			shards_cv.notify_all();
+		}
+
+		// Takes the next pending shard, waiting while all shards are assigned but some may be handed out
+		// again. Returns false if all shards completed or the coordinator is stopping, else true.
+		bool take_shard(uint64_t& index)
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			while (pending_shards.empty() && campaign_summary.completed_shards < shard_count && !is_stopping)
+			{
+				shards_cv.wait(lock);
+			}
+
+			if (pending_shards.empty() || is_stopping)
+			{
+				return false;
+			}
+
+			index = pending_shards.front();
+			pending_shards.pop_front();
+			return true;
+		}
+
+		void complete_shard(uint64_t index, const ShardResult& result)
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			if (!completed_shards[index])
+			{
+				completed_shards[index] = true;
+				campaign_summary.merge(result);
+			}
+
+			shards_cv.notify_all();
+		}
+	};
+
+	// Client of a 'CampaignCoordinator' that runs shards of its campaign.
+	class CoordinatorClient
+	{
+	private:
+		// The connected socket, or -1 if the client is not connected.
+		int fd;
+
+		// Buffer that holds the next request and its words, so that both are sent in a single write.
+		std::vector<uint64_t> buffer;
+
+	public:
+		CoordinatorClient() noexcept :
+			fd(-1)
+		{
+		}
+
+		CoordinatorClient(CoordinatorClient&& client) = delete;
+		CoordinatorClient(CoordinatorClient const&) = delete;
+
+		CoordinatorClient& operator=(CoordinatorClient&& client) = delete;
+		CoordinatorClient& operator=(CoordinatorClient const&) = delete;
+
+		~CoordinatorClient()
+		{
+			disconnect();
+		}
+
+		// Connects to the coordinator that listens on the specified socket path.
+		ErrorCode connect(const std::string& socket_path) noexcept
+		{
+			try
+			{
+				disconnect();
+				fd = local_socket::connect(socket_path);
+			}
+			catch (ErrorCode error_code)
+			{
+				return error_code;
+			}
+			catch (...)
+			{
+				return ErrorCode::Failure;
+			}
+
+			return ErrorCode::Success;
+		}
+
+		// Closes the connection, which hands the shards that were not completed to other workers.
+		void disconnect() noexcept
+		{
+			if (fd >= 0)
+			{
+				::close(fd);
+				fd = -1;
+			}
+		}
+
+		// Takes the next shard, waiting while the other shards are being run by other workers. Returns false
+		// if all shards completed or the coordinator cannot be reached, else true.
+		bool request_shard(CampaignShard& shard) noexcept
+		{
+			CoordinatorResponse response;
+			if (call(CoordinatorOpcode::RequestShard, 0, response) != ErrorCode::Success || response.is_assigned == 0)
+			{
+				return false;
+			}
+
+			shard = { response.shard, (StrategyType)response.strategy, response.seed, response.worker, response.bound,
+				response.iterations };
+			return true;
+		}
+
+		// Reports the result of the specified shard, which must have been taken by this client.
+		ErrorCode complete_shard(const CampaignShard& shard, const ShardResult& result) noexcept
+		{
+			try
+			{
+				std::vector<uint64_t> words;
+				result.to_words(words);
+				CoordinatorResponse response;
+				return call(CoordinatorOpcode::CompleteShard, shard.index, response, words);
+			}
+			catch (...)
+			{
+				return ErrorCode::Failure;
+			}
+		}
+
+	private:
+		ErrorCode call(CoordinatorOpcode opcode, uint64_t shard, CoordinatorResponse& response,
+			const std::vector<uint64_t>& words = {}) noexcept
+		{
+			try
+			{
+				if (fd < 0)
+				{
+					throw ErrorCode::ClientNotAttached;
+				}
+				else if (words.size() > MAX_COORDINATOR_REQUEST_WORDS)
+				{
+					throw ErrorCode::Failure;
+				}
+
+				// The header is exactly two words long, so it can share the buffer with the words.
+				CoordinatorRequest request = { opcode, (uint32_t)words.size(), shard };
+				buffer.resize(2 + words.size());
+				std::memcpy(buffer.data(), &request, sizeof(request));
+				std::copy(words.begin(), words.end(), buffer.begin() + 2);
+				if (!local_socket::send_all(fd, buffer.data(), buffer.size() * sizeof(uint64_t)) ||
+					!local_socket::receive_all(fd, &response, sizeof(response)))
+				{
+					throw ErrorCode::Failure;
+				}
+
+				return static_cast<ErrorCode>(response.error_code);
+			}
+			catch (ErrorCode error_code)
+			{
+				return error_code;
+			}
+			catch (...)
+			{
+				return ErrorCode::Failure;
+			}
+		}
+	};
+}
+
+#endif // _WIN32
+
+#endif // COYOTE_CAMPAIGN_COORDINATOR_H
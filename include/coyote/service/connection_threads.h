@@ -0,0 +1,139 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_CONNECTION_THREADS_H
+#define COYOTE_CONNECTION_THREADS_H
+
+#ifndef _WIN32
+
+#include <functional>
+#include <iterator>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace coyote
+{
+	// Serves the accepted connections of a local socket, each on its own thread. A connection is closed
+	// and forgotten when its thread ends, and the threads of ended connections are joined when the next
+	// connection is served, so a long-running server does not keep a thread or a stale socket for each of
+	// its past connections.
+	class ConnectionThreads
+	{
+	private:
+		struct Connection
+		{
+			// The socket of the connection, or -1 if it was closed.
+			int fd;
+
+			// True if the connection was served, so its thread can be joined, else false.
+			bool is_finished;
+
+			std::thread thread;
+		};
+
+		// The connections whose threads were not joined yet.
+		std::list<Connection> connections;
+
+		// Mutex that synchronizes access to the connections, and their closing.
+		std::mutex mutex;
+
+	public:
+		ConnectionThreads() noexcept
+		{
+		}
+
+		ConnectionThreads(ConnectionThreads&& threads) = delete;
+		ConnectionThreads(ConnectionThreads const&) = delete;
+
+		ConnectionThreads& operator=(ConnectionThreads&& threads) = delete;
+		ConnectionThreads& operator=(ConnectionThreads const&) = delete;
+
+		~ConnectionThreads()
+		{
+			shutdown_all();
+		}
+
+		// Serves the specified connection with the specified handler on a new thread, and closes the
+		// connection once the handler returns.
+		void serve(int fd, std::function<void(int)> handler)
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			join_finished_inner();
+
+			// The thread only marks its connection as finished after taking the mutex, so it cannot do so
+			// before its connection is fully added.
+			connections.push_back({ fd, false, std::thread() });
+			auto it = std::prev(connections.end());
+			try
+			{
+				it->thread = std::thread([this, it, fd, handler = std::move(handler)]()
+				{
+					handler(fd);
+
+					// The socket is closed under the mutex, so that 'shutdown_all' never shuts down a socket
+					// whose descriptor was closed and possibly reused.
+					std::unique_lock<std::mutex> lock(mutex);
+					::close(fd);
+					it->fd = -1;
+					it->is_finished = true;
+				});
+			}
+			catch (...)
+			{
+				connections.erase(it);
+				::close(fd);
+				throw;
+			}
+		}
+
+		// Shuts down the open connections, which ends their handlers, and waits for all threads to end.
+		void shutdown_all() noexcept
+		{
+			std::list<Connection> remaining;
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				for (Connection& connection : connections)
+				{
+					if (connection.fd >= 0)
+					{
+						::shutdown(connection.fd, SHUT_RDWR);
+					}
+				}
+
+				// Moving the connections keeps them valid for their threads, which are joined without the
+				// mutex, as they take it before they end.
+				remaining.splice(remaining.end(), connections);
+			}
+
+			for (Connection& connection : remaining)
+			{
+				connection.thread.join();
+			}
+		}
+
+	private:
+		void join_finished_inner()
+		{
+			for (auto it = connections.begin(); it != connections.end();)
+			{
+				if (it->is_finished)
+				{
+					it->thread.join();
+					it = connections.erase(it);
+				}
+				else
+				{
+					++it;
+				}
+			}
+		}
+	};
+}
+
+#endif // _WIN32
+
+#endif // COYOTE_CONNECTION_THREADS_H
@@ -0,0 +1,131 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_LOCAL_SOCKET_H
+#define COYOTE_LOCAL_SOCKET_H
+
+#ifndef _WIN32
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "../error_code.h"
+
+namespace coyote
+{
+	// Helpers for Unix domain stream sockets, which keep the scheduler service on the local machine.
+	namespace local_socket
+	{
+		// Returns the address of the socket with the specified path.
+		inline sockaddr_un address(const std::string& path)
+		{
+			sockaddr_un addr;
+			std::memset(&addr, 0, sizeof(addr));
+			addr.sun_family = AF_UNIX;
+			if (path.size() >= sizeof(addr.sun_path))
+			{
+				throw ErrorCode::Failure;
+			}
+
+			std::memcpy(addr.sun_path, path.c_str(), path.size());
+			return addr;
+		}
+
+		// Creates a socket that listens on the specified path, replacing any stale socket file.
+		inline int listen(const std::string& path)
+		{
+			sockaddr_un addr = address(path);
+			int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+			if (fd < 0)
+			{
+				throw ErrorCode::Failure;
+			}
+
+			::unlink(path.c_str());
+			if (::bind(fd, (sockaddr*)&addr, sizeof(addr)) != 0 || ::listen(fd, SOMAXCONN) != 0)
+			{
+				::close(fd);
+				throw ErrorCode::Failure;
+			}
+
+			return fd;
+		}
+
+		// Connects to the socket that listens on the specified path.
+		inline int connect(const std::string& path)
+		{
+			sockaddr_un addr = address(path);
+			int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+			if (fd < 0)
+			{
+				throw ErrorCode::Failure;
+			}
+
+			if (::connect(fd, (sockaddr*)&addr, sizeof(addr)) != 0)
+			{
+				::close(fd);
+				throw ErrorCode::Failure;
+			}
+
+			return fd;
+		}
+
+		// Writes the whole buffer. Returns false if the connection was closed.
+		inline bool send_all(int fd, const void* buffer, size_t size) noexcept
+		{
+			const char* data = (const char*)buffer;
+			while (size > 0)
+			{
+	#ifdef MSG_NOSIGNAL
+				ssize_t count = ::send(fd, data, size, MSG_NOSIGNAL);
+	#else
+				ssize_t count = ::send(fd, data, size, 0);
+	#endif // MSG_NOSIGNAL
+				if (count < 0 && errno == EINTR)
+				{
+					continue;
+				}
+				else if (count <= 0)
+				{
+					return false;
+				}
+
+				data += count;
+				size -= (size_t)count;
+			}
+
+			return true;
+		}
+
+		// Reads until the whole buffer is filled. Returns false if the connection was closed.
+		inline bool receive_all(int fd, void* buffer, size_t size) noexcept
+		{
+			char* data = (char*)buffer;
+			while (size > 0)
+			{
+				ssize_t count = ::recv(fd, data, size, 0);
+				if (count < 0 && errno == EINTR)
+				{
+					continue;
+				}
+				else if (count <= 0)
+				{
+					return false;
+				}
+
+				data += count;
+				size -= (size_t)count;
+			}
+
+			return true;
+		}
+	}
+}
+
+#endif // _WIN32
+
+#endif // COYOTE_LOCAL_SOCKET_H
@@ -0,0 +1,119 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_SERVICE_PROTOCOL_H
+#define COYOTE_SERVICE_PROTOCOL_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace coyote
+{
+	// Operations that a client can request from a scheduler service.
+	enum class ServiceOpcode : uint32_t
+	{
+		None = 0,
+		Attach,
+		Detach,
+		CreateOperation,
+		StartOperation,
+		JoinOperation,
+		JoinOperations,
+		CompleteOperation,
+		CreateResource,
+		WaitResource,
+		WaitResources,
+		SignalResource,
+		SignalOperationResource,
+		DeleteResource,
+		ScheduleNext,
+		NextBoolean,
+		NextInteger,
+		ScheduledOperationId,
+		RandomSeed,
+		LastErrorCode
+	};
+
+	// Fixed-size request header. Requests that take a list of ids, such as 'JoinOperations', are
+	// followed by 'count' 64-bit ids, which are sent together with the header in a single write.
+	struct ServiceRequest
+	{
+		// The requested operation.
+		ServiceOpcode opcode;
+
+		// The number of 64-bit ids that follow this header.
+		uint32_t count;
+
+		// The first argument, typically an operation or resource id.
+		uint64_t arg0;
+
+		// The second argument, such as the 'wait_all' flag or a signaled operation id.
+		uint64_t arg1;
+	};
+
+	// Fixed-size response to a request.
+	struct ServiceResponse
+	{
+		// The error code returned by the scheduler.
+		int32_t error_code;
+
+		// Padding, must be zero.
+		uint32_t reserved;
+
+		// The value returned by requests that query the scheduler, else zero.
+		uint64_t value;
+	};
+
+	static_assert(sizeof(ServiceRequest) == 24, "unexpected service request size");
+	static_assert(sizeof(ServiceResponse) == 16, "unexpected service response size");
+
+	// Max number of ids that can follow a request header.
+	constexpr size_t MAX_SERVICE_REQUEST_IDS = 4096;
+
+	// Operations that a worker can request from a campaign coordinator.
+	enum class CoordinatorOpcode : uint32_t
+	{
+		None = 0,
+		RequestShard,
+		CompleteShard
+	};
+
+	// Fixed-size coordinator request header. A 'CompleteShard' request is followed by 'count' 64-bit words
+	// that encode the result of the shard, which are sent together with the header in a single write.
+	struct CoordinatorRequest
+	{
+		// The requested operation.
+		CoordinatorOpcode opcode;
+
+		// The number of 64-bit words that follow this header.
+		uint32_t count;
+
+		// The index of the completed shard, else zero.
+		uint64_t shard;
+	};
+
+	// Fixed-size response to a coordinator request, which describes the assigned shard, if any.
+	struct CoordinatorResponse
+	{
+		// The error code of the request.
+		int32_t error_code;
+
+		// True if a shard was assigned, else false, such as once all shards completed.
+		uint32_t is_assigned;
+
+		uint64_t shard;
+		uint64_t strategy;
+		uint64_t seed;
+		uint64_t worker;
+		uint64_t bound;
+		uint64_t iterations;
+	};
+
+	static_assert(sizeof(CoordinatorRequest) == 16, "unexpected coordinator request size");
+	static_assert(sizeof(CoordinatorResponse) == 56, "unexpected coordinator response size");
+
+	// Max number of words that can follow a coordinator request header.
+	constexpr size_t MAX_COORDINATOR_REQUEST_WORDS = 1 << 24;
+}
+
+#endif // COYOTE_SERVICE_PROTOCOL_H
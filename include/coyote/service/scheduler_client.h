@@ -0,0 +1,235 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_SCHEDULER_CLIENT_H
+#define COYOTE_SCHEDULER_CLIENT_H
+
+#ifndef _WIN32
+
+#include <string>
+#include <vector>
+#include "local_socket.h"
+#include "protocol.h"
+#include "../error_code.h"
+
+namespace coyote
+{
+	// Client of a scheduler that is served by a 'SchedulerServer' in another process. It mirrors the
+	// 'Scheduler' API. A blocking call holds the connection until the calling operation gets scheduled
+	// again, so each thread that runs a controlled operation must use its own client.
+	class SchedulerClient
+	{
+	private:
+		// The connected socket, or -1 if the client is not connected.
+		int fd;
+
+		// Buffer that holds the next request and its ids, so that both are sent in a single write.
+		std::vector<uint64_t> buffer;
+
+	public:
+		SchedulerClient() noexcept :
+			fd(-1)
+		{
+		}
+
+		SchedulerClient(SchedulerClient&& client) = delete;
+		SchedulerClient(SchedulerClient const&) = delete;
+
+		SchedulerClient& operator=(SchedulerClient&& client) = delete;
+		SchedulerClient& operator=(SchedulerClient const&) = delete;
+
+		~SchedulerClient()
+		{
+			disconnect();
+		}
+
+		// Connects to the scheduler service that listens on the specified socket path.
+		ErrorCode connect(const std::string& socket_path) noexcept
+		{
+			try
+			{
+				disconnect();
+				fd = local_socket::connect(socket_path);
+			}
+			catch (ErrorCode error_code)
+			{
+				return error_code;
+			}
+			catch (...)
+			{
+				return ErrorCode::Failure;
+			}
+
+			return ErrorCode::Success;
+		}
+
+		// Closes the connection to the scheduler service.
+		void disconnect() noexcept
+		{
+			if (fd >= 0)
+			{
+				::close(fd);
+				fd = -1;
+			}
+		}
+
+		ErrorCode attach() noexcept
+		{
+			return call(ServiceOpcode::Attach);
+		}
+
+		ErrorCode detach() noexcept
+		{
+			return call(ServiceOpcode::Detach);
+		}
+
+		ErrorCode create_operation(size_t operation_id) noexcept
+		{
+			return call(ServiceOpcode::CreateOperation, operation_id);
+		}
+
+		ErrorCode start_operation(size_t operation_id) noexcept
+		{
+			return call(ServiceOpcode::StartOperation, operation_id);
+		}
+
+		ErrorCode join_operation(size_t operation_id) noexcept
+		{
+			return call(ServiceOpcode::JoinOperation, operation_id);
+		}
+
+		ErrorCode join_operations(const size_t* operation_ids, size_t size, bool wait_all) noexcept
+		{
+			return call(ServiceOpcode::JoinOperations, 0, wait_all ? 1 : 0, operation_ids, size);
+		}
+
+		ErrorCode complete_operation(size_t operation_id) noexcept
+		{
+			return call(ServiceOpcode::CompleteOperation, operation_id);
+		}
+
+		ErrorCode create_resource(size_t resource_id) noexcept
+		{
+			return call(ServiceOpcode::CreateResource, resource_id);
+		}
+
+		ErrorCode wait_resource(size_t resource_id) noexcept
+		{
+			return call(ServiceOpcode::WaitResource, resource_id);
+		}
+
+		ErrorCode wait_resources(const size_t* resource_ids, size_t size, bool wait_all) noexcept
+		{
+			return call(ServiceOpcode::WaitResources, 0, wait_all ? 1 : 0, resource_ids, size);
+		}
+
+		ErrorCode signal_resource(size_t resource_id) noexcept
+		{
+			return call(ServiceOpcode::SignalResource, resource_id);
+		}
+
+		ErrorCode signal_resource(size_t resource_id, size_t operation_id) noexcept
+		{
+			return call(ServiceOpcode::SignalOperationResource, resource_id, operation_id);
+		}
+
+		ErrorCode delete_resource(size_t resource_id) noexcept
+		{
+			return call(ServiceOpcode::DeleteResource, resource_id);
+		}
+
+		ErrorCode schedule_next() noexcept
+		{
+			return call(ServiceOpcode::ScheduleNext);
+		}
+
+		bool next_boolean() noexcept
+		{
+			uint64_t value = 0;
+			call(ServiceOpcode::NextBoolean, 0, 0, nullptr, 0, &value);
+			return value != 0;
+		}
+
+		int next_integer(int max_value) noexcept
+		{
+			uint64_t value = 0;
+			call(ServiceOpcode::NextInteger, (uint64_t)max_value, 0, nullptr, 0, &value);
+			return (int)value;
+		}
+
+		size_t scheduled_operation_id() noexcept
+		{
+			uint64_t value = 0;
+			call(ServiceOpcode::ScheduledOperationId, 0, 0, nullptr, 0, &value);
+			return (size_t)value;
+		}
+
+		uint64_t random_seed() noexcept
+		{
+			uint64_t value = 0;
+			call(ServiceOpcode::RandomSeed, 0, 0, nullptr, 0, &value);
+			return value;
+		}
+
+		ErrorCode error_code() noexcept
+		{
+			return call(ServiceOpcode::LastErrorCode);
+		}
+
+	private:
+		ErrorCode call(ServiceOpcode opcode, uint64_t arg0 = 0, uint64_t arg1 = 0, const size_t* ids = nullptr,
+			size_t size = 0, uint64_t* value = nullptr) noexcept
+		{
+			try
+			{
+				if (fd < 0)
+				{
+					throw ErrorCode::ClientNotAttached;
+				}
+				else if (size > MAX_SERVICE_REQUEST_IDS)
+				{
+					throw ErrorCode::Failure;
+				}
+
+				// The header is exactly three words long, so it can share the buffer with the ids.
+				ServiceRequest request = { opcode, (uint32_t)size, arg0, arg1 };
+				buffer.resize(3 + size);
+				std::memcpy(buffer.data(), &request, sizeof(request));
+				for (size_t i = 0; i < size; i++)
+				{
+					buffer[3 + i] = (uint64_t)*(ids + i);
+				}
+
+				ServiceResponse response;
+				if (!local_socket::send_all(fd, buffer.data(), buffer.size() * sizeof(uint64_t)) ||
+					!local_socket::receive_all(fd, &response, sizeof(response)))
+				{
+					throw ErrorCode::Failure;
+				}
+				else if (response.reserved != 0)
+				{
+					throw ErrorCode::Failure;
+				}
+
+				if (value != nullptr)
+				{
+					*value = response.value;
+				}
+
+				return static_cast<ErrorCode>(response.error_code);
+			}
+			catch (ErrorCode error_code)
+			{
+				return error_code;
+			}
+			catch (...)
+			{
+				return ErrorCode::Failure;
+			}
+		}
+	};
+}
+
+#endif // _WIN32
+
+#endif // COYOTE_SCHEDULER_CLIENT_H
@@ -0,0 +1,246 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_SCHEDULER_SERVER_H
+#define COYOTE_SCHEDULER_SERVER_H
+
+#ifndef _WIN32
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include "connection_threads.h"
+#include "local_socket.h"
+#include "protocol.h"
+#include "../scheduler.h"
+
+namespace coyote
+{
+	// Serves a scheduler to operations that live in other processes on the same machine, through a
+	// Unix domain socket. Each client connection is served by its own thread, so that a blocking call
+	// only pauses the operation that issued it, exactly as it would if the operation was in-process.
+	class SchedulerServer
+	{
+	private:
+		// The served scheduler.
+		Scheduler* scheduler;
+
+		// The path of the listening socket.
+		const std::string socket_path;
+
+		// The listening socket, or -1 if the server is not running.
+		int listen_fd;
+
+		// Thread that accepts new client connections.
+		std::thread accept_thread;
+
+		// Threads that serve accepted client connections.
+		ConnectionThreads connections;
+
+		// True if the server is stopping, else false.
+		std::atomic<bool> is_stopping;
+
+	public:
+		SchedulerServer(Scheduler* scheduler, std::string socket_path) noexcept :
+			scheduler(scheduler),
+			socket_path(std::move(socket_path)),
+			listen_fd(-1),
+			is_stopping(false)
+		{
+		}
+
+		SchedulerServer(SchedulerServer&& server) = delete;
+		SchedulerServer(SchedulerServer const&) = delete;
+
+		SchedulerServer& operator=(SchedulerServer&& server) = delete;
+		SchedulerServer& operator=(SchedulerServer const&) = delete;
+
+		~SchedulerServer()
+		{
+			stop();
+		}
+
+		// Starts accepting client connections.
+		ErrorCode start() noexcept
+		{
+			try
+			{
+				if (listen_fd >= 0)
+				{
+					throw ErrorCode::Failure;
+				}
+
+				listen_fd = local_socket::listen(socket_path);
+				is_stopping = false;
+				accept_thread = std::thread(&SchedulerServer::accept_connections, this);
+			}
+			catch (ErrorCode error_code)
+			{
+				return error_code;
+			}
+			catch (...)
+			{
+				return ErrorCode::Failure;
+			}
+
+			return ErrorCode::Success;
+		}
+
+		// Stops accepting client connections and closes all accepted connections. The scheduler should be
+		// detached before stopping, so that any operations that are paused by remote calls get released.
+		void stop() noexcept
+		{
+			if (listen_fd < 0)
+			{
+				return;
+			}
+
+			is_stopping = true;
+			::shutdown(listen_fd, SHUT_RDWR);
+			if (accept_thread.joinable())
+			{
+				accept_thread.join();
+			}
+
+			::close(listen_fd);
+			listen_fd = -1;
+			connections.shutdown_all();
+			::unlink(socket_path.c_str());
+		}
+
+	private:
+		void accept_connections()
+		{
+			while (!is_stopping)
+			{
+				int fd = ::accept(listen_fd, nullptr, nullptr);
+				if (fd < 0)
+				{
+					if (errno == EINTR)
+					{
+						continue;
+					}
+
+					break;
+				}
+
+				connections.serve(fd, [this](int connection_fd) { serve_connection(connection_fd); });
+			}
+		}
+
+		void serve_connection(int fd)
+		{
+			ServiceRequest request;
+			std::vector<size_t> ids;
+			while (local_socket::receive_all(fd, &request, sizeof(request)))
+			{
+				if (request.count > MAX_SERVICE_REQUEST_IDS)
+				{
+					break;
+				}
+
+				ids.resize(request.count);
+				if (request.count > 0)
+				{
+					std::vector<uint64_t> buffer(request.count);
+					if (!local_socket::receive_all(fd, buffer.data(), buffer.size() * sizeof(uint64_t)))
+					{
+						break;
+					}
+
+					for (size_t i = 0; i < buffer.size(); i++)
+					{
+						ids[i] = (size_t)buffer[i];
+					}
+				}
+
+				ServiceResponse response = dispatch(request, ids);
+				if (!local_socket::send_all(fd, &response, sizeof(response)))
+				{
+					break;
+				}
+			}
+		}
+
+		ServiceResponse dispatch(const ServiceRequest& request, const std::vector<size_t>& ids)
+		{
+			ServiceResponse response = { 0, 0, 0 };
+			ErrorCode error_code = ErrorCode::Success;
+			size_t arg0 = (size_t)request.arg0;
+			switch (request.opcode)
+			{
+			case ServiceOpcode::Attach:
+				error_code = scheduler->attach();
+				break;
+			case ServiceOpcode::Detach:
+				error_code = scheduler->detach();
+				break;
+			case ServiceOpcode::CreateOperation:
+				error_code = scheduler->create_operation(arg0);
+				break;
+			case ServiceOpcode::StartOperation:
+				error_code = scheduler->start_operation(arg0);
+				break;
+			case ServiceOpcode::JoinOperation:
+				error_code = scheduler->join_operation(arg0);
+				break;
+			case ServiceOpcode::JoinOperations:
+				error_code = scheduler->join_operations(ids.data(), ids.size(), request.arg1 != 0);
+				break;
+			case ServiceOpcode::CompleteOperation:
+				error_code = scheduler->complete_operation(arg0);
+				break;
+			case ServiceOpcode::CreateResource:
+				error_code = scheduler->create_resource(arg0);
+				break;
+			case ServiceOpcode::WaitResource:
+				error_code = scheduler->wait_resource(arg0);
+				break;
+			case ServiceOpcode::WaitResources:
+				error_code = scheduler->wait_resources(ids.data(), ids.size(), request.arg1 != 0);
+				break;
+			case ServiceOpcode::SignalResource:
+				error_code = scheduler->signal_resource(arg0);
+				break;
+			case ServiceOpcode::SignalOperationResource:
+				error_code = scheduler->signal_resource(arg0, (size_t)request.arg1);
+				break;
+			case ServiceOpcode::DeleteResource:
+				error_code = scheduler->delete_resource(arg0);
+				break;
+			case ServiceOpcode::ScheduleNext:
+				error_code = scheduler->schedule_next();
+				break;
+			case ServiceOpcode::NextBoolean:
+				// The choice is not an error code, so the error of the call is read separately.
+				response.value = scheduler->next_boolean() ? 1 : 0;
+				error_code = scheduler->error_code();
+				break;
+			case ServiceOpcode::NextInteger:
+				response.value = (uint64_t)scheduler->next_integer((int)request.arg0);
+				error_code = scheduler->error_code();
+				break;
+			case ServiceOpcode::ScheduledOperationId:
+				response.value = scheduler->scheduled_operation_id();
+				break;
+			case ServiceOpcode::RandomSeed:
+				response.value = scheduler->random_seed();
+				break;
+			case ServiceOpcode::LastErrorCode:
+				error_code = scheduler->error_code();
+				break;
+			default:
+				error_code = ErrorCode::Failure;
+				break;
+			}
+
+			response.error_code = static_cast<std::underlying_type_t<ErrorCode>>(error_code);
+			return response;
+		}
+	};
+}
+
+#endif // _WIN32
+
+#endif // COYOTE_SCHEDULER_SERVER_H
@@ -6,10 +6,22 @@
 
 #include <chrono>
 #include <stdexcept>
+#include <string>
+#include <vector>
+#include "schedules/schedule_trace.h"
+#include "strategies/reproduction_token.h"
 #include "strategies/strategy_type.h"
 
 namespace coyote
 {
+	// A strategy of a portfolio, along with its bound and the relative share of iterations it receives.
+	struct PortfolioMember
+	{
+		StrategyType strategy;
+		size_t bound;
+		size_t weight;
+	};
+
 	class Settings
 	{
 	private:
@@ -22,10 +34,71 @@ namespace coyote
 		// The seed used by randomized strategies.
 		uint64_t seed_state;
 
+		// The worker of a parallel campaign that this scheduler runs, which selects its random streams.
+		uint64_t worker_index;
+
+		// The iteration of the campaign that the first testing iteration of the scheduler corresponds to.
+		uint64_t first_iteration_index;
+
+		// The schedule length that the strategy starts from, or '0' if it learns it from scratch.
+		uint64_t initial_schedule_length;
+
+		// The path of the file that scheduler events are traced to, or empty if tracing is disabled.
+		std::string trace_path;
+
+		// The max number of trace records that can be buffered before they are written to the file.
+		size_t trace_buffer_capacity;
+
+		// The path of the corpus that the schedule of each iteration is appended to, or empty if disabled.
+		std::string corpus_path;
+
+		// The path of the checkpoint that the campaign is saved to and resumed from, or empty if disabled.
+		std::string checkpoint_path;
+
+		// Number of iterations between two checkpoints.
+		size_t checkpoint_iterations;
+
+		// Number of last schedule steps before a failure that are hashed into its signature.
+		size_t failure_tail_steps;
+
+		// The schedule that is replayed by the replay strategy.
+		ScheduleTrace replay_trace;
+
+		// Max number of steps of an iteration that are scheduled by the strategy before a fair tail, or '0' if
+		// fair scheduling is disabled.
+		size_t max_unfair_steps;
+
+		// How the fair tail schedules operations.
+		FairSchedulingMode fair_mode;
+
+		// Max number of values that the Q-learning strategy learns.
+		size_t q_table_size;
+
+		// Max number of visited states that the DFS strategy remembers, or '0' if state caching is disabled.
+		size_t visited_states_size;
+
+		// The strategies of the portfolio and bandit strategies.
+		std::vector<PortfolioMember> portfolio;
+
+		// True if the scheduler checks that each call comes from the thread of the scheduled operation.
+		bool is_thread_validation_enabled;
+
 	public:
 		Settings() noexcept :
 			strategy_type(StrategyType::Random),
-			seed_state(std::chrono::high_resolution_clock::now().time_since_epoch().count())
+			strategy_bound(100),
+			seed_state(std::chrono::high_resolution_clock::now().time_since_epoch().count()),
+			worker_index(0),
+			first_iteration_index(1),
+			initial_schedule_length(0),
+			trace_buffer_capacity(0),
+			checkpoint_iterations(0),
+			failure_tail_steps(8),
+			max_unfair_steps(0),
+			fair_mode(FairSchedulingMode::RoundRobin),
+			q_table_size(1 << 18),
+			visited_states_size(0),
+			is_thread_validation_enabled(false)
 		{
 		}
 
@@ -40,6 +113,8 @@ namespace coyote
 		{
 			strategy_type = StrategyType::Random;
 			seed_state = seed;
+			first_iteration_index = 1;
+			initial_schedule_length = 0;
 			strategy_bound = 100;
 		}
 
@@ -53,6 +128,8 @@ namespace coyote
 
 			strategy_type = StrategyType::Random;
 			seed_state = seed;
+			first_iteration_index = 1;
+			initial_schedule_length = 0;
 			strategy_bound = probability;
 		}
 
@@ -61,15 +138,217 @@ namespace coyote
 		{
 			strategy_type = StrategyType::PCT;
 			seed_state = seed;
+			first_iteration_index = 1;
+			initial_schedule_length = 0;
 			strategy_bound = bound;
 		}
 
+		// Installs the replay exploration strategy, which replays the specified schedule in each iteration
+		// and uses the specified random seed for data choices.
+		void use_replay_strategy(const ScheduleTrace& schedule, uint64_t seed)
+		{
+			strategy_type = StrategyType::Replay;
+			seed_state = seed;
+			first_iteration_index = 1;
+			initial_schedule_length = 0;
+			replay_trace = schedule;
+		}
+
+		// Installs the strategy of the campaign that the specified token was taken from, so that the first
+		// testing iteration reproduces the iteration of the token. Replay tokens also need the replayed
+		// schedule, which must be installed with 'use_replay_strategy' first.
+		void reproduce(const ReproductionToken& token)
+		{
+			if (!token.is_reproducible())
+			{
+				throw std::invalid_argument("received a token of an iteration that cannot be reproduced directly");
+			}
+			else if (token.strategy == StrategyType::DFS && max_unfair_steps > 0)
+			{
+				throw std::invalid_argument("received the DFS strategy with fair scheduling");
+			}
+
+			strategy_type = token.strategy;
+			seed_state = token.seed;
+			worker_index = token.worker;
+			strategy_bound = (size_t)token.bound;
+			first_iteration_index = token.iteration;
+			initial_schedule_length = token.schedule_length;
+		}
+
+		// Installs the partial order sampling (POS) strategy with the specified random seed.
+		void use_pos_strategy(uint64_t seed) noexcept
+		{
+			strategy_type = StrategyType::POS;
+			seed_state = seed;
+			first_iteration_index = 1;
+			initial_schedule_length = 0;
+		}
+
+		// Installs the depth-first strategy, which enumerates the schedules of the test, including its data
+		// choices, one per iteration. The bound is the max number of choice points that are enumerated per
+		// iteration, or '0' if there is no bound. It cannot be combined with fair scheduling.
+		void use_dfs_strategy(size_t bound = 0)
+		{
+			if (max_unfair_steps > 0)
+			{
+				throw std::invalid_argument("received the DFS strategy with fair scheduling");
+			}
+
+			strategy_type = StrategyType::DFS;
+			seed_state = 0;
+			first_iteration_index = 1;
+			initial_schedule_length = 0;
+			strategy_bound = bound;
+		}
+
+		// Installs the Q-learning strategy with the specified random seed, probability in percent of choosing
+		// a random operation, and max number of learned values, which bounds its memory.
+		void use_qlearning_strategy(uint64_t seed, size_t probability = 10, size_t capacity = 1 << 18)
+		{
+			if (probability > 100)
+			{
+				throw std::invalid_argument("received probability greater than 100");
+			}
+
+			strategy_type = StrategyType::QLearning;
+			seed_state = seed;
+			strategy_bound = probability;
+			q_table_size = capacity;
+			first_iteration_index = 1;
+			initial_schedule_length = 0;
+		}
+
+		// Installs the portfolio strategy with the specified random seed, which assigns the iterations to the
+		// strategies that are added with 'add_portfolio_member'. If none are added, it uses a default
+		// portfolio of the random strategy and of PCT with several bounds.
+		void use_portfolio_strategy(uint64_t seed) noexcept
+		{
+			strategy_type = StrategyType::Portfolio;
+			seed_state = seed;
+			first_iteration_index = 1;
+			initial_schedule_length = 0;
+		}
+
+		// Installs the bandit strategy with the specified random seed, which picks the strategy of each
+		// iteration among those added with 'add_portfolio_member', favoring the strategies that found
+		// failures or new schedules. If none are added, it picks among the random strategy and PCT with
+		// several bounds each.
+		void use_bandit_strategy(uint64_t seed) noexcept
+		{
+			strategy_type = StrategyType::Bandit;
+			seed_state = seed;
+			first_iteration_index = 1;
+			initial_schedule_length = 0;
+		}
+
+		// Adds a strategy with the specified bound to the portfolio, which receives a share of the
+		// iterations that is proportional to the specified weight.
+		void add_portfolio_member(StrategyType strategy, size_t bound, size_t weight = 1)
+		{
+			if (strategy != StrategyType::Random && strategy != StrategyType::PCT)
+			{
+				throw std::invalid_argument("received a portfolio member that is not a random or PCT strategy");
+			}
+			else if (weight == 0)
+			{
+				throw std::invalid_argument("received a portfolio member with zero weight");
+			}
+			else if (strategy == StrategyType::Random && bound > 100)
+			{
+				throw std::invalid_argument("received probability greater than 100");
+			}
+
+			portfolio.push_back({ strategy, bound, weight });
+		}
+
+		// Schedules each iteration fairly, in the specified mode, once the strategy made the specified number
+		// of steps or completed the choices it planned for the iteration, so that tests with spin loops
+		// terminate in predictable time. This wraps any strategy except DFS, whose enumeration would record
+		// the choice points of the fair tail without them having any effect.
+		void enable_fair_scheduling(size_t max_steps, FairSchedulingMode mode = FairSchedulingMode::RoundRobin)
+		{
+			if (max_steps == 0)
+			{
+				throw std::invalid_argument("received zero max unfair steps");
+			}
+			else if (strategy_type == StrategyType::DFS)
+			{
+				throw std::invalid_argument("received the DFS strategy with fair scheduling");
+			}
+
+			max_unfair_steps = max_steps;
+			fair_mode = mode;
+		}
+
+		// Remembers up to the specified number of program states that the test reports with
+		// 'Scheduler::report_state_hash', so that the DFS strategy prunes the schedules that reach a visited
+		// state. Each state takes 4 bytes.
+		void enable_state_caching(size_t capacity = 1 << 20)
+		{
+			if (capacity == 0)
+			{
+				throw std::invalid_argument("received zero visited state capacity");
+			}
+
+			visited_states_size = capacity;
+		}
+
+		// Runs the specified worker of a parallel campaign, in which all workers use the same seed. Each
+		// worker draws its randomness from its own partition of the random sequence, which never overlaps
+		// with the partitions of other workers.
+		void use_worker(uint64_t index) noexcept
+		{
+			worker_index = index;
+		}
+
 		// Disables controlled scheduling.
 		void disable_scheduling() noexcept
 		{
 			strategy_type = StrategyType::None;
 		}
 
+		// Traces scheduler events to the specified file, buffering up to the specified number of records.
+		void enable_tracing(const std::string& path, size_t capacity = 65536)
+		{
+			trace_path = path;
+			trace_buffer_capacity = capacity;
+		}
+
+		// Appends the schedule of each testing iteration to the specified corpus file.
+		void record_schedules(const std::string& path)
+		{
+			corpus_path = path;
+		}
+
+		// Saves the state of the campaign to the specified checkpoint file every specified number of iterations,
+		// and resumes the campaign from it when the scheduler is created, if the file exists. The checkpoint
+		// only resumes a campaign with the same settings, so the seed must be chosen explicitly.
+		void enable_checkpoints(const std::string& path, size_t interval = 1000)
+		{
+			if (interval == 0)
+			{
+				throw std::invalid_argument("received zero checkpoint interval");
+			}
+
+			checkpoint_path = path;
+			checkpoint_iterations = interval;
+		}
+
+		// Hashes the specified number of last schedule steps before a failure into its signature. Fewer steps
+		// bucket more failures together, and '0' ignores the schedule entirely.
+		void set_failure_signature_steps(size_t steps) noexcept
+		{
+			failure_tail_steps = steps;
+		}
+
+		// Checks that each call to the scheduler comes from the thread that runs the currently scheduled
+		// operation, and fails the call with the 'UncontrolledThread' error code if it does not.
+		void enable_thread_validation() noexcept
+		{
+			is_thread_validation_enabled = true;
+		}
+
 		// Returns the type of the installed exploration strategy.
 		StrategyType exploration_strategy() noexcept
 		{
@@ -82,11 +361,107 @@ namespace coyote
 			return strategy_bound;
 		}
 
+		// Returns the schedule that is replayed by the replay strategy.
+		const ScheduleTrace& replay_schedule() noexcept
+		{
+			return replay_trace;
+		}
+
+		// Returns the max number of steps before the fair tail of an iteration, or '0' if it is disabled.
+		size_t fair_scheduling_steps() noexcept
+		{
+			return max_unfair_steps;
+		}
+
+		// Returns how the fair tail schedules operations.
+		FairSchedulingMode fair_scheduling_mode() noexcept
+		{
+			return fair_mode;
+		}
+
+		// Returns the max number of visited states that are remembered, or '0' if state caching is disabled.
+		size_t visited_state_capacity() noexcept
+		{
+			return visited_states_size;
+		}
+
+		// Returns the max number of values that the Q-learning strategy learns.
+		size_t q_table_capacity() noexcept
+		{
+			return q_table_size;
+		}
+
+		// Returns the strategies of the portfolio and bandit strategies.
+		const std::vector<PortfolioMember>& portfolio_members() noexcept
+		{
+			return portfolio;
+		}
+
 		// Returns the seed used by randomized strategies.
 		uint64_t random_seed() noexcept
 		{
 			return seed_state;
 		}
+
+		// Returns the worker of the campaign.
+		uint64_t worker() noexcept
+		{
+			return worker_index;
+		}
+
+		// Returns the iteration of the campaign that the first testing iteration corresponds to.
+		uint64_t first_iteration() noexcept
+		{
+			return first_iteration_index;
+		}
+
+		// Returns the schedule length that the strategy starts from.
+		uint64_t schedule_length_estimate() noexcept
+		{
+			return initial_schedule_length;
+		}
+
+		// Returns the path of the trace file, or an empty string if tracing is disabled.
+		const std::string& trace_file_path() noexcept
+		{
+			return trace_path;
+		}
+
+		// Returns the max number of trace records that can be buffered.
+		size_t trace_capacity() noexcept
+		{
+			return trace_buffer_capacity;
+		}
+
+		// Returns true if thread validation is enabled, else false.
+		bool thread_validation() noexcept
+		{
+			return is_thread_validation_enabled;
+		}
+
+		// Returns the path of the checkpoint file, or an empty string if checkpoints are disabled.
+		const std::string& checkpoint_file_path() noexcept
+		{
+			return checkpoint_path;
+		}
+
+		// Returns the number of iterations between two checkpoints.
+		size_t checkpoint_interval() noexcept
+		{
+			return checkpoint_iterations;
+		}
+
+		// Returns the number of last schedule steps that are hashed into the signature of a failure.
+		size_t failure_signature_steps() noexcept
+		{
+			return failure_tail_steps;
+		}
+
+		// Returns the path of the schedule corpus, or an empty string if schedules are not recorded.
+		const std::string& schedule_corpus_path() noexcept
+		{
+			return corpus_path;
+		}
 	};
 }
 
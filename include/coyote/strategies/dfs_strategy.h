@@ -0,0 +1,425 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_DFS_STRATEGY_H
+#define COYOTE_DFS_STRATEGY_H
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+#include "q_table.h"
+#include "strategy.h"
+#include "visited_states.h"
+#include "../settings.h"
+
+namespace coyote
+{
+	// A choice point of a path of the DFS strategy.
+	struct ChoicePoint
+	{
+		// Number of alternatives.
+		size_t count;
+
+		// The index of the chosen alternative.
+		size_t index;
+
+		// The index after the last alternative that is enumerated, which is lower than the count if the other
+		// alternatives were given to another worker.
+		size_t limit;
+	};
+
+	// Enumerates the schedules of a test depth-first, one schedule per iteration, so that small spaces of
+	// interleavings and of data choices are covered exhaustively instead of by chance. Each step with more
+	// than one enabled operation, each boolean choice and each integer choice is a choice point. The first
+	// schedule keeps running the current operation and chooses 'false' and '0', and each next iteration
+	// takes the next alternative of the deepest choice point that has one left.
+	//
+	// The bound is the max number of choice points that are enumerated per iteration, or '0' if there is
+	// no bound. Past the bound, the current operation keeps running if it is enabled, else the enabled
+	// operation with the lowest id is scheduled, and data choices are 'false' and '0'. Enumeration
+	// assumes that the test is deterministic for a given schedule. The order of the schedules only depends
+	// on the test, so the reproduction token only reproduces the first iteration, and the other iterations
+	// can be replayed from their recorded schedules.
+	//
+	// If state caching is enabled, the strategy remembers the states that the test reports with
+	// 'report_state_hash', together with the enabled operations and the current operation. Once an
+	// iteration reaches a state that was visited before, everything that follows was already explored, so
+	// the rest of the iteration is scheduled without choice points, as past the bound. States are only
+	// looked up after the choice point where the iteration diverges from the previous one, as the states
+	// before it are visited again by design.
+	//
+	// The strategy can also enumerate only the subtree of the schedules that start with a prefix of choices,
+	// and give part of its remaining subtree to another worker, which is how 'ParallelExplorer' spreads the
+	// enumeration across threads.
+	class DFSStrategy : public Strategy
+	{
+	private:
+		// The choice points of the current path, from the first to the deepest.
+		std::vector<ChoicePoint> path;
+
+		// The prefix that all enumerated paths start with. Its last choice point, if any, enumerates its
+		// alternatives from its index up to its limit, and the choice points before it are fixed.
+		std::vector<ChoicePoint> root;
+
+		// Number of choice points reached in the current iteration.
+		size_t depth;
+
+		// Max number of choice points per iteration, or '0' if there is no bound.
+		const size_t max_depth;
+
+		// The iteration of the campaign, starting at '1'.
+		uint64_t iteration_index;
+
+		// Number of times that all schedules were enumerated.
+		size_t completed_enumerations;
+
+		// True if the path of the current iteration was backtracked, else false.
+		bool is_backtracked;
+
+		// The alternatives of the current operation choice.
+		std::vector<size_t> alternatives;
+
+		// The visited states, if state caching is enabled.
+		std::unique_ptr<VisitedStates> visited_states;
+
+		// Number of choice points of the current iteration that replay the previous iteration.
+		size_t replayed_depth;
+
+		// The state hash that the test reported since the last operation choice, if it reported one.
+		uint64_t reported_state_hash;
+		bool has_reported_state;
+
+		// True if the current iteration reached a visited state, else false.
+		bool is_pruned;
+
+		// Number of iterations that reached a visited state.
+		size_t pruned_count;
+
+	public:
+		DFSStrategy(Settings* settings) noexcept :
+			depth(0),
+			max_depth(settings->exploration_strategy_bound()),
+			iteration_index(settings->first_iteration()),
+			completed_enumerations(0),
+			is_backtracked(false),
+			visited_states(settings->visited_state_capacity() > 0 ?
+				std::make_unique<VisitedStates>(settings->visited_state_capacity()) : nullptr),
+			replayed_depth(0),
+			reported_state_hash(0),
+			has_reported_state(false),
+			is_pruned(false),
+			pruned_count(0)
+		{
+		}
+
+		DFSStrategy(DFSStrategy&& strategy) = delete;
+		DFSStrategy(DFSStrategy const&) = delete;
+
+		DFSStrategy& operator=(DFSStrategy&& strategy) = delete;
+		DFSStrategy& operator=(DFSStrategy const&) = delete;
+
+		// Returns the next operation. The alternatives are the current operation, if it is enabled, followed
+		// by the other enabled operations in the order of their ids.
+		size_t next_operation(Operations& operations, size_t current)
+		{
+			bool is_current_enabled = false;
+			alternatives.clear();
+			for (size_t idx = 0; idx < operations.size(); idx++)
+			{
+				if (operations[idx] == current)
+				{
+					is_current_enabled = true;
+				}
+				else
+				{
+					alternatives.push_back(operations[idx]);
+				}
+			}
+
+			std::sort(alternatives.begin(), alternatives.end());
+			if (is_current_enabled)
+			{
+				alternatives.insert(alternatives.begin(), current);
+			}
+
+			if (has_reported_state)
+			{
+				visit_state(is_current_enabled);
+			}
+
+			return alternatives.size() == 1 ? alternatives[0] : alternatives[next_choice(alternatives.size())];
+		}
+
+		// Returns the next boolean choice.
+		bool next_boolean()
+		{
+			return next_choice(2) == 1;
+		}
+
+		// Returns the next integer choice.
+		int next_integer(int max_value)
+		{
+			return max_value <= 1 ? 0 : (int)next_choice((size_t)max_value);
+		}
+
+		// Returns '0', as the enumeration does not use randomness.
+		uint64_t random_seed()
+		{
+			return 0;
+		}
+
+		// Returns a token that reproduces the current iteration, if it is the first one.
+		ReproductionToken reproduction_token()
+		{
+			return { StrategyType::DFS, 0, 0, iteration_index, 0, max_depth };
+		}
+
+		// Prepares the next iteration, which takes the next alternative of the deepest choice point that has
+		// one left. Once all schedules are enumerated, the enumeration starts again.
+		void prepare_next_iteration(size_t /*iteration*/)
+		{
+			iteration_index++;
+			if (!is_backtracked)
+			{
+				backtrack();
+			}
+
+			start_path();
+		}
+
+		// Enumerates from the next iteration only the schedules that start with the specified prefix, whose
+		// last choice point, if any, enumerates its alternatives from its index up to its limit. The number of
+		// enumerations starts again at '0'.
+		void enumerate_subtree(const std::vector<ChoicePoint>& prefix)
+		{
+			root = prefix;
+			path = prefix;
+			completed_enumerations = 0;
+			start_path();
+			is_backtracked = true;
+		}
+
+		// Gives the upper half of the alternatives that are left at the shallowest choice point of the
+		// remaining subtree, writing the prefix of the given subtree. This must be called between iterations
+		// of an enumeration that is not complete. Returns false if there is no alternative to give, else true.
+		bool split(std::vector<ChoicePoint>& prefix)
+		{
+			size_t start = root.empty() ? 0 : root.size() - 1;
+			for (size_t d = start; d < path.size(); d++)
+			{
+				// The alternative at the index is being enumerated or is the next one, so it is kept.
+				if (path[d].limit > path[d].index + 1)
+				{
+					size_t middle = path[d].index + 1 + (path[d].limit - path[d].index - 1) / 2;
+					prefix.assign(path.begin(), path.begin() + d + 1);
+					prefix[d].index = middle;
+					path[d].limit = middle;
+					return true;
+				}
+			}
+
+			return false;
+		}
+
+		// Backtracks the path of the completed iteration, so that the enumeration is known to be complete as
+		// soon as its last schedule completes.
+		void complete_iteration(const IterationOutcome& /*outcome*/)
+		{
+			backtrack();
+		}
+
+		// Remembers the specified hash of the program state, which identifies the state at the next operation
+		// choice, if state caching is enabled.
+		void report_state_hash(uint64_t hash)
+		{
+			reported_state_hash = hash;
+			has_reported_state = visited_states != nullptr;
+		}
+
+		// Returns true if the iteration reached the bound or a visited state, after which no more alternatives
+		// are enumerated.
+		bool has_completed_prefix()
+		{
+			return is_pruned || (max_depth > 0 && depth >= max_depth);
+		}
+
+		// Writes the path that the next iteration backtracks from, the root of the enumerated subtree, the
+		// number of enumerations and the visited states.
+		void save_state(StrategyStateWriter& writer)
+		{
+			writer.write(iteration_index);
+			writer.write(completed_enumerations);
+			writer.write(pruned_count);
+			writer.write(depth);
+			writer.write_bool(is_backtracked);
+			save_path(writer, root);
+			save_path(writer, path);
+			writer.write_bool(visited_states != nullptr);
+			if (visited_states != nullptr)
+			{
+				visited_states->save(writer);
+			}
+		}
+
+		// Restores the state that was written by 'save_state', which must have the same state caching.
+		void restore_state(StrategyStateReader& reader)
+		{
+			iteration_index = reader.read();
+			completed_enumerations = (size_t)reader.read();
+			pruned_count = (size_t)reader.read();
+			depth = (size_t)reader.read();
+			is_backtracked = reader.read_bool();
+			restore_path(reader, root);
+			restore_path(reader, path);
+			if (reader.read_bool() != (visited_states != nullptr))
+			{
+				throw ErrorCode::InvalidCheckpoint;
+			}
+			else if (visited_states != nullptr)
+			{
+				visited_states->restore(reader);
+			}
+
+			replayed_depth = path.size();
+			has_reported_state = false;
+			is_pruned = false;
+		}
+
+		// Returns the number of iterations that reached a visited state.
+		size_t pruned_iterations() const noexcept
+		{
+			return pruned_count;
+		}
+
+		// Returns the number of visited states that are remembered, if state caching is enabled.
+		size_t visited_state_count() const noexcept
+		{
+			return visited_states != nullptr ? visited_states->size() : 0;
+		}
+
+		// Returns the number of times that all schedules were enumerated, which is '1' once the last schedule
+		// completed.
+		size_t enumerations() const noexcept
+		{
+			return completed_enumerations;
+		}
+
+	private:
+		// Removes the choice points that have no alternative left from the end of the path, and takes the next
+		// alternative of the deepest one. Once the subtree is enumerated, the path starts again at its root.
+		void backtrack()
+		{
+			// Choice points past the depth were not reached, because the test took another path.
+			size_t fixed_depth = root.empty() ? 0 : root.size() - 1;
+			path.resize(std::min(path.size(), depth));
+			while (path.size() > fixed_depth && path.back().index + 1 >= path.back().limit)
+			{
+				path.pop_back();
+			}
+
+			if (path.size() <= fixed_depth)
+			{
+				completed_enumerations++;
+				path = root;
+				if (visited_states != nullptr)
+				{
+					visited_states->clear();
+				}
+			}
+			else
+			{
+				path.back().index++;
+			}
+
+			is_backtracked = true;
+		}
+
+		// Starts the current path, whose choice points before the last one replay the previous iteration.
+		void start_path()
+		{
+			depth = 0;
+			replayed_depth = path.size();
+			has_reported_state = false;
+			is_pruned = false;
+			is_backtracked = false;
+		}
+
+		static void save_path(StrategyStateWriter& writer, const std::vector<ChoicePoint>& choices)
+		{
+			writer.write(choices.size());
+			for (const ChoicePoint& choice : choices)
+			{
+				writer.write(choice.count);
+				writer.write(choice.limit);
+				writer.write(choice.index);
+			}
+		}
+
+		static void restore_path(StrategyStateReader& reader, std::vector<ChoicePoint>& choices)
+		{
+			choices.resize(reader.read_count());
+			for (ChoicePoint& choice : choices)
+			{
+				choice.count = (size_t)reader.read();
+				choice.limit = (size_t)reader.read(choice.count);
+				if (choice.limit == 0)
+				{
+					throw ErrorCode::InvalidCheckpoint;
+				}
+
+				choice.index = (size_t)reader.read(choice.limit - 1);
+			}
+		}
+
+		// Adds the reported state at the current operation choice to the visited states, and prunes the rest
+		// of the iteration if it was visited before. The state also depends on the enabled operations, which
+		// are combined in an order independent way, and on the current operation.
+		void visit_state(bool is_current_enabled)
+		{
+			has_reported_state = false;
+			if (is_pruned || depth < replayed_depth)
+			{
+				return;
+			}
+
+			uint64_t enabled_hash = 0;
+			for (size_t op : alternatives)
+			{
+				enabled_hash += QTable::mix(op + 1);
+			}
+
+			uint64_t current = is_current_enabled ? alternatives[0] + 1 : 0;
+			if (!visited_states->insert(QTable::mix(reported_state_hash ^ QTable::mix(enabled_hash ^ current))))
+			{
+				is_pruned = true;
+				pruned_count++;
+			}
+		}
+
+		// Returns the chosen alternative of the next choice point of the path, which has the specified number
+		// of alternatives.
+		size_t next_choice(size_t count)
+		{
+			if (is_pruned || (max_depth > 0 && depth >= max_depth))
+			{
+				return 0;
+			}
+
+			if (depth == path.size())
+			{
+				path.push_back({ count, 0, count });
+			}
+			else if (path[depth].count != count)
+			{
+				// The test is not deterministic, so the rest of the path is enumerated again.
+				size_t limit = std::min(path[depth].limit, count);
+				path[depth] = { count, std::min(path[depth].index, limit - 1), limit };
+				path.resize(depth + 1);
+			}
+
+			return path[depth++].index;
+		}
+	};
+}
+
+#endif // COYOTE_DFS_STRATEGY_H
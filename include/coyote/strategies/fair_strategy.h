@@ -0,0 +1,194 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_FAIR_STRATEGY_H
+#define COYOTE_FAIR_STRATEGY_H
+
+#include <memory>
+#include "random.h"
+#include "strategy.h"
+#include "../settings.h"
+
+namespace coyote
+{
+	// Wraps a strategy, such as PCT, that can starve an enabled operation, so that tests whose operations
+	// spin until another operation makes progress still terminate. Each iteration is scheduled by the
+	// wrapped strategy until it made the max number of unfair steps, or completed the choices it planned
+	// for the iteration, after which the rest of the iteration is scheduled fairly, either round-robin by
+	// operation id or uniformly at random.
+	//
+	// The wrapped strategy is still asked for each step of the fair tail, so that its state evolves the
+	// same way with and without the wrapper, and the iteration is reproduced by its token together with
+	// the same fair scheduling settings.
+	class FairStrategy : public Strategy
+	{
+	private:
+		// The wrapped strategy.
+		std::unique_ptr<Strategy> strategy;
+
+		// The pseudo-random generator of the random fair tail.
+		Random generator;
+
+		// Max number of steps of an iteration that are scheduled by the wrapped strategy.
+		const size_t max_unfair_steps;
+
+		// How the fair tail schedules operations.
+		const FairSchedulingMode mode;
+
+		// Number of steps scheduled in the current iteration.
+		size_t scheduled_steps;
+
+		// True if the current iteration reached its fair tail, else false.
+		bool is_fair;
+
+	public:
+		FairStrategy(Settings* settings, std::unique_ptr<Strategy> wrapped_strategy) noexcept :
+			strategy(std::move(wrapped_strategy)),
+			generator(settings->random_seed()),
+			max_unfair_steps(settings->fair_scheduling_steps()),
+			mode(settings->fair_scheduling_mode()),
+			scheduled_steps(0),
+			is_fair(false)
+		{
+			seed_generator();
+		}
+
+		FairStrategy(FairStrategy&& strategy) = delete;
+		FairStrategy(FairStrategy const&) = delete;
+
+		FairStrategy& operator=(FairStrategy&& strategy) = delete;
+		FairStrategy& operator=(FairStrategy const&) = delete;
+
+		// Returns the next operation.
+		size_t next_operation(Operations& operations, size_t current)
+		{
+			size_t next_op = strategy->next_operation(operations, current);
+			if (!is_fair)
+			{
+				scheduled_steps++;
+				is_fair = scheduled_steps > max_unfair_steps || strategy->has_completed_prefix();
+			}
+
+			if (is_fair)
+			{
+				next_op = mode == FairSchedulingMode::Random ?
+					operations[generator.next() % operations.size()] :
+					next_round_robin(operations, current);
+			}
+
+			return next_op;
+		}
+
+		// Returns the next boolean choice.
+		bool next_boolean()
+		{
+			return strategy->next_boolean();
+		}
+
+		// Returns the next integer choice.
+		int next_integer(int max_value)
+		{
+			return strategy->next_integer(max_value);
+		}
+
+		// Returns the seed used by the wrapped strategy.
+		uint64_t random_seed()
+		{
+			return strategy->random_seed();
+		}
+
+		// Returns the token of the wrapped strategy.
+		ReproductionToken reproduction_token()
+		{
+			return strategy->reproduction_token();
+		}
+
+		// Prepares the next iteration.
+		void prepare_next_iteration(size_t iteration)
+		{
+			strategy->prepare_next_iteration(iteration);
+			scheduled_steps = 0;
+			is_fair = false;
+			seed_generator();
+		}
+
+		// Returns true if the current iteration reached its fair tail.
+		bool has_completed_prefix()
+		{
+			return is_fair;
+		}
+
+		// Forwards the resource access to the wrapped strategy.
+		void resource_accessed(size_t operation_id, size_t resource_id)
+		{
+			strategy->resource_accessed(operation_id, resource_id);
+		}
+
+		// Forwards the reported state hash to the wrapped strategy.
+		void report_state_hash(uint64_t hash)
+		{
+			strategy->report_state_hash(hash);
+		}
+
+		// Forwards the outcome of the iteration to the wrapped strategy.
+		void complete_iteration(const IterationOutcome& outcome)
+		{
+			strategy->complete_iteration(outcome);
+		}
+
+		// Writes the state of the wrapped strategy, as the fair tail starts again in each iteration.
+		void save_state(StrategyStateWriter& writer)
+		{
+			strategy->save_state(writer);
+		}
+
+		// Restores the state of the wrapped strategy.
+		void restore_state(StrategyStateReader& reader)
+		{
+			strategy->restore_state(reader);
+		}
+
+		// Returns the wrapped strategy.
+		Strategy& wrapped_strategy() noexcept
+		{
+			return *strategy;
+		}
+
+	private:
+		// Returns the enabled operation with the lowest id that is higher than the id of the current
+		// operation, or else the enabled operation with the lowest id, so that each enabled operation is
+		// scheduled at least once every as many steps as there are enabled operations.
+		static size_t next_round_robin(Operations& operations, size_t current)
+		{
+			size_t next_op = operations[0];
+			size_t lowest_op = operations[0];
+			bool is_found = false;
+			for (size_t idx = 0; idx < operations.size(); idx++)
+			{
+				size_t op = operations[idx];
+				if (op < lowest_op)
+				{
+					lowest_op = op;
+				}
+
+				if (op > current && (!is_found || op < next_op))
+				{
+					next_op = op;
+					is_found = true;
+				}
+			}
+
+			return is_found ? next_op : lowest_op;
+		}
+
+		// Seeds the generator of the random fair tail from the iteration of the wrapped strategy, in a
+		// sequence that differs from the one of the wrapped strategy.
+		void seed_generator()
+		{
+			ReproductionToken token = strategy->reproduction_token();
+			generator.seed(~token.seed, token.worker, token.iteration);
+		}
+	};
+}
+
+#endif // COYOTE_FAIR_STRATEGY_H
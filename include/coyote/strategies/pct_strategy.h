@@ -21,8 +21,17 @@ namespace coyote
 		// The pseudo-random generator.
 		Random generator;
 
-		// The seed used by the current iteration.
-		uint64_t iteration_seed;
+		// The seed of the campaign, which is used by all iterations.
+		uint64_t campaign_seed;
+
+		// The worker of the campaign.
+		uint64_t worker;
+
+		// The iteration of the campaign that the first testing iteration corresponds to.
+		uint64_t first_iteration;
+
+		// The iteration of the campaign, starting at '1'.
+		uint64_t iteration_index;
 
 		// Max number of priority switches during one iteration.
 		size_t max_priority_switches;
@@ -42,14 +51,22 @@ namespace coyote
 		// Approximate length of the schedule across all iterations.
 		size_t schedule_length;
 
+		// The schedule length that the priority change points of the current iteration were chosen from.
+		size_t iteration_schedule_length;
+
 	public:
 		PCTStrategy(Settings* settings) noexcept :
 			generator(settings->random_seed()),
-			iteration_seed(settings->random_seed()),
+			campaign_seed(settings->random_seed()),
+			worker(settings->worker()),
+			first_iteration(settings->first_iteration()),
+			iteration_index(settings->first_iteration()),
 			max_priority_switches(settings->exploration_strategy_bound()),
 			scheduled_steps(0),
-			schedule_length(0)
+			schedule_length((size_t)settings->schedule_length_estimate()),
+			iteration_schedule_length(0)
 		{
+			start_iteration(first_iteration);
 		}
 
 		PCTStrategy(PCTStrategy&& strategy) = delete;
@@ -71,48 +88,94 @@ namespace coyote
 		// Returns the next boolean choice.
 		bool next_boolean()
 		{
-			scheduled_steps++;
 			return generator.next() & 1;
 		}
 
 		// Returns the next integer choice.
 		int next_integer(int max_value)
 		{
-			scheduled_steps++;
 			return generator.next() % max_value;
 		}
 
-		// Returns the seed used in the current iteration.
+		// Returns the seed used in the current iteration, which is the seed of the campaign.
 		uint64_t random_seed()
 		{
-			return iteration_seed;
+			return campaign_seed;
+		}
+
+		// Returns a token that reproduces the current iteration. Each iteration uses its own stream of the
+		// random sequence of the campaign seed, so the token only has to carry the schedule length that was
+		// learned from the earlier iterations.
+		ReproductionToken reproduction_token()
+		{
+			return { StrategyType::PCT, campaign_seed, worker, iteration_index, iteration_schedule_length,
+				max_priority_switches };
 		}
 
 		// Prepares the next iteration.
 		void prepare_next_iteration(size_t iteration)
 		{
-			// The first iteration has no knowledge of the execution, so only initialize from the second
-			// iteration and onwards. Note that although we could initialize the first length based on a
-			// heuristic, its not worth it, as the strategy will typically explore thousands of iterations,
-			// plus its also interesting to explore a schedule with no forced priority change points.
-			if (iteration > 1)
+			if (schedule_length < scheduled_steps)
 			{
-				if (schedule_length < scheduled_steps)
-				{
-					schedule_length = scheduled_steps;
-				}
+				schedule_length = scheduled_steps;
+			}
 
-				scheduled_steps = 0;
+			start_iteration(first_iteration + iteration - 1);
+		}
 
-				prioritized_operations.clear();
-				known_operations.clear();
-				priority_change_points.clear();
+		// Returns true if the iteration passed its last priority change point and the estimated schedule
+		// length, after which the strategy keeps running the operation with the highest priority.
+		bool has_completed_prefix()
+		{
+			size_t last_change_point = priority_change_points.empty() ? 0 : *priority_change_points.rbegin();
+			return scheduled_steps > last_change_point && scheduled_steps >= schedule_length;
+		}
 
+		// Writes the iteration, the random state and the learned schedule length, including the steps of the
+		// completed iteration that the next iteration learns from.
+		void save_state(StrategyStateWriter& writer)
+		{
+			writer.write(iteration_index);
+			writer.write_random(generator);
+			writer.write(scheduled_steps);
+			writer.write(schedule_length);
+			writer.write(iteration_schedule_length);
+		}
+
+		// Restores the iteration, the random state and the learned schedule length.
+		void restore_state(StrategyStateReader& reader)
+		{
+			iteration_index = reader.read();
+			reader.read_random(generator);
+			scheduled_steps = (size_t)reader.read();
+			schedule_length = (size_t)reader.read();
+			iteration_schedule_length = (size_t)reader.read();
+		}
+
+	private:
+		// Starts the specified iteration of the campaign, positioning the generator at the stream of the
+		// iteration in the partition of the worker.
+		void start_iteration(uint64_t iteration)
+		{
+			iteration_index = iteration;
+			generator.seed(campaign_seed, worker, iteration);
+			iteration_schedule_length = schedule_length;
+			scheduled_steps = 0;
+
+			prioritized_operations.clear();
+			known_operations.clear();
+			priority_change_points.clear();
+
+			// The first iteration has no knowledge of the execution, so only choose priority change points
+			// from the second iteration and onwards. Note that although we could initialize the first length
+			// based on a heuristic, its not worth it, as the strategy will typically explore thousands of
+			// iterations, plus its also interesting to explore a schedule with no forced priority change points.
+			if (iteration > 1)
+			{
 				shuffle_priority_change_points();
 			}
 		}
 
-	private:
 		// Sets the priority of new operations, if there are any.
 		void set_new_operation_priorities(Operations& operations, size_t current)
 		{
@@ -0,0 +1,364 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_PORTFOLIO_STRATEGY_H
+#define COYOTE_PORTFOLIO_STRATEGY_H
+
+#include <cmath>
+#include <memory>
+#include <unordered_set>
+#include <vector>
+#include "pct_strategy.h"
+#include "random_strategy.h"
+#include "strategy.h"
+#include "../settings.h"
+
+namespace coyote
+{
+	// Statistics of a strategy of a portfolio.
+	struct PortfolioStatistics
+	{
+		// The strategy and its bound.
+		PortfolioMember member;
+
+		// Number of iterations that the strategy ran.
+		size_t iterations;
+
+		// Number of iterations of the strategy that found a failure.
+		size_t failures;
+
+		// Number of iterations of the strategy that explored a schedule that no strategy had explored before.
+		size_t new_schedules;
+
+		// The iteration of the portfolio in which the strategy found its first failure, or '0' if it did not.
+		size_t first_failure_iteration;
+
+		// Number of iterations of the strategy that found a failure or a new schedule, which is the reward
+		// of the bandit strategy.
+		size_t rewarded_iterations;
+	};
+
+	// Interleaves several strategies across iterations, so that each campaign gets the best time to bug of
+	// its strategies without tuning by hand. The iterations are assigned by smooth weighted round-robin,
+	// which is deterministic, so an iteration always runs on the same strategy. Each strategy draws its
+	// randomness from its own partition of the random sequence of the seed.
+	//
+	// As the bandit strategy, the portfolio instead treats each strategy as an arm of a multi-armed bandit
+	// and picks the arm of each iteration by UCB1. An iteration is rewarded if it finds a failure or a new
+	// schedule, so long campaigns converge on the most productive strategy and bound, while still trying
+	// the others from time to time. The weights are ignored.
+	class PortfolioStrategy : public Strategy
+	{
+	private:
+		// The settings of each strategy, which must outlive it.
+		std::vector<std::unique_ptr<Settings>> member_settings;
+
+		// The strategies of the portfolio.
+		std::vector<std::unique_ptr<Strategy>> members;
+
+		// Statistics of each strategy.
+		std::vector<PortfolioStatistics> member_statistics;
+
+		// The current weight of each strategy in the smooth weighted round-robin.
+		std::vector<int64_t> current_weights;
+
+		// Number of iterations that each strategy was selected for.
+		std::vector<size_t> member_iterations;
+
+		// Sum of the weights of all strategies.
+		int64_t total_weight;
+
+		// The index of the strategy that runs the current iteration.
+		size_t current_member;
+
+		// The iteration of the portfolio, starting at '1'.
+		size_t iteration_index;
+
+		// Hashes of all schedules explored so far.
+		std::unordered_set<uint64_t> schedule_hashes;
+
+		// True if the strategies are picked by UCB1 instead of round-robin, else false.
+		const bool is_adaptive;
+
+	public:
+		PortfolioStrategy(Settings* settings) :
+			total_weight(0),
+			current_member(0),
+			iteration_index(1),
+			is_adaptive(settings->exploration_strategy() == StrategyType::Bandit)
+		{
+			std::vector<PortfolioMember> portfolio = settings->portfolio_members();
+			if (portfolio.empty() && is_adaptive)
+			{
+				portfolio = {
+					{ StrategyType::Random, 100, 1 },
+					{ StrategyType::Random, 50, 1 },
+					{ StrategyType::Random, 10, 1 },
+					{ StrategyType::PCT, 1, 1 },
+					{ StrategyType::PCT, 2, 1 },
+					{ StrategyType::PCT, 3, 1 },
+					{ StrategyType::PCT, 5, 1 },
+					{ StrategyType::PCT, 10, 1 }
+				};
+			}
+			else if (portfolio.empty())
+			{
+				portfolio = {
+					{ StrategyType::Random, 100, 1 },
+					{ StrategyType::Random, 10, 1 },
+					{ StrategyType::PCT, 1, 1 },
+					{ StrategyType::PCT, 3, 1 },
+					{ StrategyType::PCT, 10, 1 }
+				};
+			}
+
+			for (size_t i = 0; i < portfolio.size(); i++)
+			{
+				auto member = std::make_unique<Settings>();
+				member->use_worker(settings->worker() * portfolio.size() + i);
+				if (portfolio[i].strategy == StrategyType::PCT)
+				{
+					member->use_pct_strategy(settings->random_seed(), portfolio[i].bound);
+					members.push_back(std::make_unique<PCTStrategy>(member.get()));
+				}
+				else
+				{
+					member->use_random_strategy(settings->random_seed(), portfolio[i].bound);
+					members.push_back(std::make_unique<RandomStrategy>(member.get()));
+				}
+
+				member_settings.push_back(std::move(member));
+				member_statistics.push_back({ portfolio[i], 0, 0, 0, 0, 0 });
+				current_weights.push_back(0);
+				member_iterations.push_back(0);
+				total_weight += (int64_t)portfolio[i].weight;
+			}
+
+			select_next_member();
+		}
+
+		PortfolioStrategy(PortfolioStrategy&& strategy) = delete;
+		PortfolioStrategy(PortfolioStrategy const&) = delete;
+
+		PortfolioStrategy& operator=(PortfolioStrategy&& strategy) = delete;
+		PortfolioStrategy& operator=(PortfolioStrategy const&) = delete;
+
+		// Returns the next operation.
+		size_t next_operation(Operations& operations, size_t current)
+		{
+			return members[current_member]->next_operation(operations, current);
+		}
+
+		// Returns the next boolean choice.
+		bool next_boolean()
+		{
+			return members[current_member]->next_boolean();
+		}
+
+		// Returns the next integer choice.
+		int next_integer(int max_value)
+		{
+			return members[current_member]->next_integer(max_value);
+		}
+
+		// Returns the seed used in the current iteration by the current strategy.
+		uint64_t random_seed()
+		{
+			return members[current_member]->random_seed();
+		}
+
+		// Returns a token that reproduces the current iteration with the current strategy alone.
+		ReproductionToken reproduction_token()
+		{
+			return members[current_member]->reproduction_token();
+		}
+
+		// Prepares the next iteration, which runs on the next strategy of the round-robin.
+		void prepare_next_iteration(size_t iteration)
+		{
+			iteration_index = iteration;
+			select_next_member();
+		}
+
+		// Returns true if the current strategy completed the choices it planned for the iteration.
+		bool has_completed_prefix()
+		{
+			return members[current_member]->has_completed_prefix();
+		}
+
+		// Forwards the resource access to the current strategy.
+		void resource_accessed(size_t operation_id, size_t resource_id)
+		{
+			members[current_member]->resource_accessed(operation_id, resource_id);
+		}
+
+		// Forwards the reported state hash to the current strategy.
+		void report_state_hash(uint64_t hash)
+		{
+			members[current_member]->report_state_hash(hash);
+		}
+
+		// Updates the statistics of the current strategy with the outcome of its iteration.
+		void complete_iteration(const IterationOutcome& outcome)
+		{
+			PortfolioStatistics& statistics = member_statistics[current_member];
+			statistics.iterations++;
+			if (outcome.failure != 0)
+			{
+				statistics.failures++;
+				if (statistics.first_failure_iteration == 0)
+				{
+					statistics.first_failure_iteration = iteration_index;
+				}
+			}
+
+			bool is_new_schedule = schedule_hashes.insert(outcome.schedule_hash).second;
+			if (is_new_schedule)
+			{
+				statistics.new_schedules++;
+			}
+
+			if (is_new_schedule || outcome.failure != 0)
+			{
+				statistics.rewarded_iterations++;
+			}
+
+			members[current_member]->complete_iteration(outcome);
+		}
+
+		// Writes the state of each strategy, the statistics that the bandit learns from, the position of the
+		// round-robin and the hashes of the explored schedules.
+		void save_state(StrategyStateWriter& writer)
+		{
+			writer.write(iteration_index);
+			writer.write(current_member);
+			writer.write(members.size());
+			for (size_t i = 0; i < members.size(); i++)
+			{
+				const PortfolioStatistics& statistics = member_statistics[i];
+				writer.write(statistics.iterations);
+				writer.write(statistics.failures);
+				writer.write(statistics.new_schedules);
+				writer.write(statistics.first_failure_iteration);
+				writer.write(statistics.rewarded_iterations);
+				writer.write_fixed((uint64_t)current_weights[i]);
+				writer.write(member_iterations[i]);
+				members[i]->save_state(writer);
+			}
+
+			writer.write(schedule_hashes.size());
+			for (uint64_t hash : schedule_hashes)
+			{
+				writer.write_fixed(hash);
+			}
+		}
+
+		// Restores the state that was written by 'save_state' into a portfolio with the same strategies.
+		void restore_state(StrategyStateReader& reader)
+		{
+			iteration_index = (size_t)reader.read();
+			current_member = (size_t)reader.read(members.size() - 1);
+			if (reader.read() != members.size())
+			{
+				throw ErrorCode::InvalidCheckpoint;
+			}
+
+			for (size_t i = 0; i < members.size(); i++)
+			{
+				PortfolioStatistics& statistics = member_statistics[i];
+				statistics.iterations = (size_t)reader.read();
+				statistics.failures = (size_t)reader.read();
+				statistics.new_schedules = (size_t)reader.read();
+				statistics.first_failure_iteration = (size_t)reader.read();
+				statistics.rewarded_iterations = (size_t)reader.read();
+				current_weights[i] = (int64_t)reader.read_fixed();
+				member_iterations[i] = (size_t)reader.read();
+				members[i]->restore_state(reader);
+			}
+
+			schedule_hashes.clear();
+			size_t hash_count = reader.read_count();
+			schedule_hashes.reserve(hash_count);
+			for (size_t i = 0; i < hash_count; i++)
+			{
+				schedule_hashes.insert(reader.read_fixed());
+			}
+		}
+
+		// Returns the statistics of each strategy, in the order they were added to the portfolio.
+		const std::vector<PortfolioStatistics>& statistics() const noexcept
+		{
+			return member_statistics;
+		}
+
+		// Returns the index of the strategy that runs the current iteration.
+		size_t current_strategy() const noexcept
+		{
+			return current_member;
+		}
+
+	private:
+		// Selects the strategy of the current iteration, and prepares it for its own next iteration. Each
+		// strategy was prepared for its first iteration on construction.
+		void select_next_member()
+		{
+			current_member = is_adaptive ? select_upper_confidence_bound() : select_weighted_round_robin();
+
+			member_iterations[current_member]++;
+			if (member_iterations[current_member] > 1)
+			{
+				members[current_member]->prepare_next_iteration(member_iterations[current_member]);
+			}
+		}
+
+		size_t select_weighted_round_robin()
+		{
+			size_t next_member = 0;
+			for (size_t i = 0; i < members.size(); i++)
+			{
+				current_weights[i] += (int64_t)member_statistics[i].member.weight;
+				if (current_weights[i] > current_weights[next_member])
+				{
+					next_member = i;
+				}
+			}
+
+			current_weights[next_member] -= total_weight;
+			return next_member;
+		}
+
+		// Returns the strategy with the highest upper confidence bound of its mean reward, after trying each
+		// strategy once. Iterations that have not completed yet count as unrewarded.
+		size_t select_upper_confidence_bound()
+		{
+			size_t total_iterations = 0;
+			for (size_t i = 0; i < members.size(); i++)
+			{
+				if (member_iterations[i] == 0)
+				{
+					return i;
+				}
+
+				total_iterations += member_iterations[i];
+			}
+
+			size_t next_member = 0;
+			double max_bound = -1;
+			for (size_t i = 0; i < members.size(); i++)
+			{
+				double count = (double)member_iterations[i];
+				double bound = (double)member_statistics[i].rewarded_iterations / count +
+					std::sqrt(2 * std::log((double)total_iterations) / count);
+				if (bound > max_bound)
+				{
+					max_bound = bound;
+					next_member = i;
+				}
+			}
+
+			return next_member;
+		}
+	};
+}
+
+#endif // COYOTE_PORTFOLIO_STRATEGY_H
@@ -0,0 +1,151 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_POS_STRATEGY_H
+#define COYOTE_POS_STRATEGY_H
+
+#include <map>
+#include <unordered_map>
+#include "random.h"
+#include "strategy.h"
+#include "../settings.h"
+
+namespace coyote
+{
+	// Implements partial order sampling (POS), which samples the partial orders of the events of a test
+	// much more uniformly than the random strategy. Each enabled operation has a random priority, and the
+	// operation with the highest priority is scheduled. Once an operation executes an event, its next
+	// event gets a new random priority, and so does the next event of each operation that races with the
+	// executed event. All other operations keep their priorities.
+	//
+	// The next event of an operation is not known until it happens, so it is assumed to access the same
+	// resource as the last event of the operation. Two events race if they wait for or signal the same
+	// resource, which the strategy learns from the 'wait_resource' and 'signal_resource' calls.
+	class POSStrategy : public Strategy
+	{
+	private:
+		// The pseudo-random generator.
+		Random generator;
+
+		// The seed of the campaign.
+		uint64_t campaign_seed;
+
+		// The worker of the campaign.
+		uint64_t worker;
+
+		// The iteration of the campaign, starting at '1'.
+		uint64_t iteration_index;
+
+		// The priority of the next event of each operation.
+		std::unordered_map<size_t, uint64_t> priorities;
+
+		// The resource that the last event of each operation accessed, ordered by operation id so that the
+		// priorities of racing operations are reassigned in a deterministic order.
+		std::map<size_t, size_t> accessed_resources;
+
+	public:
+		POSStrategy(Settings* settings) noexcept :
+			generator(settings->random_seed()),
+			campaign_seed(settings->random_seed()),
+			worker(settings->worker()),
+			iteration_index(settings->first_iteration())
+		{
+			generator.seed(campaign_seed, worker, iteration_index);
+		}
+
+		POSStrategy(POSStrategy&& strategy) = delete;
+		POSStrategy(POSStrategy const&) = delete;
+
+		POSStrategy& operator=(POSStrategy&& strategy) = delete;
+		POSStrategy& operator=(POSStrategy const&) = delete;
+
+		// Returns the next operation.
+		size_t next_operation(Operations& operations, size_t current)
+		{
+			// The current operation executed an event since it was scheduled, so its next event is new.
+			priorities[current] = generator.next();
+
+			size_t next_op = operations[0];
+			uint64_t max_priority = 0;
+			for (size_t idx = 0; idx < operations.size(); idx++)
+			{
+				auto result = priorities.emplace(operations[idx], 0);
+				if (result.second)
+				{
+					result.first->second = generator.next();
+				}
+
+				if (idx == 0 || result.first->second > max_priority)
+				{
+					max_priority = result.first->second;
+					next_op = operations[idx];
+				}
+			}
+
+			return next_op;
+		}
+
+		// Returns the next boolean choice.
+		bool next_boolean()
+		{
+			return (generator.next() & 1) == 0;
+		}
+
+		// Returns the next integer choice.
+		int next_integer(int max_value)
+		{
+			return generator.next() % max_value;
+		}
+
+		// Returns the seed of the campaign.
+		uint64_t random_seed()
+		{
+			return campaign_seed;
+		}
+
+		// Returns a token that reproduces the current iteration.
+		ReproductionToken reproduction_token()
+		{
+			return { StrategyType::POS, campaign_seed, worker, iteration_index, 0, 0 };
+		}
+
+		// Prepares the next iteration.
+		void prepare_next_iteration(size_t /*iteration*/)
+		{
+			iteration_index++;
+			generator.seed(campaign_seed, worker, iteration_index);
+			priorities.clear();
+			accessed_resources.clear();
+		}
+
+		// Reassigns the priorities of the operations whose next event races with the executed event.
+		void resource_accessed(size_t operation_id, size_t resource_id)
+		{
+			for (auto& kvp : accessed_resources)
+			{
+				if (kvp.second == resource_id && kvp.first != operation_id)
+				{
+					priorities[kvp.first] = generator.next();
+				}
+			}
+
+			accessed_resources[operation_id] = resource_id;
+		}
+
+		// Writes the iteration and the random state.
+		void save_state(StrategyStateWriter& writer)
+		{
+			writer.write(iteration_index);
+			writer.write_random(generator);
+		}
+
+		// Restores the iteration and the random state.
+		void restore_state(StrategyStateReader& reader)
+		{
+			iteration_index = reader.read();
+			reader.read_random(generator);
+		}
+	};
+}
+
+#endif // COYOTE_POS_STRATEGY_H
@@ -0,0 +1,197 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_Q_TABLE_H
+#define COYOTE_Q_TABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "strategy_state.h"
+
+namespace coyote
+{
+	// A map from 64-bit keys to values in a flat array with open addressing, whose memory is bounded by
+	// its capacity. A key is looked up in a short window of slots after its home slot. If the window is
+	// full when a key is added, the entry in the home slot is evicted, so the table forgets old entries
+	// instead of growing, which is acceptable for learned estimates.
+	class QTable
+	{
+	private:
+		struct Entry
+		{
+			// The key, or '0' if the slot is empty.
+			uint64_t key;
+			double value;
+		};
+
+		// Number of slots that are searched for a key.
+		static constexpr size_t PROBE_WINDOW = 8;
+
+		std::vector<Entry> entries;
+
+		// Mask that maps a hash to a slot, which is the capacity minus one.
+		size_t mask;
+
+		// Number of occupied slots.
+		size_t count;
+
+	public:
+		// Creates a table with at least the specified number of slots, rounded up to a power of two.
+		QTable(size_t capacity) :
+			mask(0),
+			count(0)
+		{
+			size_t size = PROBE_WINDOW;
+			while (size < capacity)
+			{
+				size <<= 1;
+			}
+
+			entries.resize(size, { 0, 0 });
+			mask = size - 1;
+		}
+
+		QTable(QTable&& table) = delete;
+		QTable(QTable const&) = delete;
+
+		QTable& operator=(QTable&& table) = delete;
+		QTable& operator=(QTable const&) = delete;
+
+		// Returns the value of the specified key, or '0' if the table does not have it.
+		double get(uint64_t key) const noexcept
+		{
+			key = normalize(key);
+			size_t home = (size_t)mix(key) & mask;
+			for (size_t i = 0; i < PROBE_WINDOW; i++)
+			{
+				const Entry& entry = entries[(home + i) & mask];
+				if (entry.key == key)
+				{
+					return entry.value;
+				}
+				else if (entry.key == 0)
+				{
+					break;
+				}
+			}
+
+			return 0;
+		}
+
+		// Returns the value of the specified key, adding the key with value '0' if the table does not have it.
+		double& at(uint64_t key) noexcept
+		{
+			key = normalize(key);
+			size_t home = (size_t)mix(key) & mask;
+			for (size_t i = 0; i < PROBE_WINDOW; i++)
+			{
+				Entry& entry = entries[(home + i) & mask];
+				if (entry.key == key)
+				{
+					return entry.value;
+				}
+				else if (entry.key == 0)
+				{
+					count++;
+					entry = { key, 0 };
+					return entry.value;
+				}
+			}
+
+			Entry& entry = entries[home];
+			entry = { key, 0 };
+			return entry.value;
+		}
+
+		// Removes all entries, keeping the allocated memory.
+		void clear() noexcept
+		{
+			for (Entry& entry : entries)
+			{
+				entry = { 0, 0 };
+			}
+
+			count = 0;
+		}
+
+		// Returns the number of entries.
+		size_t size() const noexcept
+		{
+			return count;
+		}
+
+		// Returns the max number of entries.
+		size_t capacity() const noexcept
+		{
+			return entries.size();
+		}
+
+		// Writes the occupied slots, each as its distance from the previous one followed by its entry.
+		void save(StrategyStateWriter& writer) const
+		{
+			writer.write(entries.size());
+			writer.write(count);
+			size_t previous = 0;
+			for (size_t slot = 0; slot < entries.size(); slot++)
+			{
+				if (entries[slot].key != 0)
+				{
+					writer.write(slot - previous);
+					writer.write_fixed(entries[slot].key);
+					writer.write_double(entries[slot].value);
+					previous = slot;
+				}
+			}
+		}
+
+		// Restores the entries that were written by 'save' from a table with the same capacity.
+		void restore(StrategyStateReader& reader)
+		{
+			if (reader.read() != entries.size())
+			{
+				throw ErrorCode::InvalidCheckpoint;
+			}
+
+			clear();
+			size_t entry_count = (size_t)reader.read(entries.size());
+			size_t slot = 0;
+			for (size_t i = 0; i < entry_count; i++)
+			{
+				size_t distance = (size_t)reader.read(entries.size() - 1 - slot);
+				if (i > 0 && distance == 0)
+				{
+					throw ErrorCode::InvalidCheckpoint;
+				}
+
+				slot += distance;
+				Entry& entry = entries[slot];
+				entry.key = reader.read_fixed();
+				entry.value = reader.read_double();
+				if (entry.key == 0)
+				{
+					throw ErrorCode::InvalidCheckpoint;
+				}
+			}
+
+			count = entry_count;
+		}
+
+		// Returns the SplitMix64 finalizer of the specified value, which is used to hash and combine keys.
+		static uint64_t mix(uint64_t z) noexcept
+		{
+			z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+			z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+			return z ^ (z >> 31);
+		}
+
+	private:
+		// Maps the key '0', which marks empty slots, to another key.
+		static uint64_t normalize(uint64_t key) noexcept
+		{
+			return key == 0 ? 0x9e3779b97f4a7c15 : key;
+		}
+	};
+}
+
+#endif // COYOTE_Q_TABLE_H
@@ -0,0 +1,259 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_QLEARNING_STRATEGY_H
+#define COYOTE_QLEARNING_STRATEGY_H
+
+#include <cmath>
+#include <vector>
+#include "q_table.h"
+#include "random.h"
+#include "strategy.h"
+#include "../settings.h"
+
+namespace coyote
+{
+	// Learns which operation to schedule in each abstract program state with Q-learning. The abstract
+	// state hashes the set of enabled operations, the operation that made the last event and whether it
+	// is still enabled, and the last state hash that the test reported. A step to a new state is not
+	// penalized, while a step to a visited state is penalized more the more often it was visited, so that
+	// untried choices, whose value is '0', are preferred over choices that are known to lead to well
+	// explored states. The next operation is chosen epsilon-greedily, with the bound as the probability
+	// in percent of choosing a random operation.
+	//
+	// The learned values carry over across iterations, so the reproduction token only reproduces the
+	// first iteration. The other iterations can be replayed from their recorded schedules.
+	class QLearningStrategy : public Strategy
+	{
+	private:
+		// The rate at which values move towards new estimates.
+		static constexpr double LEARNING_RATE = 0.3;
+
+		// The discount of future rewards.
+		static constexpr double DISCOUNT_FACTOR = 0.7;
+
+		// The pseudo-random generator.
+		Random generator;
+
+		// The seed of the campaign.
+		uint64_t campaign_seed;
+
+		// The worker of the campaign.
+		uint64_t worker;
+
+		// The iteration of the campaign, starting at '1'.
+		uint64_t iteration_index;
+
+		// The probability in percent of choosing a random operation.
+		size_t exploration_probability;
+
+		// The learned value of each pair of abstract state and operation.
+		QTable values;
+
+		// The number of visits of each abstract state.
+		QTable visits;
+
+		// The abstract state and chosen operation of the last step, if there was one.
+		uint64_t previous_state;
+		size_t previous_operation;
+		bool has_previous_step;
+
+		// The last state hash that the test reported in the current iteration.
+		uint64_t reported_state_hash;
+
+		// Operations with the highest value in the current step.
+		std::vector<size_t> best_operations;
+
+	public:
+		QLearningStrategy(Settings* settings) :
+			generator(settings->random_seed()),
+			campaign_seed(settings->random_seed()),
+			worker(settings->worker()),
+			iteration_index(settings->first_iteration()),
+			exploration_probability(settings->exploration_strategy_bound()),
+			values(settings->q_table_capacity()),
+			visits(settings->q_table_capacity()),
+			previous_state(0),
+			previous_operation(0),
+			has_previous_step(false),
+			reported_state_hash(0)
+		{
+			generator.seed(campaign_seed, worker, iteration_index);
+		}
+
+		QLearningStrategy(QLearningStrategy&& strategy) = delete;
+		QLearningStrategy(QLearningStrategy const&) = delete;
+
+		QLearningStrategy& operator=(QLearningStrategy&& strategy) = delete;
+		QLearningStrategy& operator=(QLearningStrategy const&) = delete;
+
+		// Returns the next operation.
+		size_t next_operation(Operations& operations, size_t current)
+		{
+			uint64_t state = abstract_state(operations, current);
+			double& visit_count = visits.at(state);
+			double reward = 1 / std::sqrt(visit_count + 1) - 1;
+			visit_count++;
+
+			if (has_previous_step)
+			{
+				update(previous_state, previous_operation, reward + DISCOUNT_FACTOR * max_value(state, operations));
+			}
+
+			size_t next_op;
+			if (generator.next() % 100 < exploration_probability)
+			{
+				next_op = operations[generator.next() % operations.size()];
+			}
+			else
+			{
+				double best_value = 0;
+				best_operations.clear();
+				for (size_t idx = 0; idx < operations.size(); idx++)
+				{
+					double value = values.get(key(state, operations[idx]));
+					if (best_operations.empty() || value > best_value)
+					{
+						best_value = value;
+						best_operations.clear();
+						best_operations.push_back(operations[idx]);
+					}
+					else if (value == best_value)
+					{
+						best_operations.push_back(operations[idx]);
+					}
+				}
+
+				next_op = best_operations[generator.next() % best_operations.size()];
+			}
+
+			previous_state = state;
+			previous_operation = next_op;
+			has_previous_step = true;
+			return next_op;
+		}
+
+		// Returns the next boolean choice.
+		bool next_boolean()
+		{
+			return (generator.next() & 1) == 0;
+		}
+
+		// Returns the next integer choice.
+		int next_integer(int max_value)
+		{
+			return generator.next() % max_value;
+		}
+
+		// Returns the seed of the campaign.
+		uint64_t random_seed()
+		{
+			return campaign_seed;
+		}
+
+		// Returns a token that reproduces the current iteration if it is the first one. The token of a later
+		// iteration has no strategy, as the token does not carry the values learned before the iteration.
+		ReproductionToken reproduction_token()
+		{
+			StrategyType strategy = iteration_index == 1 ? StrategyType::QLearning : StrategyType::None;
+			return { strategy, campaign_seed, worker, iteration_index, 0, exploration_probability };
+		}
+
+		// Prepares the next iteration.
+		void prepare_next_iteration(size_t /*iteration*/)
+		{
+			iteration_index++;
+			generator.seed(campaign_seed, worker, iteration_index);
+			has_previous_step = false;
+			reported_state_hash = 0;
+		}
+
+		// Updates the value of the last step of the iteration, which has no future rewards.
+		void complete_iteration(const IterationOutcome& /*outcome*/)
+		{
+			if (has_previous_step)
+			{
+				update(previous_state, previous_operation, 0);
+				has_previous_step = false;
+			}
+		}
+
+		// Includes the specified hash of the program state in the abstract state of the next steps.
+		void report_state_hash(uint64_t hash)
+		{
+			reported_state_hash = hash;
+		}
+
+		// Writes the iteration, the random state and the learned values and visits.
+		void save_state(StrategyStateWriter& writer)
+		{
+			writer.write(iteration_index);
+			writer.write_random(generator);
+			values.save(writer);
+			visits.save(writer);
+		}
+
+		// Restores the iteration, the random state and the learned values and visits.
+		void restore_state(StrategyStateReader& reader)
+		{
+			iteration_index = reader.read();
+			reader.read_random(generator);
+			values.restore(reader);
+			visits.restore(reader);
+			has_previous_step = false;
+		}
+
+		// Returns the number of learned values.
+		size_t learned_values() const noexcept
+		{
+			return values.size();
+		}
+
+	private:
+		// Returns the abstract state of the current step. The enabled operations are combined in an order
+		// independent way, because their order does not change the state of the program.
+		uint64_t abstract_state(Operations& operations, size_t current) const
+		{
+			uint64_t enabled_hash = 0;
+			bool is_current_enabled = false;
+			for (size_t idx = 0; idx < operations.size(); idx++)
+			{
+				enabled_hash += QTable::mix(operations[idx] + 1);
+				is_current_enabled |= operations[idx] == current;
+			}
+
+			uint64_t state = QTable::mix(enabled_hash ^ ((uint64_t)current << 1 | (is_current_enabled ? 1 : 0)));
+			return QTable::mix(state ^ reported_state_hash);
+		}
+
+		static uint64_t key(uint64_t state, size_t operation_id) noexcept
+		{
+			return QTable::mix(state ^ QTable::mix(operation_id + 0x9e3779b97f4a7c15));
+		}
+
+		// Returns the highest value of an enabled operation in the specified state.
+		double max_value(uint64_t state, Operations& operations) const
+		{
+			double result = 0;
+			for (size_t idx = 0; idx < operations.size(); idx++)
+			{
+				double value = values.get(key(state, operations[idx]));
+				if (idx == 0 || value > result)
+				{
+					result = value;
+				}
+			}
+
+			return result;
+		}
+
+		// Moves the value of the specified step towards the specified estimate.
+		void update(uint64_t state, size_t operation_id, double estimate)
+		{
+			double& value = values.at(key(state, operation_id));
+			value += LEARNING_RATE * (estimate - value);
+		}
+	};
+}
+
+#endif // COYOTE_QLEARNING_STRATEGY_H
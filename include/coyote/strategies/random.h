@@ -6,19 +6,31 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <memory>
 
 namespace coyote
 {
-	// Implements the xoroshiro pseudorandom number generator.
+	// Implements the xoroshiro128+ pseudorandom number generator. The generator has a period of 2^128 - 1,
+	// and can jump ahead by multiples of 2^64 steps, which splits its sequence into disjoint streams.
 	class Random
 	{
 	private:
 		static constexpr unsigned STATE_BITS = 8 * sizeof(uint64_t);
 		static constexpr unsigned RESULT_BITS = 8 * sizeof(uint64_t);
 
+		// Number of streams of 2^64 steps in a worker partition, which is 2^96 steps.
+		static constexpr unsigned PARTITION_BITS = 32;
+
 		uint64_t x;
 		uint64_t y;
 
+		// The state transition is linear over GF(2), so advancing the state by a fixed number of steps is a
+		// 128x128 bit matrix, which is stored as the image of each bit of the state.
+		struct JumpMatrix
+		{
+			uint64_t columns[2 * STATE_BITS][2];
+		};
+
 	public:
 		Random(uint64_t seed) noexcept :
 			x(seed == 0 ? 5489 : seed),
@@ -40,6 +52,15 @@ namespace coyote
 			next();
 		}
 
+		// Seeds the generator and positions it at the start of the specified stream of the specified worker.
+		// Each stream has 2^64 numbers and each worker has 2^32 streams, so the streams of different
+		// workers, and the different streams of a worker, never overlap.
+		void seed(const uint64_t seed, const uint64_t worker, const uint64_t stream)
+		{
+			this->seed(seed);
+			jump((worker << PARTITION_BITS) + (stream & ((1ull << PARTITION_BITS) - 1)));
+		}
+
 		// Returns the next random number.
 		uint64_t next()
 		{
@@ -49,11 +70,136 @@ namespace coyote
 			y = rotl(y, 36);
 			return r >> (STATE_BITS - RESULT_BITS);
 		}
+
+		// Writes the state of the generator, such as to save it in a checkpoint.
+		void get_state(uint64_t& x, uint64_t& y) const noexcept
+		{
+			x = this->x;
+			y = this->y;
+		}
+
+		// Restores a state that was written by 'get_state'.
+		void set_state(uint64_t x, uint64_t y) noexcept
+		{
+			this->x = x;
+			this->y = y;
+		}
+
+		// Advances the generator by 2^64 steps, using the jump polynomial of xoroshiro128+.
+		void jump() noexcept
+		{
+			static constexpr uint64_t JUMP[] = { 0xbeac0467eba5facb, 0xd86b048b86aa9922 };
+			uint64_t jump_x = 0;
+			uint64_t jump_y = 0;
+			for (uint64_t word : JUMP)
+			{
+				for (unsigned bit = 0; bit < STATE_BITS; bit++)
+				{
+					if (word & (1ull << bit))
+					{
+						jump_x ^= x;
+						jump_y ^= y;
+					}
+
+					next();
+				}
+			}
+
+			x = jump_x;
+			y = jump_y;
+		}
+
+		// Advances the generator by 2^96 steps, which is the start of the partition of the next worker.
+		void long_jump() noexcept
+		{
+			jump(1ull << PARTITION_BITS);
+		}
+
+		// Advances the generator by count * 2^64 steps, applying one precomputed jump matrix per set bit of
+		// the count.
+		void jump(uint64_t count) noexcept
+		{
+			if (count == 0)
+			{
+				return;
+			}
+
+			const JumpMatrix* matrices = jump_matrices();
+			for (unsigned i = 0; count != 0; i++, count >>= 1)
+			{
+				if (count & 1)
+				{
+					apply(matrices[i], x, y);
+				}
+			}
+		}
+
 	private:
 		static inline uint64_t rotl(const uint64_t x, const uint64_t k)
 		{
 			return (x << k) | (x >> (STATE_BITS - k));
 		}
+
+		// Multiplies the state by the specified matrix.
+		static void apply(const JumpMatrix& matrix, uint64_t& x, uint64_t& y) noexcept
+		{
+			uint64_t result_x = 0;
+			uint64_t result_y = 0;
+			for (unsigned bit = 0; bit < 2 * STATE_BITS; bit++)
+			{
+				uint64_t word = bit < STATE_BITS ? x : y;
+				if (word & (1ull << (bit % STATE_BITS)))
+				{
+					result_x ^= matrix.columns[bit][0];
+					result_y ^= matrix.columns[bit][1];
+				}
+			}
+
+			x = result_x;
+			y = result_y;
+		}
+
+		// Returns the matrices that advance the state by 2^(64 + i) steps, for each i in [0, 64). They are
+		// computed once by repeatedly squaring the matrix of a single step.
+		static const JumpMatrix* jump_matrices() noexcept
+		{
+			static const std::unique_ptr<JumpMatrix[]> matrices = []()
+			{
+				JumpMatrix step;
+				for (unsigned bit = 0; bit < 2 * STATE_BITS; bit++)
+				{
+					Random generator(0);
+					generator.x = bit < STATE_BITS ? 1ull << bit : 0;
+					generator.y = bit < STATE_BITS ? 0 : 1ull << (bit - STATE_BITS);
+					generator.next();
+					step.columns[bit][0] = generator.x;
+					step.columns[bit][1] = generator.y;
+				}
+
+				// After the i-th squaring, the matrix advances the state by 2^i steps.
+				auto result = std::make_unique<JumpMatrix[]>(STATE_BITS);
+				for (unsigned i = 1; i < 2 * STATE_BITS; i++)
+				{
+					JumpMatrix square;
+					for (unsigned bit = 0; bit < 2 * STATE_BITS; bit++)
+					{
+						square.columns[bit][0] = step.columns[bit][0];
+						square.columns[bit][1] = step.columns[bit][1];
+						apply(step, square.columns[bit][0], square.columns[bit][1]);
+					}
+
+					step = square;
+					if (i >= STATE_BITS)
+					{
+						result[i - STATE_BITS] = step;
+					}
+				}
+
+				return result;
+			}();
+
+			return matrices.get();
+		}
 	};
 }
 
@@ -16,8 +16,14 @@ namespace coyote
 		// The pseudo-random generator.
 		Random generator;
 
-		// The seed used by the current iteration.
-		uint64_t iteration_seed;
+		// The seed of the first iteration of the campaign.
+		uint64_t campaign_seed;
+
+		// The worker of the campaign.
+		uint64_t worker;
+
+		// The iteration of the campaign, starting at '1'.
+		uint64_t iteration_index;
 
 		// The probability of deviating from the current operation if it is enabled.
 		size_t scheduling_deviation_probability;
@@ -25,9 +31,12 @@ namespace coyote
 	public:
 		RandomStrategy(Settings* settings) noexcept :
 			generator(settings->random_seed()),
-			iteration_seed(settings->random_seed()),
+			campaign_seed(settings->random_seed()),
+			worker(settings->worker()),
+			iteration_index(settings->first_iteration()),
 			scheduling_deviation_probability(settings->exploration_strategy_bound())
 		{
+			start_iteration();
 		}
 
 		RandomStrategy(RandomStrategy&& strategy) = delete;
@@ -72,17 +81,55 @@ namespace coyote
 			return generator.next() % max_value;
 		}
 
-		// Returns the seed used in the current iteration.
+		// Returns the seed used in the current iteration. For worker '0', this seed alone reproduces the
+		// iteration with 'Settings::use_random_strategy'.
 		uint64_t random_seed()
 		{
-			return iteration_seed;
+			return worker == 0 ? campaign_seed + iteration_index - 1 : campaign_seed;
+		}
+
+		// Returns a token that reproduces the current iteration of any worker.
+		ReproductionToken reproduction_token()
+		{
+			return { StrategyType::Random, campaign_seed, worker, iteration_index, 0, scheduling_deviation_probability };
 		}
 
 		// Prepares the next iteration.
-		void prepare_next_iteration(size_t iteration)
+		void prepare_next_iteration(size_t /*iteration*/)
 		{
-			iteration_seed += 1;
-			generator.seed(iteration_seed);
+			iteration_index += 1;
+			start_iteration();
+		}
+
+		// Writes the iteration and the random state.
+		void save_state(StrategyStateWriter& writer)
+		{
+			writer.write(iteration_index);
+			writer.write_random(generator);
+		}
+
+		// Restores the iteration and the random state.
+		void restore_state(StrategyStateReader& reader)
+		{
+			iteration_index = reader.read();
+			reader.read_random(generator);
+		}
+
+	private:
+		// Seeds the generator for the current iteration. Worker '0' seeds it with the seed of the campaign
+		// plus the number of iterations before it, so that the seed of an iteration reproduces it as with a
+		// single worker. Other workers start each iteration at its stream in their own partition of the
+		// random sequence of the campaign seed, so their iterations never overlap with each other.
+		void start_iteration()
+		{
+			if (worker == 0)
+			{
+				generator.seed(campaign_seed + iteration_index - 1);
+			}
+			else
+			{
+				generator.seed(campaign_seed, worker, iteration_index);
+			}
 		}
 	};
 }
@@ -0,0 +1,222 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_REPLAY_STRATEGY_H
+#define COYOTE_REPLAY_STRATEGY_H
+
+#include <unordered_map>
+#include <vector>
+#include "random.h"
+#include "strategy.h"
+#include "../settings.h"
+#include "../schedules/schedule_trace.h"
+
+namespace coyote
+{
+	// Replays a recorded schedule. Each recorded choice is keyed by the operation that was scheduled when
+	// the choice was made and by how many choices that operation had made before, instead of by its
+	// global position. An edited schedule, such as a candidate of the schedule minimizer, therefore keeps
+	// the progress of each operation aligned with the recording after some context switches are dropped.
+	//
+	// At each step the recorded operation is scheduled if the step is not skipped and the operation is
+	// enabled. Else the current operation keeps running if it is enabled, else the recorded operation is
+	// scheduled if it is enabled, and else the enabled operation with the lowest id is scheduled. Data
+	// choices are keyed the same way, and a data choice that was not recorded, or whose recorded value is
+	// out of range, is made randomly.
+	class ReplayStrategy : public Strategy
+	{
+	private:
+		// The pseudo-random generator, which makes any data choices.
+		Random generator;
+
+		// The seed used by each iteration.
+		uint64_t iteration_seed;
+
+		// Map from operation ids to the choices that were recorded while the operation was scheduled.
+		std::unordered_map<size_t, std::vector<ScheduleStep>> recorded_choices;
+
+		// Map from operation ids to the number of choices they made in the current iteration.
+		std::unordered_map<size_t, size_t> choice_counts;
+
+		// Map from operation ids to the data choices that were recorded while the operation was scheduled.
+		std::unordered_map<size_t, std::vector<ScheduleStep>> recorded_data_choices;
+
+		// Map from operation ids to the number of data choices they made in the current iteration.
+		std::unordered_map<size_t, size_t> data_choice_counts;
+
+		// The operation that is scheduled in the current iteration.
+		size_t scheduled_operation;
+
+		// Number of steps where the recorded operation could not be scheduled.
+		size_t divergence_count;
+
+		// The iteration of the campaign, starting at '1'.
+		uint64_t iteration_index;
+
+	public:
+		ReplayStrategy(Settings* settings) :
+			generator(settings->random_seed()),
+			iteration_seed(settings->random_seed()),
+			scheduled_operation(0),
+			divergence_count(0),
+			iteration_index(settings->first_iteration())
+		{
+			size_t current = 0;
+			for (const ScheduleStep& step : settings->replay_schedule().view())
+			{
+				if (step.kind == ScheduleStepKind::Operation)
+				{
+					recorded_choices[current].push_back(step);
+					current = (size_t)step.value;
+				}
+				else
+				{
+					recorded_data_choices[current].push_back(step);
+				}
+			}
+		}
+
+		ReplayStrategy(ReplayStrategy&& strategy) = delete;
+		ReplayStrategy(ReplayStrategy const&) = delete;
+
+		ReplayStrategy& operator=(ReplayStrategy&& strategy) = delete;
+		ReplayStrategy& operator=(ReplayStrategy const&) = delete;
+
+		// Returns the next operation.
+		size_t next_operation(Operations& operations, size_t current)
+		{
+			const ScheduleStep* step = nullptr;
+			size_t index = choice_counts[current]++;
+			auto it = recorded_choices.find(current);
+			if (it != recorded_choices.end() && index < it->second.size())
+			{
+				step = &it->second[index];
+			}
+
+			bool is_recorded_enabled = false;
+			bool is_current_enabled = false;
+			size_t min_enabled_op = operations[0];
+			for (size_t idx = 0; idx < operations.size(); idx++)
+			{
+				if (step != nullptr && operations[idx] == step->value)
+				{
+					is_recorded_enabled = true;
+				}
+				else if (operations[idx] == current)
+				{
+					is_current_enabled = true;
+				}
+
+				if (operations[idx] < min_enabled_op)
+				{
+					min_enabled_op = operations[idx];
+				}
+			}
+
+			bool is_skipped = step != nullptr && (step->flags & SCHEDULE_STEP_SKIPPED) != 0;
+			if (is_recorded_enabled && (!is_skipped || !is_current_enabled))
+			{
+				scheduled_operation = (size_t)step->value;
+			}
+			else
+			{
+				if (step != nullptr && !is_skipped)
+				{
+					divergence_count++;
+				}
+
+				scheduled_operation = is_current_enabled ? current : min_enabled_op;
+			}
+
+			return scheduled_operation;
+		}
+
+		// Returns the next boolean choice.
+		bool next_boolean()
+		{
+			const ScheduleStep* step = next_data_choice(ScheduleStepKind::Boolean);
+			return step != nullptr ? step->value != 0 : (generator.next() & 1) == 0;
+		}
+
+		// Returns the next integer choice.
+		int next_integer(int max_value)
+		{
+			const ScheduleStep* step = next_data_choice(ScheduleStepKind::Integer);
+			if (step != nullptr && step->value < (uint64_t)max_value)
+			{
+				return (int)step->value;
+			}
+			else if (step != nullptr)
+			{
+				divergence_count++;
+			}
+
+			return generator.next() % max_value;
+		}
+
+		// Returns the seed used in the current iteration.
+		uint64_t random_seed()
+		{
+			return iteration_seed;
+		}
+
+		// Returns a token that reproduces the current iteration, given the replayed schedule. Every iteration
+		// replays the same schedule with the same seed.
+		ReproductionToken reproduction_token()
+		{
+			return { StrategyType::Replay, iteration_seed, 0, iteration_index, 0, 0 };
+		}
+
+		// Prepares the next iteration, which replays the schedule from the start.
+		void prepare_next_iteration(size_t /*iteration*/)
+		{
+			iteration_index += 1;
+			generator.seed(iteration_seed);
+			choice_counts.clear();
+			data_choice_counts.clear();
+			scheduled_operation = 0;
+			divergence_count = 0;
+		}
+
+		// Writes the iteration, as each iteration replays the same schedule.
+		void save_state(StrategyStateWriter& writer)
+		{
+			writer.write(iteration_index);
+		}
+
+		// Restores the iteration.
+		void restore_state(StrategyStateReader& reader)
+		{
+			iteration_index = reader.read();
+		}
+
+		// Returns the number of steps in the current iteration where the recorded operation was not enabled,
+		// or the recorded data choice did not match.
+		size_t divergences() const noexcept
+		{
+			return divergence_count;
+		}
+
+	private:
+		// Returns the next recorded data choice of the scheduled operation, or null if it was not recorded or
+		// has another kind.
+		const ScheduleStep* next_data_choice(ScheduleStepKind kind)
+		{
+			size_t index = data_choice_counts[scheduled_operation]++;
+			auto it = recorded_data_choices.find(scheduled_operation);
+			if (it == recorded_data_choices.end() || index >= it->second.size())
+			{
+				return nullptr;
+			}
+			else if (it->second[index].kind != kind)
+			{
+				divergence_count++;
+				return nullptr;
+			}
+
+			return &it->second[index];
+		}
+	};
+}
+
+#endif // COYOTE_REPLAY_STRATEGY_H
@@ -0,0 +1,81 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_REPRODUCTION_TOKEN_H
+#define COYOTE_REPRODUCTION_TOKEN_H
+
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include "strategy_type.h"
+
+namespace coyote
+{
+	// Identifies a testing iteration of a campaign, so that the iteration can be reproduced directly
+	// without running the iterations before it. Each strategy derives the randomness of an iteration only
+	// from the seed and the iteration number, and the token carries any other state that the strategy
+	// learned from the earlier iterations. A strategy that learns more state than fits in a token returns
+	// a token without a strategy, and the iteration must be reproduced from its recorded schedule instead.
+	struct ReproductionToken
+	{
+		// The strategy of the campaign.
+		StrategyType strategy = StrategyType::None;
+
+		// The seed of the campaign.
+		uint64_t seed = 0;
+
+		// The worker of the campaign that ran the iteration.
+		uint64_t worker = 0;
+
+		// The iteration, starting at '1'.
+		uint64_t iteration = 0;
+
+		// The schedule length that the strategy estimated before the iteration, or '0' if it does not
+		// estimate one.
+		uint64_t schedule_length = 0;
+
+		// The strategy-specific bound.
+		uint64_t bound = 0;
+
+		// Returns true if the token reproduces its iteration, else false.
+		bool is_reproducible() const noexcept
+		{
+			return strategy != StrategyType::None;
+		}
+
+		// Returns the token in the 'strategy:seed:worker:iteration:schedule_length:bound' format.
+		std::string to_string() const
+		{
+			return std::to_string((int)strategy) + ":" + std::to_string(seed) + ":" + std::to_string(worker) + ":" +
+				std::to_string(iteration) + ":" + std::to_string(schedule_length) + ":" + std::to_string(bound);
+		}
+
+		// Parses a token in the format returned by 'to_string'. Returns false if the text is not a token.
+		static bool parse(const std::string& text, ReproductionToken& token)
+		{
+			uint64_t fields[6];
+			const char* position = text.c_str();
+			for (size_t i = 0; i < 6; i++)
+			{
+				char* end = nullptr;
+				fields[i] = std::strtoull(position, &end, 10);
+				if (end == position || *end != (i < 5 ? ':' : '\0'))
+				{
+					return false;
+				}
+
+				position = end + 1;
+			}
+
+			if (fields[0] == (uint64_t)StrategyType::None || fields[0] > (uint64_t)StrategyType::DFS || fields[3] == 0)
+			{
+				return false;
+			}
+
+			token = { (StrategyType)fields[0], fields[1], fields[2], fields[3], fields[4], fields[5] };
+			return true;
+		}
+	};
+}
+
+#endif // COYOTE_REPRODUCTION_TOKEN_H
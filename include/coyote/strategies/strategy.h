@@ -4,10 +4,26 @@
 #ifndef COYOTE_STRATEGY_H
 #define COYOTE_STRATEGY_H
 
+#include <cstdint>
+#include "reproduction_token.h"
+#include "strategy_state.h"
 #include "../operations/operations.h"
 
 namespace coyote
 {
+	// The outcome of a completed testing iteration, which adaptive strategies learn from.
+	struct IterationOutcome
+	{
+		// A nonzero signature of the failure that the iteration found, or '0' if it passed.
+		uint64_t failure;
+
+		// The hash of the schedule of the iteration, which identifies the explored interleaving.
+		uint64_t schedule_hash;
+
+		// Number of steps in the schedule of the iteration.
+		size_t schedule_length;
+	};
+
 	class Strategy
 	{
 	public:
@@ -23,9 +39,51 @@ namespace coyote
 		// Returns the seed used in the current iteration.
 		virtual uint64_t random_seed() = 0;
 
+		// Returns a token that reproduces the current iteration.
+		virtual ReproductionToken reproduction_token() = 0;
+
 		// Prepares the next iteration.
 		virtual void prepare_next_iteration(size_t iteration) = 0;
 
+		// Returns true if the strategy has made all the choices that it planned for the current iteration,
+		// such as the priority change points of PCT, so that the rest of the iteration can be scheduled
+		// fairly without losing what the strategy explores.
+		virtual bool has_completed_prefix()
+		{
+			return false;
+		}
+
+		// Notifies the strategy that the specified operation waited for or signaled the specified resource.
+		// Strategies that do not track dependencies between operations can ignore it.
+		virtual void resource_accessed(size_t /*operation_id*/, size_t /*resource_id*/)
+		{
+		}
+
+		// Notifies the strategy of the hash of the program state that the test reported at the current step.
+		// Strategies that do not use program states can ignore it.
+		virtual void report_state_hash(uint64_t /*hash*/)
+		{
+		}
+
+		// Notifies the strategy that the current iteration completed with the specified outcome. Strategies
+		// that do not adapt to the outcome can ignore it.
+		virtual void complete_iteration(const IterationOutcome& /*outcome*/)
+		{
+		}
+
+		// Writes the state that the strategy carries over to the next iterations of the campaign, such as its
+		// random state, iteration and learned estimates, so that a checkpoint resumes the campaign exactly.
+		// This is called between iterations. Strategies without such state can ignore it.
+		virtual void save_state(StrategyStateWriter& /*writer*/)
+		{
+		}
+
+		// Restores the state that was written by 'save_state' into a strategy with the same settings, which
+		// then continues from the next iteration.
+		virtual void restore_state(StrategyStateReader& /*reader*/)
+		{
+		}
+
 		virtual ~Strategy() = default;
 	};
 }
@@ -0,0 +1,189 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_STRATEGY_STATE_H
+#define COYOTE_STRATEGY_STATE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include "random.h"
+#include "../error_code.h"
+
+namespace coyote
+{
+	// Writes the campaign state of a strategy to a compact stream of bytes, which is stored in a checkpoint.
+	// Integers are written as LEB128 varints, as most of them are small counts and indexes.
+	class StrategyStateWriter
+	{
+	private:
+		std::vector<uint8_t> bytes;
+
+	public:
+		StrategyStateWriter() noexcept
+		{
+		}
+
+		StrategyStateWriter(StrategyStateWriter&& writer) = delete;
+		StrategyStateWriter(StrategyStateWriter const&) = delete;
+
+		StrategyStateWriter& operator=(StrategyStateWriter&& writer) = delete;
+		StrategyStateWriter& operator=(StrategyStateWriter const&) = delete;
+
+		void write(uint64_t value)
+		{
+			while (value >= 0x80)
+			{
+				bytes.push_back((uint8_t)(value | 0x80));
+				value >>= 7;
+			}
+
+			bytes.push_back((uint8_t)value);
+		}
+
+		void write_bool(bool value)
+		{
+			bytes.push_back(value ? 1 : 0);
+		}
+
+		// Writes the bits of the specified value, so that it is restored exactly.
+		void write_double(double value)
+		{
+			uint64_t bits;
+			std::memcpy(&bits, &value, sizeof(bits));
+			write_fixed(bits);
+		}
+
+		// Writes the specified value in 8 bytes, which is more compact for hashes and random states.
+		void write_fixed(uint64_t value)
+		{
+			for (unsigned i = 0; i < 8; i++)
+			{
+				bytes.push_back((uint8_t)(value >> (8 * i)));
+			}
+		}
+
+		void write_random(const Random& generator)
+		{
+			uint64_t x, y;
+			generator.get_state(x, y);
+			write_fixed(x);
+			write_fixed(y);
+		}
+
+		const std::vector<uint8_t>& data() const noexcept
+		{
+			return bytes;
+		}
+	};
+
+	// Reads the campaign state of a strategy that was written by a 'StrategyStateWriter'. Reading past the
+	// end of the state, or a value that does not fit the strategy, throws the 'InvalidCheckpoint' error code.
+	class StrategyStateReader
+	{
+	private:
+		const uint8_t* bytes;
+		size_t size;
+		size_t position;
+
+	public:
+		StrategyStateReader(const uint8_t* bytes, size_t size) noexcept :
+			bytes(bytes),
+			size(size),
+			position(0)
+		{
+		}
+
+		StrategyStateReader(StrategyStateReader&& reader) = delete;
+		StrategyStateReader(StrategyStateReader const&) = delete;
+
+		StrategyStateReader& operator=(StrategyStateReader&& reader) = delete;
+		StrategyStateReader& operator=(StrategyStateReader const&) = delete;
+
+		uint64_t read()
+		{
+			uint64_t value = 0;
+			for (unsigned shift = 0; shift < 64; shift += 7)
+			{
+				uint8_t byte = next_byte();
+				value |= (uint64_t)(byte & 0x7f) << shift;
+				if ((byte & 0x80) == 0)
+				{
+					return value;
+				}
+			}
+
+			throw ErrorCode::InvalidCheckpoint;
+		}
+
+		// Reads a value that must not be greater than the specified max value.
+		uint64_t read(uint64_t max_value)
+		{
+			uint64_t value = read();
+			if (value > max_value)
+			{
+				throw ErrorCode::InvalidCheckpoint;
+			}
+
+			return value;
+		}
+
+		// Reads the number of items of a collection, each of which takes at least one byte, so that a corrupt
+		// count does not allocate more memory than the state could hold.
+		size_t read_count()
+		{
+			return (size_t)read(size - position);
+		}
+
+		bool read_bool()
+		{
+			return read(1) == 1;
+		}
+
+		double read_double()
+		{
+			uint64_t bits = read_fixed();
+			double value;
+			std::memcpy(&value, &bits, sizeof(value));
+			return value;
+		}
+
+		uint64_t read_fixed()
+		{
+			uint64_t value = 0;
+			for (unsigned i = 0; i < 8; i++)
+			{
+				value |= (uint64_t)next_byte() << (8 * i);
+			}
+
+			return value;
+		}
+
+		void read_random(Random& generator)
+		{
+			uint64_t x = read_fixed();
+			uint64_t y = read_fixed();
+			generator.set_state(x, y);
+		}
+
+		// Returns true if the whole state was read, else false.
+		bool is_done() const noexcept
+		{
+			return position == size;
+		}
+
+	private:
+		uint8_t next_byte()
+		{
+			if (position == size)
+			{
+				throw ErrorCode::InvalidCheckpoint;
+			}
+
+			return bytes[position++];
+		}
+	};
+}
+
+#endif // COYOTE_STRATEGY_STATE_H
@@ -10,7 +10,20 @@ namespace coyote
     {
         None = 0,
         Random,
-        PCT
+        PCT,
+        Replay,
+        Portfolio,
+        Bandit,
+        QLearning,
+        POS,
+        DFS
+    };
+
+    // How the fair tail of an iteration schedules the enabled operations.
+    enum class FairSchedulingMode
+    {
+        RoundRobin = 0,
+        Random
     };
 }
 
@@ -0,0 +1,182 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_VISITED_STATES_H
+#define COYOTE_VISITED_STATES_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "q_table.h"
+#include "strategy_state.h"
+
+namespace coyote
+{
+	// A set of visited program states with hash compaction, whose memory is bounded by its capacity. Each
+	// state is stored as a 32-bit fingerprint in a flat array with open addressing, at 4 bytes per state,
+	// so millions of states fit in a few megabytes. Two states with the same slot and fingerprint are
+	// considered the same, which is rare enough for pruning. If the probe window of a new state is full,
+	// the fingerprint in its home slot is evicted, so the set forgets old states instead of growing.
+	class VisitedStates
+	{
+	private:
+		// Number of slots that are searched for a fingerprint.
+		static constexpr size_t PROBE_WINDOW = 8;
+
+		// The fingerprint of each slot, or '0' if the slot is empty.
+		std::vector<uint32_t> fingerprints;
+
+		// Mask that maps a hash to a slot, which is the capacity minus one.
+		size_t mask;
+
+		// Number of occupied slots.
+		size_t count;
+
+	public:
+		// Creates a set with at least the specified number of slots, rounded up to a power of two.
+		VisitedStates(size_t capacity) :
+			mask(0),
+			count(0)
+		{
+			size_t size = PROBE_WINDOW;
+			while (size < capacity)
+			{
+				size <<= 1;
+			}
+
+			fingerprints.resize(size, 0);
+			mask = size - 1;
+		}
+
+		VisitedStates(VisitedStates&& states) = delete;
+		VisitedStates(VisitedStates const&) = delete;
+
+		VisitedStates& operator=(VisitedStates&& states) = delete;
+		VisitedStates& operator=(VisitedStates const&) = delete;
+
+		// Adds the specified state. Returns true if the state was not visited before, else false.
+		bool insert(uint64_t state) noexcept
+		{
+			uint64_t hash = QTable::mix(state);
+			uint32_t fingerprint = to_fingerprint(hash);
+			size_t home = (size_t)hash & mask;
+			for (size_t i = 0; i < PROBE_WINDOW; i++)
+			{
+				uint32_t& slot = fingerprints[(home + i) & mask];
+				if (slot == fingerprint)
+				{
+					return false;
+				}
+				else if (slot == 0)
+				{
+					slot = fingerprint;
+					count++;
+					return true;
+				}
+			}
+
+			fingerprints[home] = fingerprint;
+			return true;
+		}
+
+		// Returns true if the specified state was visited, else false.
+		bool contains(uint64_t state) const noexcept
+		{
+			uint64_t hash = QTable::mix(state);
+			uint32_t fingerprint = to_fingerprint(hash);
+			size_t home = (size_t)hash & mask;
+			for (size_t i = 0; i < PROBE_WINDOW; i++)
+			{
+				uint32_t slot = fingerprints[(home + i) & mask];
+				if (slot == fingerprint)
+				{
+					return true;
+				}
+				else if (slot == 0)
+				{
+					break;
+				}
+			}
+
+			return false;
+		}
+
+		// Removes all states, keeping the allocated memory.
+		void clear() noexcept
+		{
+			std::fill(fingerprints.begin(), fingerprints.end(), 0);
+			count = 0;
+		}
+
+		// Returns the number of stored states.
+		size_t size() const noexcept
+		{
+			return count;
+		}
+
+		// Returns the max number of stored states.
+		size_t capacity() const noexcept
+		{
+			return fingerprints.size();
+		}
+
+		// Writes the occupied slots, each as its distance from the previous one followed by its fingerprint.
+		void save(StrategyStateWriter& writer) const
+		{
+			writer.write(fingerprints.size());
+			writer.write(count);
+			size_t previous = 0;
+			for (size_t slot = 0; slot < fingerprints.size(); slot++)
+			{
+				if (fingerprints[slot] != 0)
+				{
+					writer.write(slot - previous);
+					writer.write(fingerprints[slot]);
+					previous = slot;
+				}
+			}
+		}
+
+		// Restores the states that were written by 'save' into a set with the same capacity.
+		void restore(StrategyStateReader& reader)
+		{
+			if (reader.read() != fingerprints.size())
+			{
+				throw ErrorCode::InvalidCheckpoint;
+			}
+
+			clear();
+			size_t state_count = (size_t)reader.read(fingerprints.size());
+			size_t slot = 0;
+			for (size_t i = 0; i < state_count; i++)
+			{
+				size_t distance = (size_t)reader.read(fingerprints.size() - 1 - slot);
+				if (i > 0 && distance == 0)
+				{
+					throw ErrorCode::InvalidCheckpoint;
+				}
+
+				slot += distance;
+				fingerprints[slot] = (uint32_t)reader.read(UINT32_MAX);
+				if (fingerprints[slot] == 0)
+				{
+					throw ErrorCode::InvalidCheckpoint;
+				}
+			}
+
+			count = state_count;
+		}
+
+	private:
+		// Returns the fingerprint of the specified hash, from its bits that do not select the slot. The
+		// fingerprint '0', which marks empty slots, is mapped to another fingerprint.
+		static uint32_t to_fingerprint(uint64_t hash) noexcept
+		{
+			uint32_t fingerprint = (uint32_t)(hash >> 32);
+			return fingerprint == 0 ? 1 : fingerprint;
+		}
+	};
+}
+
+#endif // COYOTE_VISITED_STATES_H
@@ -0,0 +1,283 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_CHROME_TRACE_H
+#define COYOTE_CHROME_TRACE_H
+
+#include <cstdint>
+#include <iomanip>
+#include <map>
+#include <ostream>
+#include <string>
+#include "trace_event.h"
+
+namespace coyote
+{
+	// Converts scheduler trace records to the Chrome Trace Event JSON format, which can be opened in
+	// 'chrome://tracing' or in the Perfetto UI. Each testing iteration is shown as a process, and each
+	// operation as a thread whose track shows when it was running, blocked, or waiting for newly created
+	// operations to start. Handoffs between operations are shown as flow arrows.
+	class ChromeTraceWriter
+	{
+	private:
+		// Kinds of spans that an operation track can show.
+		enum class SpanKind
+		{
+			None = 0,
+			Running,
+			Blocked,
+			WaitingPendingOperations
+		};
+
+		// The open span of an operation.
+		struct Span
+		{
+			SpanKind kind;
+			uint64_t start;
+			std::string name;
+		};
+
+		// The output stream.
+		std::ostream& out;
+
+		// True if no event has been written yet, else false.
+		bool is_first_event;
+
+		// The current testing iteration.
+		uint32_t iteration;
+
+		// Map from operation ids to their open span in the current iteration.
+		std::map<uint64_t, Span> spans;
+
+		// Map from the ids of blocked operations to the name of the event that they are blocked on.
+		std::map<uint64_t, std::string> blocked_operations;
+
+		// Counter that assigns unique ids to handoff flows.
+		uint64_t flow_count;
+
+		// The timestamp of the last record.
+		uint64_t last_timestamp;
+
+	public:
+		ChromeTraceWriter(std::ostream& out) :
+			out(out),
+			is_first_event(true),
+			iteration(0),
+			flow_count(0),
+			last_timestamp(0)
+		{
+			out << "{\"traceEvents\":[";
+		}
+
+		ChromeTraceWriter(ChromeTraceWriter&& writer) = delete;
+		ChromeTraceWriter(ChromeTraceWriter const&) = delete;
+
+		ChromeTraceWriter& operator=(ChromeTraceWriter&& writer) = delete;
+		ChromeTraceWriter& operator=(ChromeTraceWriter const&) = delete;
+
+		// Converts the specified record.
+		void write(const TraceRecord& record)
+		{
+			last_timestamp = record.timestamp;
+			if (record.iteration != iteration)
+			{
+				close_spans(record.timestamp);
+				blocked_operations.clear();
+				iteration = record.iteration;
+				write_metadata("process_name", 0, "iteration " + std::to_string(iteration));
+			}
+
+			uint64_t op = record.operation_id;
+			switch (record.type)
+			{
+			case TraceEventType::Attach:
+				open_span(op, SpanKind::Running, "running", record.timestamp);
+				break;
+			case TraceEventType::Detach:
+				close_spans(record.timestamp);
+				blocked_operations.clear();
+				write_instant(op, "detach", record.timestamp);
+				break;
+			case TraceEventType::CreateOperation:
+				write_thread_name(op);
+				if (op != record.value)
+				{
+					write_instant(record.value, "create operation " + std::to_string(op), record.timestamp);
+				}
+
+				break;
+			case TraceEventType::CompleteOperation:
+				close_span(op, record.timestamp);
+				write_instant(op, "complete", record.timestamp);
+				break;
+			case TraceEventType::JoinOperation:
+				block_operation(op, "join operation " + std::to_string(record.value), record.timestamp);
+				break;
+			case TraceEventType::WaitResource:
+				block_operation(op, "wait resource " + std::to_string(record.value), record.timestamp);
+				break;
+			case TraceEventType::EnableOperation:
+				blocked_operations.erase(op);
+				close_span(op, record.timestamp);
+				break;
+			case TraceEventType::WaitPendingOperations:
+				open_span(op, SpanKind::WaitingPendingOperations, "wait pending operations", record.timestamp);
+				break;
+			case TraceEventType::ResumePendingOperations:
+				if (blocked_operations.find(op) != blocked_operations.end())
+				{
+					open_span(op, SpanKind::Blocked, blocked_operations[op], record.timestamp);
+				}
+				else
+				{
+					open_span(op, SpanKind::Running, "running", record.timestamp);
+				}
+
+				break;
+			case TraceEventType::ScheduleNext:
+				if (op != record.value)
+				{
+					auto it = spans.find(op);
+					if (it != spans.end() && it->second.kind == SpanKind::Running)
+					{
+						close_span(op, record.timestamp);
+					}
+
+					write_flow(op, record.value, record.timestamp);
+					open_span(record.value, SpanKind::Running, "running", record.timestamp);
+				}
+
+				break;
+			case TraceEventType::CreateResource:
+				write_instant(op, "create resource " + std::to_string(record.value), record.timestamp);
+				break;
+			case TraceEventType::SignalResource:
+				write_instant(op, "signal resource " + std::to_string(record.value), record.timestamp);
+				break;
+			case TraceEventType::DeleteResource:
+				write_instant(op, "delete resource " + std::to_string(record.value), record.timestamp);
+				break;
+			case TraceEventType::DeadlockDetected:
+				write_instant(op, "deadlock detected", record.timestamp);
+				break;
+			case TraceEventType::DroppedEvents:
+				write_instant(op, "dropped " + std::to_string(record.value) + " events", record.timestamp);
+				break;
+			case TraceEventType::NextBoolean:
+				write_instant(op, record.value != 0 ? "next boolean true" : "next boolean false", record.timestamp);
+				break;
+			case TraceEventType::NextInteger:
+				write_instant(op, "next integer " + std::to_string((int64_t)record.value), record.timestamp);
+				break;
+			default:
+				break;
+			}
+		}
+
+		// Closes all open spans and completes the JSON document.
+		void finish()
+		{
+			close_spans(last_timestamp);
+			out << "]}" << std::endl;
+		}
+
+	private:
+		void block_operation(uint64_t op, const std::string& name, uint64_t timestamp)
+		{
+			if (blocked_operations.find(op) == blocked_operations.end())
+			{
+				blocked_operations[op] = name;
+				open_span(op, SpanKind::Blocked, name, timestamp);
+			}
+		}
+
+		// Opens a span of the specified kind, closing the currently open span of the operation, if any.
+		void open_span(uint64_t op, SpanKind kind, const std::string& name, uint64_t timestamp)
+		{
+			auto it = spans.find(op);
+			if (it != spans.end() && it->second.kind == kind && it->second.name == name)
+			{
+				return;
+			}
+
+			close_span(op, timestamp);
+			spans[op] = { kind, timestamp, name };
+		}
+
+		void close_span(uint64_t op, uint64_t timestamp)
+		{
+			auto it = spans.find(op);
+			if (it != spans.end())
+			{
+				begin_event(it->second.name, "X", op, it->second.start);
+				out << ",\"dur\":";
+				write_microseconds(timestamp - it->second.start);
+				out << "}";
+				spans.erase(it);
+			}
+		}
+
+		void close_spans(uint64_t timestamp)
+		{
+			while (!spans.empty())
+			{
+				close_span(spans.begin()->first, timestamp);
+			}
+		}
+
+		void write_instant(uint64_t op, const std::string& name, uint64_t timestamp)
+		{
+			begin_event(name, "i", op, timestamp);
+			out << ",\"s\":\"t\"}";
+		}
+
+		void write_flow(uint64_t from_op, uint64_t to_op, uint64_t timestamp)
+		{
+			flow_count++;
+			begin_event("handoff", "s", from_op, timestamp);
+			out << ",\"id\":" << flow_count << "}";
+			begin_event("handoff", "f", to_op, timestamp);
+			out << ",\"id\":" << flow_count << ",\"bp\":\"e\"}";
+		}
+
+		void write_thread_name(uint64_t op)
+		{
+			write_metadata("thread_name", op, "operation " + std::to_string(op));
+		}
+
+		void write_metadata(const std::string& name, uint64_t op, const std::string& value)
+		{
+			next_event();
+			out << "{\"name\":\"" << name << "\",\"ph\":\"M\",\"pid\":" << iteration << ",\"tid\":" << op <<
+				",\"args\":{\"name\":\"" << value << "\"}}";
+		}
+
+		// Writes the common fields of an event, leaving the JSON object open.
+		void begin_event(const std::string& name, const char* phase, uint64_t op, uint64_t timestamp)
+		{
+			next_event();
+			out << "{\"name\":\"" << name << "\",\"cat\":\"coyote\",\"ph\":\"" << phase << "\",\"pid\":" <<
+				iteration << ",\"tid\":" << op << ",\"ts\":";
+			write_microseconds(timestamp);
+		}
+
+		void next_event()
+		{
+			if (!is_first_event)
+			{
+				out << ",";
+			}
+
+			out << "\n";
+			is_first_event = false;
+		}
+
+		void write_microseconds(uint64_t nanoseconds)
+		{
+			out << (nanoseconds / 1000) << "." << std::setw(3) << std::setfill('0') << (nanoseconds % 1000) <<
+				std::setfill(' ');
+		}
+	};
+}
+
+#endif // COYOTE_CHROME_TRACE_H
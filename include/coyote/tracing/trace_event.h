@@ -0,0 +1,120 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_TRACE_EVENT_H
+#define COYOTE_TRACE_EVENT_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace coyote
+{
+	// Types of events that the scheduler can trace.
+	enum class TraceEventType : uint32_t
+	{
+		None = 0,
+		Attach,
+		Detach,
+		CreateOperation,
+		StartOperation,
+		CompleteOperation,
+		JoinOperation,
+		CreateResource,
+		WaitResource,
+		SignalResource,
+		DeleteResource,
+		EnableOperation,
+		WaitPendingOperations,
+		ResumePendingOperations,
+		ScheduleNext,
+		DeadlockDetected,
+		DroppedEvents,
+		NextBoolean,
+		NextInteger
+	};
+
+	// Fixed-size binary record of a traced event.
+	struct TraceRecord
+	{
+		// Nanoseconds since the tracer started.
+		uint64_t timestamp;
+
+		// The type of the event.
+		TraceEventType type;
+
+		// The testing iteration during which the event happened.
+		uint32_t iteration;
+
+		// The operation that the event is about.
+		uint64_t operation_id;
+
+		// An event specific value, such as a resource id or the next scheduled operation.
+		uint64_t value;
+	};
+
+	static_assert(sizeof(TraceRecord) == 32, "unexpected trace record size");
+
+	// Header at the beginning of a trace file, which is followed by trace records.
+	struct TraceFileHeader
+	{
+		// Identifies a trace file.
+		char magic[8];
+
+		// The version of the trace format.
+		uint32_t version;
+
+		// The size of each trace record in bytes.
+		uint32_t record_size;
+	};
+
+	constexpr char TRACE_FILE_MAGIC[8] = { 'C', 'O', 'Y', 'T', 'R', 'A', 'C', 'E' };
+	constexpr uint32_t TRACE_FILE_VERSION = 1;
+
+	// Returns the name of the specified event type.
+	inline const char* trace_event_name(TraceEventType type) noexcept
+	{
+		switch (type)
+		{
+		case TraceEventType::Attach:
+			return "attach";
+		case TraceEventType::Detach:
+			return "detach";
+		case TraceEventType::CreateOperation:
+			return "create_operation";
+		case TraceEventType::StartOperation:
+			return "start_operation";
+		case TraceEventType::CompleteOperation:
+			return "complete_operation";
+		case TraceEventType::JoinOperation:
+			return "join_operation";
+		case TraceEventType::CreateResource:
+			return "create_resource";
+		case TraceEventType::WaitResource:
+			return "wait_resource";
+		case TraceEventType::SignalResource:
+			return "signal_resource";
+		case TraceEventType::DeleteResource:
+			return "delete_resource";
+		case TraceEventType::EnableOperation:
+			return "enable_operation";
+		case TraceEventType::WaitPendingOperations:
+			return "wait_pending_operations";
+		case TraceEventType::ResumePendingOperations:
+			return "resume_pending_operations";
+		case TraceEventType::ScheduleNext:
+			return "schedule_next";
+		case TraceEventType::DeadlockDetected:
+			return "deadlock_detected";
+		case TraceEventType::DroppedEvents:
+			return "dropped_events";
+		case TraceEventType::NextBoolean:
+			return "next_boolean";
+		case TraceEventType::NextInteger:
+			return "next_integer";
+		default:
+			return "unknown";
+		}
+	}
+}
+
+#endif // COYOTE_TRACE_EVENT_H
@@ -0,0 +1,89 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_TRACE_READER_H
+#define COYOTE_TRACE_READER_H
+
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "trace_event.h"
+
+namespace coyote
+{
+	// Streams the records of a trace file that was written by a 'Tracer'.
+	class TraceReader
+	{
+	private:
+		// The trace file.
+		std::ifstream file;
+
+		// Buffer of records that were read from the file, but not returned yet.
+		std::vector<TraceRecord> buffer;
+
+		// The index of the next record to return from the buffer.
+		size_t buffer_index;
+
+		// The number of valid records in the buffer.
+		size_t buffer_size;
+
+	public:
+		TraceReader() noexcept :
+			buffer_index(0),
+			buffer_size(0)
+		{
+		}
+
+		TraceReader(TraceReader&& reader) = delete;
+		TraceReader(TraceReader const&) = delete;
+
+		TraceReader& operator=(TraceReader&& reader) = delete;
+		TraceReader& operator=(TraceReader const&) = delete;
+
+		// Opens the specified trace file. Returns false if it is not a valid trace file.
+		bool open(const std::string& path)
+		{
+			file.open(path, std::ios::binary);
+			TraceFileHeader header;
+			if (!file.read((char*)&header, sizeof(header)) ||
+				std::memcmp(header.magic, TRACE_FILE_MAGIC, sizeof(header.magic)) != 0 ||
+				header.version != TRACE_FILE_VERSION ||
+				header.record_size != sizeof(TraceRecord))
+			{
+				file.close();
+				return false;
+			}
+
+			buffer.resize(4096);
+			buffer_index = 0;
+			buffer_size = 0;
+			return true;
+		}
+
+		// Reads the next record. Returns false if there are no more records.
+		bool next(TraceRecord& record)
+		{
+			if (buffer_index == buffer_size)
+			{
+				if (!file.is_open())
+				{
+					return false;
+				}
+
+				file.read((char*)buffer.data(), buffer.size() * sizeof(TraceRecord));
+				buffer_size = (size_t)file.gcount() / sizeof(TraceRecord);
+				buffer_index = 0;
+				if (buffer_size == 0)
+				{
+					return false;
+				}
+			}
+
+			record = buffer[buffer_index++];
+			return true;
+		}
+	};
+}
+
+#endif // COYOTE_TRACE_READER_H
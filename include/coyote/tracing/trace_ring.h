@@ -0,0 +1,96 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_TRACE_RING_H
+#define COYOTE_TRACE_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include "trace_event.h"
+
+namespace coyote
+{
+	// Bounded lock-free ring of trace records with a single producer and a single consumer. The scheduler
+	// only produces records while holding its lock, so producers on different threads never overlap.
+	class TraceRing
+	{
+	private:
+		// The records of the ring.
+		std::unique_ptr<TraceRecord[]> records;
+
+		// Mask used to map a position to a record, which requires a power of two capacity.
+		const uint64_t mask;
+
+		// The next position that the producer will write to.
+		alignas(64) std::atomic<uint64_t> write_pos;
+
+		// The next position that the consumer will read from.
+		alignas(64) std::atomic<uint64_t> read_pos;
+
+	public:
+		TraceRing(size_t capacity) :
+			records(std::make_unique<TraceRecord[]>(round_up_capacity(capacity))),
+			mask(round_up_capacity(capacity) - 1),
+			write_pos(0),
+			read_pos(0)
+		{
+		}
+
+		TraceRing(TraceRing&& ring) = delete;
+		TraceRing(TraceRing const&) = delete;
+
+		TraceRing& operator=(TraceRing&& ring) = delete;
+		TraceRing& operator=(TraceRing const&) = delete;
+
+		// Tries to write the specified record. Returns false if the ring is full.
+		bool try_write(const TraceRecord& record) noexcept
+		{
+			uint64_t pos = write_pos.load(std::memory_order_relaxed);
+			if (pos - read_pos.load(std::memory_order_acquire) > mask)
+			{
+				return false;
+			}
+
+			records[pos & mask] = record;
+			write_pos.store(pos + 1, std::memory_order_release);
+			return true;
+		}
+
+		// Reads up to the specified number of records into the buffer and returns how many were read.
+		size_t read(TraceRecord* buffer, size_t size) noexcept
+		{
+			uint64_t pos = read_pos.load(std::memory_order_relaxed);
+			uint64_t available = write_pos.load(std::memory_order_acquire) - pos;
+			size_t count = available < size ? (size_t)available : size;
+			for (size_t i = 0; i < count; i++)
+			{
+				buffer[i] = records[(pos + i) & mask];
+			}
+
+			read_pos.store(pos + count, std::memory_order_release);
+			return count;
+		}
+
+		// Returns the max number of records that the ring can hold.
+		size_t capacity() const noexcept
+		{
+			return (size_t)mask + 1;
+		}
+
+	private:
+		static size_t round_up_capacity(size_t capacity) noexcept
+		{
+			size_t result = 2;
+			while (result < capacity)
+			{
+				result <<= 1;
+			}
+
+			return result;
+		}
+	};
+}
+
+#endif // COYOTE_TRACE_RING_H
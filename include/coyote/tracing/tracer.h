@@ -0,0 +1,154 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#ifndef COYOTE_TRACER_H
+#define COYOTE_TRACER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "trace_event.h"
+#include "trace_ring.h"
+
+namespace coyote
+{
+	// Traces scheduler events into a lock-free ring, which a background thread drains to a file. Recording
+	// an event never blocks nor flushes, so tracing barely perturbs the explored interleavings. If the ring
+	// is full, events are dropped and a 'DroppedEvents' record with their count is written once there is
+	// space again.
+	class Tracer
+	{
+	private:
+		// Ring of records that have not been written yet.
+		TraceRing ring;
+
+		// The trace file.
+		std::ofstream file;
+
+		// Thread that drains the ring to the file.
+		std::thread writer_thread;
+
+		// Mutex and conditional variable that are used to wake up the writer thread.
+		std::mutex writer_mutex;
+		std::condition_variable writer_cv;
+
+		// True if the tracer is stopping, else false.
+		bool is_stopping;
+
+		// The time when the tracer started.
+		const std::chrono::steady_clock::time_point start_time;
+
+		// The current testing iteration.
+		uint32_t iteration;
+
+		// Count of events that were dropped since the last written record.
+		uint64_t dropped_count;
+
+		// Interval between two drains of the ring.
+		static constexpr std::chrono::milliseconds DRAIN_INTERVAL = std::chrono::milliseconds(1);
+
+	public:
+		Tracer(const std::string& path, size_t capacity) :
+			ring(capacity),
+			file(path, std::ios::binary | std::ios::trunc),
+			is_stopping(false),
+			start_time(std::chrono::steady_clock::now()),
+			iteration(0),
+			dropped_count(0)
+		{
+			TraceFileHeader header;
+			std::memcpy(header.magic, TRACE_FILE_MAGIC, sizeof(header.magic));
+			header.version = TRACE_FILE_VERSION;
+			header.record_size = sizeof(TraceRecord);
+			file.write((const char*)&header, sizeof(header));
+			writer_thread = std::thread(&Tracer::drain_loop, this);
+		}
+
+		Tracer(Tracer&& tracer) = delete;
+		Tracer(Tracer const&) = delete;
+
+		Tracer& operator=(Tracer&& tracer) = delete;
+		Tracer& operator=(Tracer const&) = delete;
+
+		~Tracer()
+		{
+			{
+				std::unique_lock<std::mutex> lock(writer_mutex);
+				is_stopping = true;
+			}
+
+			writer_cv.notify_all();
+			writer_thread.join();
+			file.close();
+		}
+
+		// Sets the testing iteration of the records that follow.
+		void set_iteration(size_t value) noexcept
+		{
+			iteration = (uint32_t)value;
+		}
+
+		// Records the specified event. This must not be called concurrently.
+		void record(TraceEventType type, uint64_t operation_id, uint64_t value) noexcept
+		{
+			uint64_t timestamp = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now() - start_time).count();
+			if (dropped_count > 0)
+			{
+				if (!ring.try_write({ timestamp, TraceEventType::DroppedEvents, iteration, 0, dropped_count }))
+				{
+					dropped_count++;
+					return;
+				}
+
+				dropped_count = 0;
+			}
+
+			if (!ring.try_write({ timestamp, type, iteration, operation_id, value }))
+			{
+				dropped_count++;
+			}
+		}
+
+		// Returns true if the trace file could be opened, else false.
+		bool is_open() const noexcept
+		{
+			return file.is_open();
+		}
+
+	private:
+		void drain_loop()
+		{
+			std::vector<TraceRecord> buffer(1024);
+			std::unique_lock<std::mutex> lock(writer_mutex);
+			while (true)
+			{
+				bool is_final = is_stopping;
+				lock.unlock();
+
+				size_t count;
+				while ((count = ring.read(buffer.data(), buffer.size())) > 0)
+				{
+					file.write((const char*)buffer.data(), count * sizeof(TraceRecord));
+				}
+
+				lock.lock();
+				if (is_final)
+				{
+					break;
+				}
+
+				writer_cv.wait_for(lock, DRAIN_INTERVAL, [this] { return is_stopping; });
+			}
+
+			file.flush();
+		}
+	};
+}
+
+#endif // COYOTE_TRACER_H
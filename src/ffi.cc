@@ -48,6 +48,13 @@ extern "C"
         return static_cast<std::underlying_type_t<ErrorCode>>(error_code);
     }
 
+    COYOTE_API int create_operations(void* scheduler, size_t* operation_ids, size_t size)
+    {
+        Scheduler* ptr = (Scheduler*)scheduler;
+        ErrorCode error_code = ptr->create_operations(operation_ids, size);
+        return static_cast<std::underlying_type_t<ErrorCode>>(error_code);
+    }
+
     COYOTE_API int start_operation(void* scheduler, size_t operation_id)
     {
         Scheduler* ptr = (Scheduler*)scheduler;
@@ -83,6 +90,13 @@ extern "C"
         return static_cast<std::underlying_type_t<ErrorCode>>(error_code);
     }
 
+    COYOTE_API int create_resources(void* scheduler, size_t* resource_ids, size_t size)
+    {
+        Scheduler* ptr = (Scheduler*)scheduler;
+        ErrorCode error_code = ptr->create_resources(resource_ids, size);
+        return static_cast<std::underlying_type_t<ErrorCode>>(error_code);
+    }
+
     COYOTE_API int wait_resource(void* scheduler, size_t resource_id)
     {
         Scheduler* ptr = (Scheduler*)scheduler;
@@ -104,6 +118,20 @@ extern "C"
         return static_cast<std::underlying_type_t<ErrorCode>>(error_code);
     }
 
+    COYOTE_API int signal_operation_resource(void* scheduler, size_t resource_id, size_t operation_id)
+    {
+        Scheduler* ptr = (Scheduler*)scheduler;
+        ErrorCode error_code = ptr->signal_resource(resource_id, operation_id);
+        return static_cast<std::underlying_type_t<ErrorCode>>(error_code);
+    }
+
+    COYOTE_API int signal_operation_resources(void* scheduler, size_t* resource_ids, size_t* operation_ids, size_t size)
+    {
+        Scheduler* ptr = (Scheduler*)scheduler;
+        ErrorCode error_code = ptr->signal_resources(resource_ids, operation_ids, size);
+        return static_cast<std::underlying_type_t<ErrorCode>>(error_code);
+    }
+
     COYOTE_API int delete_resource(void* scheduler, size_t resource_id)
     {
         Scheduler* ptr = (Scheduler*)scheduler;
@@ -111,6 +139,13 @@ extern "C"
         return static_cast<std::underlying_type_t<ErrorCode>>(error_code);
     }
 
+    COYOTE_API int delete_resources(void* scheduler, size_t* resource_ids, size_t size)
+    {
+        Scheduler* ptr = (Scheduler*)scheduler;
+        ErrorCode error_code = ptr->delete_resources(resource_ids, size);
+        return static_cast<std::underlying_type_t<ErrorCode>>(error_code);
+    }
+
     COYOTE_API int schedule_next(void* scheduler)
     {
         Scheduler* ptr = (Scheduler*)scheduler;
@@ -118,6 +153,38 @@ extern "C"
         return static_cast<std::underlying_type_t<ErrorCode>>(error_code);
     }
 
+    COYOTE_API void* enable_command_ring(void* scheduler, size_t capacity)
+    {
+        Scheduler* ptr = (Scheduler*)scheduler;
+        return ptr->enable_command_ring(capacity);
+    }
+
+    COYOTE_API bool enqueue_command(void* command_ring, int command_type, size_t arg0, size_t arg1)
+    {
+        CommandRing* ptr = (CommandRing*)command_ring;
+        return ptr->try_enqueue(static_cast<CommandType>(command_type), arg0, arg1);
+    }
+
+    COYOTE_API int flush_commands(void* scheduler)
+    {
+        Scheduler* ptr = (Scheduler*)scheduler;
+        ErrorCode error_code = ptr->flush_commands();
+        return static_cast<std::underlying_type_t<ErrorCode>>(error_code);
+    }
+
+    COYOTE_API int operation_statuses(void* scheduler, size_t* operation_ids, size_t size, int* statuses)
+    {
+        Scheduler* ptr = (Scheduler*)scheduler;
+        std::vector<OperationStatus> buffer(size);
+        ErrorCode error_code = ptr->operation_statuses(operation_ids, size, buffer.data());
+        for (size_t i = 0; i < size; i++)
+        {
+            statuses[i] = static_cast<std::underlying_type_t<OperationStatus>>(buffer[i]);
+        }
+
+        return static_cast<std::underlying_type_t<ErrorCode>>(error_code);
+    }
+
     COYOTE_API int next_boolean(void* scheduler)
     {
         Scheduler* ptr = (Scheduler*)scheduler;
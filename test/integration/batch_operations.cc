@@ -0,0 +1,110 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <thread>
+#include <vector>
+#include "test.h"
+
+using namespace coyote;
+
+constexpr auto WORKER_COUNT = 4;
+
+Scheduler* scheduler;
+
+size_t operation_ids[WORKER_COUNT];
+size_t resource_ids[WORKER_COUNT];
+
+void work(size_t index)
+{
+	scheduler->start_operation(operation_ids[index]);
+	scheduler->wait_resource(resource_ids[index]);
+	scheduler->complete_operation(operation_ids[index]);
+}
+
+void run_iteration()
+{
+	scheduler->attach();
+
+	assert(scheduler->create_operations(operation_ids, WORKER_COUNT), ErrorCode::Success);
+	assert(scheduler->create_resources(resource_ids, WORKER_COUNT), ErrorCode::Success);
+
+	std::vector<std::thread> threads;
+	for (size_t i = 0; i < WORKER_COUNT; i++)
+	{
+		threads.emplace_back(work, i);
+	}
+
+	// Let all workers block on their resources.
+	while (true)
+	{
+		OperationStatus statuses[WORKER_COUNT];
+		assert(scheduler->operation_statuses(operation_ids, WORKER_COUNT, statuses), ErrorCode::Success);
+
+		bool all_waiting = true;
+		for (size_t i = 0; i < WORKER_COUNT; i++)
+		{
+			all_waiting &= statuses[i] == OperationStatus::WaitAllResources;
+		}
+
+		if (all_waiting)
+		{
+			break;
+		}
+
+		assert(scheduler->schedule_next(), ErrorCode::Success);
+	}
+
+	assert(scheduler->signal_resources(resource_ids, operation_ids, WORKER_COUNT), ErrorCode::Success);
+	assert(scheduler->join_operations(operation_ids, WORKER_COUNT, true), ErrorCode::Success);
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+
+	OperationStatus statuses[WORKER_COUNT];
+	assert(scheduler->operation_statuses(operation_ids, WORKER_COUNT, statuses), ErrorCode::Success);
+	for (size_t i = 0; i < WORKER_COUNT; i++)
+	{
+		assert(statuses[i] == OperationStatus::Completed, "operation has not completed");
+	}
+
+	assert(scheduler->delete_resources(resource_ids, WORKER_COUNT), ErrorCode::Success);
+	assert(scheduler->delete_resources(resource_ids, 1), ErrorCode::NotExistingResource);
+
+	scheduler->detach();
+}
+
+int main()
+{
+	std::cout << "[test] started." << std::endl;
+	auto start_time = std::chrono::steady_clock::now();
+
+	try
+	{
+		for (size_t i = 0; i < WORKER_COUNT; i++)
+		{
+			operation_ids[i] = i + 1;
+			resource_ids[i] = i + 10;
+		}
+
+		scheduler = new Scheduler();
+
+		for (int i = 0; i < 100; i++)
+		{
+#ifdef COYOTE_DEBUG_LOG
+			std::cout << "[test] iteration " << i << std::endl;
+#endif // COYOTE_DEBUG_LOG
+			run_iteration();
+		}
+
+		delete scheduler;
+	}
+	catch (std::string error)
+	{
+		std::cout << "[test] failed: " << error << std::endl;
+		return 1;
+	}
+
+	std::cout << "[test] done in " << total_time(start_time) << "ms." << std::endl;
+	return 0;
+}
@@ -0,0 +1,205 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <thread>
+#include <vector>
+#include "test.h"
+
+using namespace coyote;
+
+constexpr size_t WORKER_COUNT = 3;
+constexpr size_t ITERATIONS = 30;
+constexpr size_t CHECKPOINT_INTERVAL = 10;
+
+// Workers increment a shared counter by a chosen amount with a scheduling point between the read and the
+// write, and report the counter as the program state. Returns the hash of the schedule of the iteration.
+uint64_t run_iteration(Scheduler& scheduler)
+{
+	int counter = 0;
+	auto work = [&scheduler, &counter](size_t operation_id)
+	{
+		scheduler.start_operation(operation_id);
+		int value = counter;
+		scheduler.report_state_hash((uint64_t)value);
+		scheduler.schedule_next();
+		counter = value + scheduler.next_integer(3);
+		scheduler.schedule_next();
+		scheduler.complete_operation(operation_id);
+	};
+
+	scheduler.attach();
+
+	std::vector<std::thread> threads;
+	for (size_t id = 1; id <= WORKER_COUNT; id++)
+	{
+		scheduler.create_operation(id);
+		threads.emplace_back(work, id);
+	}
+
+	for (size_t id = 1; id <= WORKER_COUNT; id++)
+	{
+		scheduler.join_operation(id);
+	}
+
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+
+	scheduler.detach();
+	assert(scheduler.error_code(), ErrorCode::Success);
+	return scheduler.schedule_trace().view().hash();
+}
+
+std::string checkpoint_path()
+{
+	return (std::filesystem::temp_directory_path() / "coyote_campaign_checkpoint.bin").string();
+}
+
+std::unique_ptr<Settings> create_settings(const std::function<void(Settings&)>& configure, bool is_checkpointed)
+{
+	auto settings = std::make_unique<Settings>();
+	configure(*settings);
+	if (is_checkpointed)
+	{
+		settings->enable_checkpoints(checkpoint_path(), CHECKPOINT_INTERVAL);
+	}
+
+	return settings;
+}
+
+// Runs the campaign without interruption, and again in a process that is pre-empted between two checkpoints
+// and then resumed by a new scheduler, which must explore the same schedules.
+void test_resume(const std::string& name, const std::function<void(Settings&)>& configure)
+{
+	std::remove(checkpoint_path().c_str());
+
+	std::vector<uint64_t> expected_hashes;
+	{
+		Scheduler scheduler(create_settings(configure, false));
+		for (size_t i = 0; i < ITERATIONS; i++)
+		{
+			expected_hashes.push_back(run_iteration(scheduler));
+		}
+	}
+
+	{
+		Scheduler scheduler(create_settings(configure, true));
+		assert(scheduler.iterations() == 0, name + ": unexpected resumed iterations");
+		for (size_t i = 0; i < CHECKPOINT_INTERVAL + CHECKPOINT_INTERVAL / 2; i++)
+		{
+			assert(run_iteration(scheduler) == expected_hashes[i], name + ": unexpected schedule");
+		}
+	}
+
+	Scheduler scheduler(create_settings(configure, true));
+	assert(scheduler.error_code(), ErrorCode::Success);
+	assert(scheduler.iterations() == CHECKPOINT_INTERVAL, name + ": campaign was not resumed");
+	while (scheduler.iterations() < ITERATIONS)
+	{
+		size_t iteration = scheduler.iterations();
+		assert(run_iteration(scheduler) == expected_hashes[iteration], name + ": resumed schedule diverged");
+	}
+
+	std::remove(checkpoint_path().c_str());
+}
+
+std::vector<char> read_file(const std::string& path)
+{
+	std::ifstream file(path, std::ios::binary);
+	return std::vector<char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+void test_invalid_checkpoints()
+{
+	std::string path = checkpoint_path();
+	std::remove(path.c_str());
+	{
+		Scheduler scheduler(create_settings([](Settings& settings) { settings.use_pct_strategy(7, 3); }, true));
+		assert(scheduler.restore_checkpoint(path), ErrorCode::InvalidCheckpoint);
+		for (size_t i = 0; i < CHECKPOINT_INTERVAL; i++)
+		{
+			run_iteration(scheduler);
+		}
+
+		// A checkpoint can only be taken between iterations.
+		scheduler.attach();
+		assert(scheduler.save_checkpoint(path), ErrorCode::ClientAttached);
+		scheduler.detach();
+	}
+
+	{
+		// A campaign with other settings does not resume from the checkpoint, and does not overwrite it.
+		std::vector<char> bytes = read_file(path);
+		Scheduler scheduler(create_settings([](Settings& settings) { settings.use_pct_strategy(8, 3); }, true));
+		assert(scheduler.error_code(), ErrorCode::InvalidCheckpoint);
+		assert(scheduler.iterations() == 0, "checkpoint of another campaign was restored");
+		for (size_t i = 0; i < 2 * CHECKPOINT_INTERVAL; i++)
+		{
+			run_iteration(scheduler);
+		}
+
+		assert(read_file(path) == bytes, "checkpoint of another campaign was overwritten");
+	}
+
+	{
+		// The original campaign still resumes from its checkpoint.
+		Scheduler scheduler(create_settings([](Settings& settings) { settings.use_pct_strategy(7, 3); }, true));
+		assert(scheduler.error_code(), ErrorCode::Success);
+		assert(scheduler.iterations() == CHECKPOINT_INTERVAL, "campaign was not resumed");
+	}
+
+	{
+		// A corrupted checkpoint is rejected.
+		std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+		file.seekp(-1, std::ios::end);
+		file.put('\x7f');
+		file.close();
+
+		Scheduler scheduler(create_settings([](Settings& settings) { settings.use_pct_strategy(7, 3); }, true));
+		assert(scheduler.error_code(), ErrorCode::InvalidCheckpoint);
+		assert(scheduler.iterations() == 0, "corrupted checkpoint was restored");
+	}
+
+	std::remove(path.c_str());
+}
+
+int main()
+{
+	std::cout << "[test] started." << std::endl;
+	auto start_time = std::chrono::steady_clock::now();
+
+	try
+	{
+		test_resume("random", [](Settings& settings) { settings.use_random_strategy(42, 50); });
+		test_resume("pct", [](Settings& settings) { settings.use_pct_strategy(42, 3); });
+		test_resume("pos", [](Settings& settings) { settings.use_pos_strategy(42); });
+		test_resume("qlearning", [](Settings& settings) { settings.use_qlearning_strategy(42, 10, 1 << 10); });
+		test_resume("dfs", [](Settings& settings)
+		{
+			settings.use_dfs_strategy();
+			settings.enable_state_caching(1 << 10);
+		});
+		test_resume("portfolio", [](Settings& settings) { settings.use_portfolio_strategy(42); });
+		test_resume("bandit", [](Settings& settings) { settings.use_bandit_strategy(42); });
+		test_resume("fair", [](Settings& settings)
+		{
+			settings.use_pct_strategy(42, 3);
+			settings.enable_fair_scheduling(4, FairSchedulingMode::Random);
+		});
+		test_invalid_checkpoints();
+	}
+	catch (std::string error)
+	{
+		std::cout << "[test] failed: " << error << std::endl;
+		return 1;
+	}
+
+	std::cout << "[test] done in " << total_time(start_time) << "ms." << std::endl;
+	return 0;
+}
@@ -0,0 +1,214 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "test.h"
+
+#ifndef _WIN32
+
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/wait.h>
+#include "coyote/service/campaign_coordinator.h"
+
+using namespace coyote;
+
+constexpr size_t WORKER_COUNT = 2;
+constexpr size_t SHARD_COUNT = 6;
+constexpr uint64_t SHARD_ITERATIONS = 20;
+constexpr uint64_t LOST_UPDATE = 1;
+
+std::string executable_path;
+std::string socket_path;
+
+// Workers increment a shared counter with a scheduling point between the read and the write. Returns a
+// nonzero failure signature if an update was lost.
+uint64_t run_iteration(Scheduler& scheduler)
+{
+	int counter = 0;
+	auto work = [&scheduler, &counter](size_t operation_id)
+	{
+		scheduler.start_operation(operation_id);
+		int value = counter;
+		scheduler.schedule_next();
+		counter = value + 1;
+		scheduler.complete_operation(operation_id);
+	};
+
+	scheduler.attach();
+
+	std::vector<std::thread> threads;
+	for (size_t id = 1; id <= WORKER_COUNT; id++)
+	{
+		scheduler.create_operation(id);
+		threads.emplace_back(work, id);
+	}
+
+	for (size_t id = 1; id <= WORKER_COUNT; id++)
+	{
+		scheduler.join_operation(id);
+	}
+
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+
+	scheduler.detach();
+	assert(scheduler.error_code(), ErrorCode::Success);
+	return counter == (int)WORKER_COUNT ? 0 : LOST_UPDATE;
+}
+
+// Runs shards until the campaign completes, or takes a single shard and exits without completing it if the
+// worker is lost. Returns zero if all calls succeeded.
+int run_worker(bool is_lost)
+{
+	CoordinatorClient client;
+	if (client.connect(socket_path) != ErrorCode::Success)
+	{
+		return 1;
+	}
+
+	CampaignShard shard;
+	if (is_lost)
+	{
+		return client.request_shard(shard) ? 0 : 1;
+	}
+
+	ShardRunner runner(run_iteration);
+	while (client.request_shard(shard))
+	{
+		if (client.complete_shard(shard, runner.run(shard)) != ErrorCode::Success)
+		{
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+// Runs a worker in a new process of this executable.
+pid_t spawn_worker(const char* mode)
+{
+	std::string worker_mode(mode);
+	char* args[] = { &executable_path[0], &socket_path[0], &worker_mode[0], nullptr };
+	pid_t pid = fork();
+	if (pid == 0)
+	{
+		execv(args[0], args);
+		_exit(1);
+	}
+
+	return pid;
+}
+
+void wait_worker(pid_t pid)
+{
+	int status = 0;
+	waitpid(pid, &status, 0);
+	assert(WIFEXITED(status) && WEXITSTATUS(status) == 0, "worker failed");
+}
+
+void test_campaign()
+{
+	CampaignCoordinator coordinator(socket_path, StrategyType::PCT, 42, 2, SHARD_COUNT, SHARD_ITERATIONS);
+	assert(coordinator.start(), ErrorCode::Success);
+
+	// A worker that is lost after taking a shard does not lose the shard.
+	wait_worker(spawn_worker("lost"));
+
+	std::vector<pid_t> workers;
+	for (size_t i = 0; i < 3; i++)
+	{
+		workers.push_back(spawn_worker("worker"));
+	}
+
+	CampaignSummary summary = coordinator.wait();
+	for (pid_t pid : workers)
+	{
+		wait_worker(pid);
+	}
+
+	coordinator.stop();
+
+	// The shards are deterministic, so the merged results are the same as when running them in order.
+	CampaignSummary expected;
+	ShardRunner runner(run_iteration);
+	for (uint64_t i = 0; i < SHARD_COUNT; i++)
+	{
+		expected.merge(runner.run(coordinator.shard(i)));
+	}
+
+	assert(summary.completed_shards == SHARD_COUNT, "shards were not all completed");
+	assert(summary.iterations == SHARD_COUNT * SHARD_ITERATIONS, "unexpected iterations");
+	assert(summary.failures == expected.failures && summary.failures > 0, "unexpected failures");
+	assert(summary.coverage == expected.coverage, "unexpected coverage");
+	assert(summary.bugs.size() == 1 && expected.bugs.size() == 1, "failures were not deduplicated");
+
+	// The bug is reproduced from its token on any machine.
+	const ReproductionToken& token = summary.bugs.at(LOST_UPDATE).token;
+	assert(token.worker == expected.bugs.at(LOST_UPDATE).token.worker &&
+		token.iteration == expected.bugs.at(LOST_UPDATE).token.iteration, "unexpected bug");
+	auto settings = std::make_unique<Settings>();
+	settings->reproduce(token);
+	Scheduler scheduler(std::move(settings));
+	assert(run_iteration(scheduler) == LOST_UPDATE, "bug was not reproduced");
+}
+
+// Campaigns whose bugs cannot be reproduced from a token are rejected.
+void test_invalid_campaigns()
+{
+	for (StrategyType strategy : { StrategyType::DFS, StrategyType::Replay, StrategyType::QLearning })
+	{
+		bool is_rejected = false;
+		try
+		{
+			CampaignCoordinator coordinator(socket_path, strategy, 42, 2, SHARD_COUNT, SHARD_ITERATIONS);
+		}
+		catch (const std::invalid_argument&)
+		{
+			is_rejected = true;
+		}
+
+		assert(is_rejected, "campaign was not rejected");
+	}
+}
+
+int main(int argc, char** argv)
+{
+	if (argc == 3)
+	{
+		socket_path = argv[1];
+		return run_worker(std::string(argv[2]) == "lost");
+	}
+
+	std::cout << "[test] started." << std::endl;
+	auto start_time = std::chrono::steady_clock::now();
+
+	try
+	{
+		executable_path = argv[0];
+		socket_path = "/tmp/coyote-coordinator-" + std::to_string(getpid()) + ".sock";
+		test_invalid_campaigns();
+		test_campaign();
+	}
+	catch (std::string error)
+	{
+		std::cout << "[test] failed: " << error << std::endl;
+		return 1;
+	}
+
+	std::cout << "[test] done in " << total_time(start_time) << "ms." << std::endl;
+	return 0;
+}
+
+#else
+
+int main()
+{
+	std::cout << "[test] skipped: Unix domain sockets are not supported." << std::endl;
+	return 0;
+}
+
+#endif // _WIN32
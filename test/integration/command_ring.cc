@@ -0,0 +1,120 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <thread>
+#include "test.h"
+
+using namespace coyote;
+
+constexpr auto WORK_THREAD_1_ID = 1;
+constexpr auto WORK_THREAD_2_ID = 2;
+constexpr auto RESOURCE_ID = 1;
+
+Scheduler* scheduler;
+CommandRing* ring;
+
+int shared_var;
+
+void work_1()
+{
+	scheduler->start_operation(WORK_THREAD_1_ID);
+	while (shared_var == 0)
+	{
+		scheduler->wait_resource(RESOURCE_ID);
+	}
+
+	scheduler->complete_operation(WORK_THREAD_1_ID);
+}
+
+void work_2()
+{
+	scheduler->start_operation(WORK_THREAD_2_ID);
+	shared_var = 1;
+
+	// The signal is applied when the operation completes.
+	assert(ring->try_enqueue(CommandType::SignalResource, RESOURCE_ID, 0), "failed to enqueue signal");
+	scheduler->complete_operation(WORK_THREAD_2_ID);
+}
+
+void run_iteration()
+{
+	scheduler->attach();
+
+	// The commands are applied before the first operation starts.
+	assert(ring->try_enqueue(CommandType::CreateResource, RESOURCE_ID, 0), "failed to enqueue resource");
+	assert(ring->try_enqueue(CommandType::CreateOperation, WORK_THREAD_1_ID, 0), "failed to enqueue operation 1");
+	assert(ring->try_enqueue(CommandType::CreateOperation, WORK_THREAD_2_ID, 0), "failed to enqueue operation 2");
+
+	std::thread t1(work_1);
+	std::thread t2(work_2);
+
+	scheduler->schedule_next();
+
+	size_t ops[] = { WORK_THREAD_1_ID, WORK_THREAD_2_ID };
+	scheduler->join_operations(ops, 2, true);
+	t1.join();
+	t2.join();
+
+	assert(ring->try_enqueue(CommandType::DeleteResource, RESOURCE_ID, 0), "failed to enqueue delete");
+	scheduler->detach();
+	assert(scheduler->error_code(), ErrorCode::Success);
+}
+
+void test_full_ring()
+{
+	scheduler->attach();
+
+	size_t capacity = ring->capacity();
+	for (size_t i = 0; i < capacity; i++)
+	{
+		assert(ring->try_enqueue(CommandType::CreateResource, i, 0), "failed to enqueue resource");
+	}
+
+	assert(!ring->try_enqueue(CommandType::CreateResource, capacity, 0), "enqueued in a full ring");
+	assert(scheduler->flush_commands(), ErrorCode::Success);
+	assert(ring->try_enqueue(CommandType::CreateResource, capacity, 0), "failed to enqueue after flush");
+
+	// A failing command does not fail the call that applies it, nor stop the commands after it, and is
+	// reported by 'flush_commands' and 'detach'.
+	assert(ring->try_enqueue(CommandType::CreateResource, 0, 0), "failed to enqueue duplicate resource");
+	assert(ring->try_enqueue(CommandType::CreateResource, capacity + 1, 0), "failed to enqueue resource");
+	assert(scheduler->schedule_next(), ErrorCode::Success);
+	assert(scheduler->signal_resource(capacity + 1), ErrorCode::Success);
+	assert(scheduler->flush_commands(), ErrorCode::DuplicateResource);
+
+	assert(scheduler->detach(), ErrorCode::DuplicateResource);
+}
+
+int main()
+{
+	std::cout << "[test] started." << std::endl;
+	auto start_time = std::chrono::steady_clock::now();
+
+	try
+	{
+		scheduler = new Scheduler();
+		ring = scheduler->enable_command_ring(8);
+		assert(ring != nullptr, "failed to enable the command ring");
+
+		for (int i = 0; i < 100; i++)
+		{
+#ifdef COYOTE_DEBUG_LOG
+			std::cout << "[test] iteration " << i << std::endl;
+#endif // COYOTE_DEBUG_LOG
+			shared_var = 0;
+			run_iteration();
+		}
+
+		test_full_ring();
+
+		delete scheduler;
+	}
+	catch (std::string error)
+	{
+		std::cout << "[test] failed: " << error << std::endl;
+		return 1;
+	}
+
+	std::cout << "[test] done in " << total_time(start_time) << "ms." << std::endl;
+	return 0;
+}
@@ -0,0 +1,155 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <set>
+#include <thread>
+#include <unordered_set>
+#include "test.h"
+
+using namespace coyote;
+
+constexpr auto WORK_THREAD_1_ID = 1;
+constexpr auto WORK_THREAD_2_ID = 2;
+
+Scheduler* scheduler;
+
+int shared_var;
+
+// Makes an integer and a boolean choice on the main operation, and returns them as one value.
+int run_sequential_iteration()
+{
+	scheduler->attach();
+	int value = scheduler->next_integer(4);
+	bool flag = scheduler->next_boolean();
+	scheduler->detach();
+	assert(scheduler->error_code(), ErrorCode::Success);
+	return value * 2 + (flag ? 1 : 0);
+}
+
+void work(size_t operation_id)
+{
+	scheduler->start_operation(operation_id);
+	int value = scheduler->next_boolean() ? 10 : 20;
+	scheduler->schedule_next();
+	shared_var += value + (int)operation_id;
+	scheduler->complete_operation(operation_id);
+}
+
+void run_concurrent_iteration()
+{
+	shared_var = 0;
+	scheduler->attach();
+
+	scheduler->create_operation(WORK_THREAD_1_ID);
+	std::thread t1(work, WORK_THREAD_1_ID);
+
+	scheduler->create_operation(WORK_THREAD_2_ID);
+	std::thread t2(work, WORK_THREAD_2_ID);
+
+	scheduler->join_operation(WORK_THREAD_1_ID);
+	scheduler->join_operation(WORK_THREAD_2_ID);
+	t1.join();
+	t2.join();
+
+	scheduler->detach();
+	assert(scheduler->error_code(), ErrorCode::Success);
+}
+
+void test_exhaustive_data_choices()
+{
+	auto settings = std::make_unique<Settings>();
+	settings->use_dfs_strategy();
+	scheduler = new Scheduler(std::move(settings));
+	auto& strategy = dynamic_cast<DFSStrategy&>(scheduler->exploration_strategy());
+
+	// The 8 combinations of the choices are enumerated in 8 iterations.
+	std::set<int> combinations;
+	for (int i = 0; i < 8; i++)
+	{
+		assert(strategy.enumerations() == 0, "enumeration completed early");
+		combinations.insert(run_sequential_iteration());
+	}
+
+	assert(combinations.size() == 8, "data choices were not enumerated exhaustively");
+	assert(strategy.enumerations() == 1, "enumeration did not complete");
+
+	// The choices are recorded in the schedule of the last iteration.
+	const ScheduleTrace& schedule = scheduler->schedule_trace();
+	assert(schedule.size() == 2, "unexpected schedule size");
+	assert(schedule[0].kind == ScheduleStepKind::Integer && schedule[0].value == 3, "unexpected integer step");
+	assert(schedule[1].kind == ScheduleStepKind::Boolean && schedule[1].value == 1, "unexpected boolean step");
+
+	// The enumeration then starts again.
+	assert(run_sequential_iteration() == 0, "enumeration did not restart");
+	delete scheduler;
+}
+
+void test_exhaustive_schedules()
+{
+	auto settings = std::make_unique<Settings>();
+	settings->use_dfs_strategy();
+	scheduler = new Scheduler(std::move(settings));
+	auto& strategy = dynamic_cast<DFSStrategy&>(scheduler->exploration_strategy());
+
+	std::unordered_set<uint64_t> schedule_hashes;
+	std::set<int> results;
+	size_t iterations = 0;
+	while (strategy.enumerations() == 0)
+	{
+		assert(iterations++ < 1000, "enumeration did not terminate");
+		run_concurrent_iteration();
+		assert(schedule_hashes.insert(scheduler->schedule_trace().view().hash()).second, "schedule was enumerated twice");
+		results.insert(shared_var);
+	}
+
+	// Every combination of the two data choices is reached in some interleaving.
+	assert(results == std::set<int>({ 23, 33, 43 }), "unexpected results");
+	delete scheduler;
+}
+
+void test_replayed_data_choices(uint64_t seed)
+{
+	auto settings = std::make_unique<Settings>();
+	settings->use_random_strategy(seed);
+	scheduler = new Scheduler(std::move(settings));
+	run_concurrent_iteration();
+	ScheduleTrace recorded = scheduler->schedule_trace();
+	int recorded_result = shared_var;
+	delete scheduler;
+
+	settings = std::make_unique<Settings>();
+	settings->use_replay_strategy(recorded, seed + 1);
+	scheduler = new Scheduler(std::move(settings));
+	auto& strategy = dynamic_cast<ReplayStrategy&>(scheduler->exploration_strategy());
+	for (int i = 0; i < 10; i++)
+	{
+		run_concurrent_iteration();
+		assert(shared_var == recorded_result, "data choices were not replayed");
+		assert(scheduler->schedule_trace() == recorded, "schedule was not replayed");
+		assert(strategy.divergences() == 0, "unexpected divergences");
+	}
+
+	delete scheduler;
+}
+
+int main()
+{
+	std::cout << "[test] started." << std::endl;
+	auto start_time = std::chrono::steady_clock::now();
+
+	try
+	{
+		uint64_t seed = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+		test_exhaustive_data_choices();
+		test_exhaustive_schedules();
+		test_replayed_data_choices(seed);
+	}
+	catch (std::string error)
+	{
+		std::cout << "[test] failed: " << error << std::endl;
+		return 1;
+	}
+
+	std::cout << "[test] done in " << total_time(start_time) << "ms." << std::endl;
+	return 0;
+}
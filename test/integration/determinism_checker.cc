@@ -0,0 +1,111 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <thread>
+#include "test.h"
+#include "coyote/schedules/determinism_checker.h"
+
+using namespace coyote;
+
+constexpr auto WORK_THREAD_1_ID = 1;
+constexpr auto WORK_THREAD_2_ID = 2;
+constexpr auto RESOURCE_ID = 1;
+
+// Count of runs, which the nondeterministic test reads without going through the scheduler.
+int run_count = 0;
+
+uint64_t run_iteration(Scheduler& scheduler, bool is_deterministic)
+{
+	bool has_extra_step = !is_deterministic && run_count++ % 2 == 1;
+	auto work = [&scheduler, has_extra_step](size_t operation_id)
+	{
+		scheduler.start_operation(operation_id);
+		scheduler.schedule_next();
+		if (has_extra_step && operation_id == WORK_THREAD_2_ID)
+		{
+			scheduler.create_resource(RESOURCE_ID);
+			scheduler.schedule_next();
+		}
+
+		scheduler.schedule_next();
+		scheduler.complete_operation(operation_id);
+	};
+
+	scheduler.attach();
+
+	scheduler.create_operation(WORK_THREAD_1_ID);
+	std::thread t1(work, WORK_THREAD_1_ID);
+
+	scheduler.create_operation(WORK_THREAD_2_ID);
+	std::thread t2(work, WORK_THREAD_2_ID);
+
+	scheduler.join_operation(WORK_THREAD_1_ID);
+	scheduler.join_operation(WORK_THREAD_2_ID);
+	t1.join();
+	t2.join();
+
+	scheduler.detach();
+	assert(scheduler.error_code(), ErrorCode::Success);
+	return 0;
+}
+
+int main()
+{
+	std::cout << "[test] started." << std::endl;
+	auto start_time = std::chrono::steady_clock::now();
+
+	try
+	{
+		uint64_t seed = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+		for (uint64_t i = 0; i < 20; i++)
+		{
+			auto configure = [seed, i](Settings& settings) { settings.use_random_strategy(seed + i); };
+
+			DeterminismChecker checker([](Scheduler& scheduler) { return run_iteration(scheduler, true); });
+			DeterminismReport report = checker.check(configure);
+			assert(report.is_deterministic, "deterministic test was reported as nondeterministic");
+			assert(report.are_events_complete, "the events were not compared");
+			assert(report.seed == seed + i, "unexpected seed");
+
+			DeterminismChecker nondeterministic_checker([](Scheduler& scheduler)
+			{
+				return run_iteration(scheduler, false);
+			});
+
+			report = nondeterministic_checker.check(configure);
+			assert(!report.is_deterministic, "nondeterministic test was not detected");
+			assert(report.has_divergent_event, "expected a divergent event");
+
+			// The only difference is the resource that the second run creates on operation '2'.
+			assert(report.events[0].operation_id == WORK_THREAD_2_ID || report.events[1].operation_id == WORK_THREAD_2_ID,
+				"unexpected divergent operation");
+			assert(report.events[1].type == TraceEventType::CreateResource, "unexpected divergent event");
+			assert(report.events[1].value == RESOURCE_ID, "unexpected divergent resource");
+		}
+
+		// Replaying a recorded schedule of a deterministic test reproduces it.
+		auto settings = std::make_unique<Settings>();
+		settings->use_random_strategy(seed);
+		Scheduler scheduler(std::move(settings));
+		run_iteration(scheduler, true);
+
+		DeterminismChecker checker([](Scheduler& scheduler) { return run_iteration(scheduler, true); });
+		DeterminismReport report = checker.check_replay(scheduler.schedule_trace(), seed);
+		assert(report.is_deterministic, "replay was reported as nondeterministic");
+
+		// A schedule that the test cannot follow is reported with its divergent decision.
+		ScheduleTrace schedule = scheduler.schedule_trace();
+		schedule.add_operation(WORK_THREAD_1_ID);
+		report = checker.check_replay(schedule, seed);
+		assert(!report.is_deterministic, "divergent replay was not detected");
+		assert(report.divergent_step == scheduler.schedule_trace().size(), "unexpected divergent step");
+	}
+	catch (std::string error)
+	{
+		std::cout << "[test] failed: " << error << std::endl;
+		return 1;
+	}
+
+	std::cout << "[test] done in " << total_time(start_time) << "ms." << std::endl;
+	return 0;
+}
@@ -0,0 +1,242 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <map>
+#include <thread>
+#include <vector>
+#include "test.h"
+#include "coyote/schedules/failure_buckets.h"
+
+using namespace coyote;
+
+constexpr size_t ITERATIONS = 300;
+constexpr uint64_t LOST_UPDATE = 7;
+constexpr size_t RESOURCE_ID = 1;
+constexpr size_t MISSING_RESOURCE_ID = 2;
+
+// Two workers increment a counter with a scheduling point between the read and the write, which the main
+// operation reports as a lost update after padding the schedule with a chosen number of choices, so that
+// the same bug is found with schedules of different lengths. Sometimes the main operation also signals a
+// resource that does not exist, which fails the iteration with an error code after it signaled another
+// resource. Returns true if the iteration failed.
+bool run_iteration(Scheduler& scheduler)
+{
+	int counter = 0;
+	auto work = [&scheduler, &counter](size_t operation_id)
+	{
+		scheduler.start_operation(operation_id);
+		int value = counter;
+		scheduler.schedule_next();
+		counter = value + 1;
+		scheduler.complete_operation(operation_id);
+	};
+
+	scheduler.attach();
+	std::vector<std::thread> threads;
+	for (size_t id = 1; id <= 2; id++)
+	{
+		scheduler.create_operation(id);
+		threads.emplace_back(work, id);
+	}
+
+	for (size_t id = 1; id <= 2; id++)
+	{
+		scheduler.join_operation(id);
+	}
+
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+
+	int padding = scheduler.next_integer(4);
+	for (int i = 0; i < padding; i++)
+	{
+		scheduler.next_boolean();
+	}
+
+	if (counter != 2)
+	{
+		scheduler.report_failure(LOST_UPDATE);
+	}
+
+	if (scheduler.next_integer(4) == 0)
+	{
+		scheduler.create_resource(RESOURCE_ID);
+		scheduler.signal_resource(RESOURCE_ID);
+		assert(scheduler.signal_resource(MISSING_RESOURCE_ID), ErrorCode::NotExistingResource);
+	}
+
+	scheduler.detach();
+	return scheduler.failure_signature().is_failure();
+}
+
+// Runs the campaign with the specified number of hashed schedule steps, and buckets its failures.
+void run_campaign(FailureBuckets& buckets, size_t steps, std::map<uint64_t, size_t>& shortest_lengths)
+{
+	auto settings = std::make_unique<Settings>();
+	settings->use_pct_strategy(42, 3);
+	settings->set_failure_signature_steps(steps);
+	Scheduler scheduler(std::move(settings));
+	for (size_t i = 0; i < ITERATIONS; i++)
+	{
+		bool is_failure = run_iteration(scheduler);
+		FailureSignature signature = scheduler.failure_signature();
+		assert(signature.is_failure() == is_failure, "unexpected failure");
+		if (is_failure)
+		{
+			uint64_t hash = signature.hash();
+			size_t length = scheduler.schedule_trace().size();
+			auto it = shortest_lengths.find(hash);
+			shortest_lengths[hash] = it == shortest_lengths.end() ? length : std::min(it->second, length);
+		}
+
+		bool is_added = buckets.add(scheduler);
+		assert(!is_added || is_failure, "passing iteration was added");
+	}
+}
+
+void test_bucketing()
+{
+	// Without the schedule steps, each bug has a single signature, and iterations that hit both bugs have
+	// a third one, whose operation and resource are those of the lost update that was found first.
+	FailureBuckets buckets;
+	std::map<uint64_t, size_t> shortest_lengths;
+	run_campaign(buckets, 0, shortest_lengths);
+	assert(buckets.size() == 3, "failures were not deduplicated");
+	assert(buckets.failures() > buckets.size(), "bugs were not found repeatedly");
+
+	uint64_t count = 0;
+	for (const auto& kvp : buckets.all())
+	{
+		const FailureBucket& bucket = kvp.second;
+		count += bucket.count;
+		assert(kvp.first == bucket.signature.hash(), "unexpected bucket");
+		assert(bucket.schedule.size() == shortest_lengths.at(kvp.first), "shortest schedule was not kept");
+		assert(bucket.signature.operation_id == 0, "unexpected operation");
+		assert(bucket.signature.error_code == ErrorCode::Success ||
+			bucket.signature.error_code == ErrorCode::NotExistingResource, "unexpected error code");
+		if (bucket.signature.reported_failure == 0)
+		{
+			assert(bucket.signature.error_code == ErrorCode::NotExistingResource, "unexpected error code");
+			assert(bucket.signature.resource_id == RESOURCE_ID, "unexpected resource");
+		}
+		else
+		{
+			assert(bucket.signature.reported_failure == LOST_UPDATE, "unexpected failure");
+			assert(bucket.signature.resource_id == NO_RESOURCE_ID, "unexpected resource");
+		}
+	}
+
+	assert(count == buckets.failures(), "unexpected failure count");
+
+	// Hashing the last schedule steps splits the bugs by the interleavings that led to them.
+	FailureBuckets tail_buckets;
+	std::map<uint64_t, size_t> tail_lengths;
+	run_campaign(tail_buckets, 8, tail_lengths);
+	assert(tail_buckets.failures() == buckets.failures(), "campaign was not deterministic");
+	assert(tail_buckets.size() >= buckets.size() && tail_buckets.size() == tail_lengths.size(), "unexpected buckets");
+}
+
+// A worker accesses a resource and then signals a resource that does not exist, after which the main
+// operation makes the specified number of choices. Returns the signature of the failure.
+FailureSignature run_worker_failure(Scheduler& scheduler, size_t choice_count)
+{
+	constexpr size_t WORKER_ID = 3;
+	auto work = [&scheduler]()
+	{
+		scheduler.start_operation(WORKER_ID);
+		scheduler.signal_resource(RESOURCE_ID);
+		scheduler.schedule_next();
+		assert(scheduler.signal_resource(MISSING_RESOURCE_ID), ErrorCode::NotExistingResource);
+		scheduler.complete_operation(WORKER_ID);
+	};
+
+	scheduler.attach();
+	scheduler.create_resource(RESOURCE_ID);
+	scheduler.create_operation(WORKER_ID);
+	std::thread thread(work);
+	scheduler.join_operation(WORKER_ID);
+	thread.join();
+	for (size_t i = 0; i < choice_count; i++)
+	{
+		scheduler.next_boolean();
+	}
+
+	scheduler.detach();
+	assert(scheduler.error_code(), ErrorCode::NotExistingResource);
+
+	FailureSignature signature = scheduler.failure_signature();
+	assert(signature.operation_id == WORKER_ID, "unexpected operation");
+	assert(signature.resource_id == RESOURCE_ID, "unexpected resource");
+	return signature;
+}
+
+void test_worker_failure()
+{
+	// The failure is attributed to the worker that made the failing call, and the schedule steps after
+	// the failure do not change its signature.
+	auto settings = std::make_unique<Settings>();
+	settings->use_random_strategy(42);
+	Scheduler scheduler(std::move(settings));
+	FailureSignature signature = run_worker_failure(scheduler, 0);
+	assert(run_worker_failure(scheduler, 5) == signature, "steps after the failure changed the signature");
+}
+
+void test_replay()
+{
+	FailureBuckets buckets;
+	std::map<uint64_t, size_t> shortest_lengths;
+	run_campaign(buckets, 8, shortest_lengths);
+
+	// The kept schedule of each bucket reproduces a failure with the same signature.
+	for (const auto& kvp : buckets.all())
+	{
+		auto settings = std::make_unique<Settings>();
+		settings->use_replay_strategy(kvp.second.schedule, kvp.second.token.seed);
+		Scheduler scheduler(std::move(settings));
+		assert(run_iteration(scheduler), "failure was not reproduced");
+		assert(scheduler.failure_signature() == kvp.second.signature, "unexpected signature");
+	}
+
+	// The kept schedules are written to a corpus, tagged with their signature.
+	std::string path = (std::filesystem::temp_directory_path() / "coyote_failure_buckets.bin").string();
+	assert(buckets.save(path), "failed to save the buckets");
+	assert(buckets.save(path), "failed to save the buckets again");
+
+	ScheduleCorpus corpus;
+	assert(corpus.open(path), "failed to open the corpus");
+	assert(corpus.size() == buckets.size() && corpus.verify(), "unexpected corpus");
+	for (size_t i = 0; i < corpus.size(); i++)
+	{
+		const FailureBucket& bucket = buckets.all().at(corpus.tag(i));
+		assert(ScheduleTrace(corpus.schedule(i)) == bucket.schedule, "unexpected schedule");
+	}
+
+	corpus.close();
+	std::remove(path.c_str());
+}
+
+int main()
+{
+	std::cout << "[test] started." << std::endl;
+	auto start_time = std::chrono::steady_clock::now();
+
+	try
+	{
+		test_bucketing();
+		test_worker_failure();
+		test_replay();
+	}
+	catch (std::string error)
+	{
+		std::cout << "[test] failed: " << error << std::endl;
+		return 1;
+	}
+
+	std::cout << "[test] done in " << total_time(start_time) << "ms." << std::endl;
+	return 0;
+}
@@ -0,0 +1,146 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <thread>
+#include "test.h"
+
+using namespace coyote;
+
+constexpr auto WORK_THREAD_1_ID = 1;
+constexpr auto WORK_THREAD_2_ID = 2;
+constexpr size_t MAX_UNFAIR_STEPS = 50;
+
+Scheduler* scheduler;
+
+bool is_flag_set;
+
+// Spins until the other operation sets the flag, which never happens if this operation is never
+// preempted, as PCT does when this operation has the highest priority.
+void spin(size_t operation_id)
+{
+	scheduler->start_operation(operation_id);
+	while (!is_flag_set)
+	{
+		scheduler->schedule_next();
+	}
+
+	scheduler->complete_operation(operation_id);
+}
+
+void set_flag(size_t operation_id)
+{
+	scheduler->start_operation(operation_id);
+	scheduler->schedule_next();
+	is_flag_set = true;
+	scheduler->complete_operation(operation_id);
+}
+
+void run_iteration()
+{
+	is_flag_set = false;
+	scheduler->attach();
+
+	scheduler->create_operation(WORK_THREAD_1_ID);
+	std::thread t1(spin, WORK_THREAD_1_ID);
+
+	scheduler->create_operation(WORK_THREAD_2_ID);
+	std::thread t2(set_flag, WORK_THREAD_2_ID);
+
+	scheduler->schedule_next();
+
+	scheduler->join_operation(WORK_THREAD_1_ID);
+	scheduler->join_operation(WORK_THREAD_2_ID);
+	t1.join();
+	t2.join();
+
+	scheduler->detach();
+	assert(scheduler->error_code(), ErrorCode::Success);
+}
+
+void test_fair_tail(uint64_t seed, FairSchedulingMode mode)
+{
+	auto settings = std::make_unique<Settings>();
+	settings->use_pct_strategy(seed, 3);
+	settings->enable_fair_scheduling(MAX_UNFAIR_STEPS, mode);
+	scheduler = new Scheduler(std::move(settings));
+	assert(dynamic_cast<FairStrategy*>(&scheduler->exploration_strategy()) != nullptr, "strategy is not fair");
+
+	ReproductionToken token = {};
+	uint64_t schedule_hash = 0;
+	for (int i = 0; i < 100; i++)
+	{
+		run_iteration();
+
+		// The fair tail lets the spinning operation yield to the other one within a few steps, or with
+		// overwhelming probability within a few dozen steps if it is random.
+		size_t max_fair_steps = mode == FairSchedulingMode::RoundRobin ? 10 : 100;
+		assert(scheduler->schedule_trace().size() <= MAX_UNFAIR_STEPS + max_fair_steps, "iteration was not fair");
+		if (i == 50)
+		{
+			token = scheduler->reproduction_token();
+			schedule_hash = scheduler->schedule_trace().view().hash();
+		}
+	}
+
+	delete scheduler;
+
+	// The token reproduces the iteration together with the same fair scheduling settings.
+	settings = std::make_unique<Settings>();
+	settings->reproduce(token);
+	settings->enable_fair_scheduling(MAX_UNFAIR_STEPS, mode);
+	scheduler = new Scheduler(std::move(settings));
+	run_iteration();
+	assert(scheduler->schedule_trace().view().hash() == schedule_hash, "fair iteration was not reproduced");
+	delete scheduler;
+}
+
+// DFS cannot be combined with fair scheduling, in either order.
+void test_dfs_rejected()
+{
+	for (int i = 0; i < 2; i++)
+	{
+		bool is_rejected = false;
+		try
+		{
+			Settings settings;
+			if (i == 0)
+			{
+				settings.use_dfs_strategy();
+				settings.enable_fair_scheduling(MAX_UNFAIR_STEPS);
+			}
+			else
+			{
+				settings.enable_fair_scheduling(MAX_UNFAIR_STEPS);
+				settings.use_dfs_strategy();
+			}
+		}
+		catch (const std::invalid_argument&)
+		{
+			is_rejected = true;
+		}
+
+		assert(is_rejected, "DFS with fair scheduling was not rejected");
+	}
+}
+
+int main()
+{
+	std::cout << "[test] started." << std::endl;
+	auto start_time = std::chrono::steady_clock::now();
+
+	try
+	{
+		uint64_t seed = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+		test_fair_tail(seed, FairSchedulingMode::RoundRobin);
+		test_fair_tail(seed, FairSchedulingMode::Random);
+		test_dfs_rejected();
+	}
+	catch (std::string error)
+	{
+		std::cout << "[test] failed: " << error << std::endl;
+		return 1;
+	}
+
+	std::cout << "[test] done in " << total_time(start_time) << "ms." << std::endl;
+	return 0;
+}
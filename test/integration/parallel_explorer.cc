@@ -0,0 +1,136 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+#include "test.h"
+#include "coyote/schedules/parallel_explorer.h"
+
+using namespace coyote;
+
+constexpr size_t WORKER_COUNT = 3;
+constexpr uint64_t LOST_UPDATE = 1;
+
+// Workers increment a shared counter, either atomically between scheduling points or with a scheduling
+// point between the read and the write. Returns a nonzero failure signature if an update was lost. All
+// state is local to the call, so the explorer can run it on several schedulers concurrently.
+uint64_t run_iteration(Scheduler& scheduler, bool is_racy)
+{
+	int counter = 0;
+	auto work = [&scheduler, &counter, is_racy](size_t operation_id)
+	{
+		scheduler.start_operation(operation_id);
+		scheduler.schedule_next();
+		int value = counter;
+		if (is_racy)
+		{
+			scheduler.schedule_next();
+		}
+
+		counter = value + 1;
+		scheduler.schedule_next();
+		scheduler.complete_operation(operation_id);
+	};
+
+	scheduler.attach();
+
+	std::vector<std::thread> threads;
+	for (size_t id = 1; id <= WORKER_COUNT; id++)
+	{
+		scheduler.create_operation(id);
+		threads.emplace_back(work, id);
+	}
+
+	for (size_t id = 1; id <= WORKER_COUNT; id++)
+	{
+		scheduler.join_operation(id);
+	}
+
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+
+	scheduler.detach();
+	assert(scheduler.error_code(), ErrorCode::Success);
+	return counter == (int)WORKER_COUNT ? 0 : LOST_UPDATE;
+}
+
+size_t count_schedules()
+{
+	auto settings = std::make_unique<Settings>();
+	settings->use_dfs_strategy();
+	Scheduler scheduler(std::move(settings));
+	auto& strategy = dynamic_cast<DFSStrategy&>(scheduler.exploration_strategy());
+
+	size_t count = 0;
+	while (strategy.enumerations() == 0)
+	{
+		assert(run_iteration(scheduler, false) == 0, "unexpected failure");
+		count++;
+	}
+
+	return count;
+}
+
+void test_parallel_enumeration()
+{
+	// The workers together enumerate each schedule exactly once.
+	std::mutex mutex;
+	std::unordered_set<uint64_t> schedule_hashes;
+	size_t duplicate_count = 0;
+	ParallelExplorer explorer([&](Scheduler& scheduler)
+	{
+		uint64_t failure = run_iteration(scheduler, false);
+		std::unique_lock<std::mutex> lock(mutex);
+		if (!schedule_hashes.insert(scheduler.schedule_trace().view().hash()).second)
+		{
+			duplicate_count++;
+		}
+
+		return failure;
+	}, 4);
+
+	ExplorationResult result = explorer.explore();
+	assert(result.is_complete, "exploration did not complete");
+	assert(result.failures == 0, "unexpected failures");
+	assert(duplicate_count == 0, "schedule was enumerated twice");
+	assert(result.iterations == count_schedules(), "schedules were not all enumerated");
+	assert(schedule_hashes.size() == result.iterations, "unexpected schedule count");
+}
+
+void test_parallel_failure()
+{
+	ParallelExplorer explorer([](Scheduler& scheduler) { return run_iteration(scheduler, true); }, 4);
+	ExplorationResult result = explorer.explore();
+	assert(!result.is_complete, "exploration did not stop at the failure");
+	assert(result.failure == LOST_UPDATE, "lost update was not found");
+
+	// The failing schedule reproduces the failure.
+	auto settings = std::make_unique<Settings>();
+	settings->use_replay_strategy(result.failing_schedule, 0);
+	Scheduler scheduler(std::move(settings));
+	assert(run_iteration(scheduler, true) == LOST_UPDATE, "failure was not reproduced");
+}
+
+int main()
+{
+	std::cout << "[test] started." << std::endl;
+	auto start_time = std::chrono::steady_clock::now();
+
+	try
+	{
+		test_parallel_enumeration();
+		test_parallel_failure();
+	}
+	catch (std::string error)
+	{
+		std::cout << "[test] failed: " << error << std::endl;
+		return 1;
+	}
+
+	std::cout << "[test] done in " << total_time(start_time) << "ms." << std::endl;
+	return 0;
+}
@@ -0,0 +1,134 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <thread>
+#include <unordered_set>
+#include "test.h"
+
+using namespace coyote;
+
+constexpr auto WORK_THREAD_1_ID = 1;
+constexpr auto WORK_THREAD_2_ID = 2;
+constexpr uint64_t RACE_FAILURE = 7;
+
+Scheduler* scheduler;
+
+int shared_var;
+bool race_found;
+
+void work(size_t operation_id)
+{
+	scheduler->start_operation(operation_id);
+
+	shared_var = (int)operation_id;
+	scheduler->schedule_next();
+	if (shared_var != (int)operation_id)
+	{
+		race_found = true;
+		scheduler->report_failure(RACE_FAILURE);
+	}
+
+	scheduler->complete_operation(operation_id);
+}
+
+void run_iteration()
+{
+	shared_var = 0;
+	race_found = false;
+	scheduler->attach();
+
+	scheduler->create_operation(WORK_THREAD_1_ID);
+	std::thread t1(work, WORK_THREAD_1_ID);
+
+	scheduler->create_operation(WORK_THREAD_2_ID);
+	std::thread t2(work, WORK_THREAD_2_ID);
+
+	scheduler->schedule_next();
+
+	scheduler->join_operation(WORK_THREAD_1_ID);
+	scheduler->join_operation(WORK_THREAD_2_ID);
+	t1.join();
+	t2.join();
+
+	scheduler->detach();
+	assert(scheduler->error_code(), ErrorCode::Success);
+}
+
+int main()
+{
+	std::cout << "[test] started." << std::endl;
+	auto start_time = std::chrono::steady_clock::now();
+
+	try
+	{
+		uint64_t seed = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+		auto settings = std::make_unique<Settings>();
+		settings->use_portfolio_strategy(seed);
+		settings->add_portfolio_member(StrategyType::Random, 100, 2);
+		settings->add_portfolio_member(StrategyType::PCT, 3, 1);
+		scheduler = new Scheduler(std::move(settings));
+		auto& portfolio = dynamic_cast<PortfolioStrategy&>(scheduler->exploration_strategy());
+
+		std::unordered_set<uint64_t> schedule_hashes;
+		size_t race_count = 0;
+		ReproductionToken race_token = {};
+		for (int i = 0; i < 300; i++)
+		{
+			run_iteration();
+			schedule_hashes.insert(scheduler->schedule_trace().view().hash());
+			if (race_found)
+			{
+				race_count++;
+				race_token = scheduler->reproduction_token();
+			}
+		}
+
+		// The iterations are split by the weights of the strategies.
+		const auto& statistics = portfolio.statistics();
+		assert(statistics.size() == 2, "unexpected portfolio size");
+		assert(statistics[0].iterations == 200 && statistics[1].iterations == 100, "unexpected iteration split");
+		assert(statistics[0].failures + statistics[1].failures == race_count, "unexpected failure count");
+		assert(statistics[0].new_schedules + statistics[1].new_schedules == schedule_hashes.size(),
+			"unexpected new schedule count");
+		assert(race_count > 0, "race was not found.");
+
+		size_t first_failure = statistics[0].first_failure_iteration;
+		if (first_failure == 0 || (statistics[1].first_failure_iteration != 0 && statistics[1].first_failure_iteration < first_failure))
+		{
+			first_failure = statistics[1].first_failure_iteration;
+		}
+
+		assert(first_failure > 0 && first_failure <= 300, "unexpected first failure iteration");
+		delete scheduler;
+
+		// The token of the last failing iteration reproduces it with its strategy alone.
+		settings = std::make_unique<Settings>();
+		settings->reproduce(race_token);
+		scheduler = new Scheduler(std::move(settings));
+		run_iteration();
+		assert(race_found, "race was not reproduced.");
+		delete scheduler;
+
+		// The default portfolio runs each of its strategies in turn.
+		settings = std::make_unique<Settings>();
+		settings->use_portfolio_strategy(seed);
+		scheduler = new Scheduler(std::move(settings));
+		auto& default_portfolio = dynamic_cast<PortfolioStrategy&>(scheduler->exploration_strategy());
+		size_t member_count = default_portfolio.statistics().size();
+		for (size_t i = 0; i < 2 * member_count; i++)
+		{
+			run_iteration();
+			assert(default_portfolio.current_strategy() == i % member_count, "unexpected round-robin order");
+		}
+
+		delete scheduler;
+	}
+	catch (std::string error)
+	{
+		std::cout << "[test] failed: " << error << std::endl;
+		return 1;
+	}
+
+	std::cout << "[test] done in " << total_time(start_time) << "ms." << std::endl;
+	return 0;
+}
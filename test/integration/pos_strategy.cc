@@ -0,0 +1,106 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <thread>
+#include "test.h"
+
+using namespace coyote;
+
+constexpr auto WORK_THREAD_1_ID = 1;
+constexpr auto WORK_THREAD_2_ID = 2;
+constexpr auto RESOURCE_ID = 1;
+
+Scheduler* scheduler;
+
+int shared_var;
+bool race_found;
+
+void work(size_t operation_id)
+{
+	scheduler->start_operation(operation_id);
+
+	// Both operations access the same resource, so their events race.
+	scheduler->signal_resource(RESOURCE_ID);
+	shared_var = (int)operation_id;
+	scheduler->schedule_next();
+	if (shared_var != (int)operation_id)
+	{
+		race_found = true;
+	}
+
+	scheduler->complete_operation(operation_id);
+}
+
+void run_iteration()
+{
+	shared_var = 0;
+	race_found = false;
+	scheduler->attach();
+	scheduler->create_resource(RESOURCE_ID);
+
+	scheduler->create_operation(WORK_THREAD_1_ID);
+	std::thread t1(work, WORK_THREAD_1_ID);
+
+	scheduler->create_operation(WORK_THREAD_2_ID);
+	std::thread t2(work, WORK_THREAD_2_ID);
+
+	scheduler->schedule_next();
+
+	scheduler->join_operation(WORK_THREAD_1_ID);
+	scheduler->join_operation(WORK_THREAD_2_ID);
+	t1.join();
+	t2.join();
+
+	scheduler->delete_resource(RESOURCE_ID);
+	scheduler->detach();
+	assert(scheduler->error_code(), ErrorCode::Success);
+}
+
+int main()
+{
+	std::cout << "[test] started." << std::endl;
+	auto start_time = std::chrono::steady_clock::now();
+
+	try
+	{
+		uint64_t seed = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+		auto settings = std::make_unique<Settings>();
+		settings->use_pos_strategy(seed);
+		scheduler = new Scheduler(std::move(settings));
+
+		size_t race_count = 0;
+		size_t last_writer_counts[3] = { 0, 0, 0 };
+		ReproductionToken race_token = {};
+		for (int i = 0; i < 200; i++)
+		{
+			run_iteration();
+			last_writer_counts[shared_var]++;
+			if (race_found)
+			{
+				race_count++;
+				race_token = scheduler->reproduction_token();
+			}
+		}
+
+		assert(race_count > 0, "race was not found.");
+		assert(last_writer_counts[WORK_THREAD_1_ID] > 0 && last_writer_counts[WORK_THREAD_2_ID] > 0,
+			"the strategy did not sample both orders of the racing writes");
+		delete scheduler;
+
+		// The token reproduces the failing iteration directly.
+		settings = std::make_unique<Settings>();
+		settings->reproduce(race_token);
+		scheduler = new Scheduler(std::move(settings));
+		run_iteration();
+		assert(race_found, "race was not reproduced.");
+		delete scheduler;
+	}
+	catch (std::string error)
+	{
+		std::cout << "[test] failed: " << error << std::endl;
+		return 1;
+	}
+
+	std::cout << "[test] done in " << total_time(start_time) << "ms." << std::endl;
+	return 0;
+}
@@ -5,6 +5,7 @@
 #include <climits>
 #include <errno.h>
 #include <algorithm>
+#include <unordered_map>
 
 using namespace coyote;
 typedef unsigned long long llu;
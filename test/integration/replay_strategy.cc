@@ -0,0 +1,114 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <thread>
+#include "test.h"
+#include "coyote/schedules/schedule_minimizer.h"
+
+using namespace coyote;
+
+constexpr auto WORK_THREAD_1_ID = 1;
+constexpr auto WORK_THREAD_2_ID = 2;
+constexpr auto NUM_STEPS = 10;
+constexpr uint64_t LOST_UPDATE = 1;
+
+// Two operations do some unrelated work and then increment a shared counter without synchronization.
+// Returns a nonzero failure signature if an update was lost. All state is local to the call, so the
+// minimizer can run it on several schedulers concurrently.
+uint64_t run_iteration(Scheduler& scheduler)
+{
+	int counter = 0;
+	auto work = [&scheduler, &counter](size_t operation_id)
+	{
+		scheduler.start_operation(operation_id);
+		for (int i = 0; i < NUM_STEPS; i++)
+		{
+			scheduler.schedule_next();
+		}
+
+		int value = counter;
+		scheduler.schedule_next();
+		counter = value + 1;
+		for (int i = 0; i < NUM_STEPS; i++)
+		{
+			scheduler.schedule_next();
+		}
+
+		scheduler.complete_operation(operation_id);
+	};
+
+	scheduler.attach();
+
+	scheduler.create_operation(WORK_THREAD_1_ID);
+	std::thread t1(work, WORK_THREAD_1_ID);
+
+	scheduler.create_operation(WORK_THREAD_2_ID);
+	std::thread t2(work, WORK_THREAD_2_ID);
+
+	scheduler.join_operation(WORK_THREAD_1_ID);
+	scheduler.join_operation(WORK_THREAD_2_ID);
+	t1.join();
+	t2.join();
+
+	scheduler.detach();
+	assert(scheduler.error_code(), ErrorCode::Success);
+	return counter == 2 ? 0 : LOST_UPDATE;
+}
+
+int main()
+{
+	std::cout << "[test] started." << std::endl;
+	auto start_time = std::chrono::steady_clock::now();
+
+	try
+	{
+		// Find a failing schedule with the random strategy.
+		auto settings = std::make_unique<Settings>();
+		uint64_t seed = settings->random_seed();
+		settings->use_random_strategy(seed);
+		Scheduler scheduler(std::move(settings));
+
+		ScheduleTrace failing_schedule;
+		for (int i = 0; i < 1000 && failing_schedule.empty(); i++)
+		{
+			if (run_iteration(scheduler) == LOST_UPDATE)
+			{
+				failing_schedule = scheduler.schedule_trace();
+				seed = scheduler.random_seed();
+			}
+		}
+
+		assert(!failing_schedule.empty(), "no failing schedule was found");
+
+		// Replaying the failing schedule reproduces the failure with the same schedule.
+		auto evaluator = ScheduleMinimizer::replay_evaluator(run_iteration, seed);
+		for (int i = 0; i < 10; i++)
+		{
+			ScheduleOutcome outcome = evaluator(failing_schedule);
+			assert(outcome.failure == LOST_UPDATE, "replay did not reproduce the failure");
+			assert(outcome.schedule == failing_schedule, "replay diverged from the schedule");
+		}
+
+		// Minimize the failing schedule.
+		ScheduleMinimizer minimizer(evaluator, 4);
+		ScheduleTrace minimized = minimizer.minimize(failing_schedule, LOST_UPDATE);
+		size_t original_switches = ScheduleMinimizer::context_switches(failing_schedule).size();
+		size_t switches = ScheduleMinimizer::context_switches(minimized).size();
+#ifdef COYOTE_DEBUG_LOG
+		std::cout << "[test] minimized " << original_switches << " switches and " << failing_schedule.size() <<
+			" steps to " << switches << " switches and " << minimized.size() << " steps in " <<
+			minimizer.evaluations() << " evaluations" << std::endl;
+#endif // COYOTE_DEBUG_LOG
+
+		assert(switches <= original_switches, "schedule got more context switches");
+		assert(evaluator(minimized).failure == LOST_UPDATE, "minimized schedule does not fail");
+	}
+	catch (std::string error)
+	{
+		std::cout << "[test] failed: " << error << std::endl;
+		return 1;
+	}
+
+	std::cout << "[test] done in " << total_time(start_time) << "ms." << std::endl;
+	return 0;
+}
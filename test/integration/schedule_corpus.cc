@@ -0,0 +1,218 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <vector>
+#include "test.h"
+#include "coyote/schedules/schedule_corpus.h"
+
+using namespace coyote;
+
+constexpr auto WORK_THREAD_1_ID = 1;
+constexpr auto WORK_THREAD_2_ID = 2;
+constexpr auto ITERATIONS = 50;
+
+Scheduler* scheduler;
+
+void work(size_t operation_id)
+{
+	scheduler->start_operation(operation_id);
+	scheduler->schedule_next();
+	scheduler->schedule_next();
+	scheduler->complete_operation(operation_id);
+}
+
+ScheduleTrace run_iteration()
+{
+	scheduler->attach();
+
+	scheduler->create_operation(WORK_THREAD_1_ID);
+	std::thread t1(work, WORK_THREAD_1_ID);
+
+	scheduler->create_operation(WORK_THREAD_2_ID);
+	std::thread t2(work, WORK_THREAD_2_ID);
+
+	scheduler->join_operation(WORK_THREAD_1_ID);
+	scheduler->join_operation(WORK_THREAD_2_ID);
+	t1.join();
+	t2.join();
+
+	scheduler->detach();
+	assert(scheduler->error_code(), ErrorCode::Success);
+	return scheduler->schedule_trace();
+}
+
+bool is_equal(ScheduleView actual, const ScheduleTrace& expected)
+{
+	if (actual.size() != expected.size())
+	{
+		return false;
+	}
+
+	for (size_t i = 0; i < actual.size(); i++)
+	{
+		if (actual[i] != expected[i])
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+int main()
+{
+	std::cout << "[test] started." << std::endl;
+	auto start_time = std::chrono::steady_clock::now();
+
+	std::string path = (std::filesystem::temp_directory_path() / "coyote_schedule_corpus.bin").string();
+	std::remove(path.c_str());
+
+	try
+	{
+		auto settings = std::make_unique<Settings>();
+		settings->record_schedules(path);
+		scheduler = new Scheduler(std::move(settings));
+
+		std::vector<ScheduleTrace> schedules;
+		for (int i = 0; i < ITERATIONS; i++)
+		{
+#ifdef COYOTE_DEBUG_LOG
+			std::cout << "[test] iteration " << i << std::endl;
+#endif // COYOTE_DEBUG_LOG
+			schedules.push_back(run_iteration());
+			assert(schedules.back().size() >= 6, "unexpected schedule length");
+		}
+
+		// Deleting the scheduler flushes the corpus.
+		delete scheduler;
+
+		uint64_t first_seed = 0;
+		{
+			ScheduleCorpus corpus;
+			assert(corpus.open(path), "failed to open the corpus");
+			assert(corpus.size() == ITERATIONS, "unexpected corpus size");
+			assert(!corpus.is_truncated(), "unexpected truncated corpus");
+			assert(corpus.verify(), "unexpected corrupted corpus");
+			for (size_t i = 0; i < corpus.size(); i++)
+			{
+				assert(is_equal(corpus.schedule(i), schedules[i]), "unexpected schedule");
+				assert(corpus.tag(i) == (uint64_t)ErrorCode::Success, "unexpected tag");
+			}
+
+			first_seed = corpus.seed(0);
+		}
+
+		// Append the steps of the first schedule with a different seed and tag, then an exact duplicate of
+		// the first schedule, and then a record that is torn by a crash.
+		{
+			ScheduleCorpusWriter writer;
+			assert(writer.open(path), "failed to reopen the corpus");
+			assert(writer.append(schedules[0].view(), 7, 1), "failed to append");
+			assert(writer.append(schedules[0].view(), first_seed, (uint64_t)ErrorCode::Success), "failed to append");
+			assert(writer.flush(), "failed to flush");
+		}
+
+		auto torn_size = std::filesystem::file_size(path);
+		{
+			std::ofstream file(path, std::ios::binary | std::ios::app);
+			ScheduleRecordHeader header = { SCHEDULE_RECORD_MARKER, 0, 1000, 0, 0, 0 };
+			file.write((const char*)&header, sizeof(header));
+		}
+
+		{
+			ScheduleCorpus corpus;
+			assert(corpus.open(path), "failed to open the torn corpus");
+			assert(corpus.size() == ITERATIONS + 2, "unexpected torn corpus size");
+			assert(corpus.is_truncated(), "expected a truncated corpus");
+			assert(corpus.seed(ITERATIONS) == 7, "unexpected seed");
+		}
+
+		// Reopening the corpus for writing drops the torn record.
+		{
+			ScheduleCorpusWriter writer;
+			assert(writer.open(path), "failed to reopen the torn corpus");
+		}
+
+		assert(std::filesystem::file_size(path) == torn_size, "torn record was not truncated");
+
+		// A corrupted record before the end is not truncated, as that would drop the records after it.
+		{
+			std::string copy_path = path + ".copy";
+			std::filesystem::copy_file(path, copy_path, std::filesystem::copy_options::overwrite_existing);
+			{
+				std::fstream file(copy_path, std::ios::binary | std::ios::in | std::ios::out);
+				file.seekp(sizeof(ScheduleCorpusHeader) + sizeof(ScheduleRecordHeader) +
+					schedules[0].size() * sizeof(ScheduleStep));
+				uint32_t marker = 0;
+				file.write((const char*)&marker, sizeof(marker));
+			}
+
+			ScheduleCorpusWriter writer;
+			assert(!writer.open(copy_path), "opened a corrupted corpus for writing");
+			assert(std::filesystem::file_size(copy_path) == torn_size, "corrupted corpus was truncated");
+			std::remove(copy_path.c_str());
+		}
+
+		// Corrupt a step of the second schedule.
+		{
+			std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+			file.seekp(sizeof(ScheduleCorpusHeader) + sizeof(ScheduleRecordHeader) +
+				schedules[0].size() * sizeof(ScheduleStep) + sizeof(ScheduleRecordHeader) + 8);
+			uint64_t value = 1000;
+			file.write((const char*)&value, sizeof(value));
+		}
+
+		size_t unique_count = 0;
+		{
+			ScheduleCorpus corpus;
+			assert(corpus.open(path), "failed to open the corrupted corpus");
+			assert(!corpus.verify(), "expected a corrupted corpus");
+			assert(corpus.is_valid(0) && !corpus.is_valid(1), "unexpected corrupted schedule");
+
+			for (size_t i = 0; i < corpus.size(); i++)
+			{
+				bool is_duplicate = i == 1;
+				for (size_t j = 0; j < i && !is_duplicate; j++)
+				{
+					is_duplicate = j != 1 && corpus.seed(i) == corpus.seed(j) && corpus.tag(i) == corpus.tag(j) &&
+						is_equal(corpus.schedule(i), ScheduleTrace(corpus.schedule(j)));
+				}
+
+				unique_count += is_duplicate ? 0 : 1;
+			}
+		}
+
+		assert(ScheduleCorpus::compact(path), "failed to compact the corpus");
+
+		{
+			ScheduleCorpus corpus;
+			assert(corpus.open(path), "failed to open the compacted corpus");
+			assert(corpus.size() == unique_count, "unexpected compacted corpus size");
+			assert(corpus.size() <= ITERATIONS, "duplicates were not removed");
+			assert(corpus.verify(), "unexpected corrupted compacted corpus");
+			assert(is_equal(corpus.schedule(0), schedules[0]), "unexpected first compacted schedule");
+			bool has_reseeded_schedule = false;
+			for (size_t i = 0; i < corpus.size(); i++)
+			{
+				has_reseeded_schedule |= corpus.seed(i) == 7 && corpus.tag(i) == 1 &&
+					is_equal(corpus.schedule(i), schedules[0]);
+			}
+
+			assert(has_reseeded_schedule, "schedule with a different seed and tag was removed");
+		}
+	}
+	catch (std::string error)
+	{
+		std::cout << "[test] failed: " << error << std::endl;
+		std::remove(path.c_str());
+		return 1;
+	}
+
+	std::remove(path.c_str());
+	std::cout << "[test] done in " << total_time(start_time) << "ms." << std::endl;
+	return 0;
+}
@@ -0,0 +1,127 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "test.h"
+
+#ifndef _WIN32
+
+#include <string>
+#include <sys/wait.h>
+#include "coyote/service/scheduler_client.h"
+#include "coyote/service/scheduler_server.h"
+
+using namespace coyote;
+
+constexpr auto WORK_PROCESS_1_ID = 1;
+constexpr auto WORK_PROCESS_2_ID = 2;
+
+std::string executable_path;
+std::string socket_path;
+
+// Runs a remote operation and returns zero if all of its calls succeeded.
+int run_operation(size_t operation_id)
+{
+	SchedulerClient client;
+	bool success = client.connect(socket_path) == ErrorCode::Success;
+	success &= client.start_operation(operation_id) == ErrorCode::Success;
+	if (operation_id == WORK_PROCESS_1_ID)
+	{
+		success &= client.join_operation(WORK_PROCESS_2_ID) == ErrorCode::Success;
+	}
+	else
+	{
+		success &= client.schedule_next() == ErrorCode::Success;
+	}
+
+	success &= client.complete_operation(operation_id) == ErrorCode::Success;
+	return success ? 0 : 1;
+}
+
+// Runs the operation with the specified id in a new process of this executable.
+pid_t spawn_operation(size_t operation_id)
+{
+	std::string id = std::to_string(operation_id);
+	char* args[] = { &executable_path[0], &socket_path[0], &id[0], nullptr };
+	pid_t pid = fork();
+	if (pid == 0)
+	{
+		execv(args[0], args);
+		_exit(1);
+	}
+
+	return pid;
+}
+
+void run_iteration()
+{
+	SchedulerClient client;
+	assert(client.connect(socket_path), ErrorCode::Success);
+	assert(client.attach(), ErrorCode::Success);
+
+	assert(client.create_operation(WORK_PROCESS_1_ID), ErrorCode::Success);
+	pid_t p1 = spawn_operation(WORK_PROCESS_1_ID);
+	assert(client.create_operation(WORK_PROCESS_2_ID), ErrorCode::Success);
+	pid_t p2 = spawn_operation(WORK_PROCESS_2_ID);
+
+	size_t ops[] = { WORK_PROCESS_1_ID, WORK_PROCESS_2_ID };
+	assert(client.join_operations(ops, 2, true), ErrorCode::Success);
+
+	int status_1 = 0;
+	int status_2 = 0;
+	waitpid(p1, &status_1, 0);
+	waitpid(p2, &status_2, 0);
+	assert(WIFEXITED(status_1) && WEXITSTATUS(status_1) == 0, "operation 1 failed");
+	assert(WIFEXITED(status_2) && WEXITSTATUS(status_2) == 0, "operation 2 failed");
+
+	assert(client.detach(), ErrorCode::Success);
+	assert(client.error_code(), ErrorCode::Success);
+}
+
+int main(int argc, char** argv)
+{
+	if (argc == 3)
+	{
+		socket_path = argv[1];
+		return run_operation(std::stoul(argv[2]));
+	}
+
+	std::cout << "[test] started." << std::endl;
+	auto start_time = std::chrono::steady_clock::now();
+
+	try
+	{
+		executable_path = argv[0];
+		socket_path = "/tmp/coyote-test-" + std::to_string(getpid()) + ".sock";
+		Scheduler scheduler;
+		SchedulerServer server(&scheduler, socket_path);
+		assert(server.start(), ErrorCode::Success);
+
+		for (int i = 0; i < 20; i++)
+		{
+#ifdef COYOTE_DEBUG_LOG
+			std::cout << "[test] iteration " << i << std::endl;
+#endif // COYOTE_DEBUG_LOG
+			run_iteration();
+		}
+
+		server.stop();
+	}
+	catch (std::string error)
+	{
+		std::cout << "[test] failed: " << error << std::endl;
+		return 1;
+	}
+
+	std::cout << "[test] done in " << total_time(start_time) << "ms." << std::endl;
+	return 0;
+}
+
+#else
+
+int main()
+{
+	std::cout << "[test] skipped: Unix domain sockets are not supported." << std::endl;
+	return 0;
+}
+
+#endif // _WIN32
@@ -0,0 +1,142 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <thread>
+#include <unordered_set>
+#include <vector>
+#include "test.h"
+
+using namespace coyote;
+
+constexpr size_t WORKER_COUNT = 3;
+constexpr size_t WORKER_CLASS = 1;
+
+Scheduler* scheduler;
+
+int counter;
+
+// Identical workers, which are interchangeable until they are first scheduled.
+void work(size_t operation_id)
+{
+	scheduler->start_operation(operation_id);
+	scheduler->schedule_next();
+	counter++;
+	scheduler->schedule_next();
+	scheduler->complete_operation(operation_id);
+}
+
+void run_iteration(bool is_symmetric)
+{
+	counter = 0;
+	scheduler->attach();
+
+	std::vector<std::thread> threads;
+	for (size_t id = 1; id <= WORKER_COUNT; id++)
+	{
+		scheduler->create_operation(id);
+		if (is_symmetric)
+		{
+			scheduler->set_symmetry_class(id, WORKER_CLASS);
+		}
+
+		threads.emplace_back(work, id);
+	}
+
+	for (size_t id = 1; id <= WORKER_COUNT; id++)
+	{
+		scheduler->join_operation(id);
+	}
+
+	for (auto& thread : threads)
+	{
+		thread.join();
+	}
+
+	scheduler->detach();
+	assert(scheduler->error_code(), ErrorCode::Success);
+	assert(counter == (int)WORKER_COUNT, "unexpected counter");
+}
+
+// Returns the number of schedules that the DFS strategy enumerates.
+size_t count_schedules(bool is_symmetric)
+{
+	auto settings = std::make_unique<Settings>();
+	settings->use_dfs_strategy();
+	scheduler = new Scheduler(std::move(settings));
+	auto& strategy = dynamic_cast<DFSStrategy&>(scheduler->exploration_strategy());
+
+	std::unordered_set<uint64_t> schedule_hashes;
+	while (strategy.enumerations() == 0)
+	{
+		run_iteration(is_symmetric);
+		assert(schedule_hashes.insert(scheduler->schedule_trace().view().hash()).second, "schedule was enumerated twice");
+	}
+
+	delete scheduler;
+	return schedule_hashes.size();
+}
+
+void test_symmetry_class_errors()
+{
+	auto settings = std::make_unique<Settings>();
+	settings->use_random_strategy(0);
+	scheduler = new Scheduler(std::move(settings));
+	scheduler->attach();
+	assert(scheduler->set_symmetry_class(7, WORKER_CLASS), ErrorCode::NotExistingOperation);
+	assert(scheduler->set_symmetry_class(0, WORKER_CLASS), ErrorCode::OperationAlreadyStarted);
+	scheduler->detach();
+
+	// A worker that was scheduled and then preempted has diverged from the other workers of its class.
+	scheduler->attach();
+	bool has_run = false;
+	bool is_checked = false;
+	scheduler->create_operation(1);
+	std::thread thread([&has_run, &is_checked]()
+	{
+		scheduler->start_operation(1);
+		has_run = true;
+		while (!is_checked)
+		{
+			scheduler->schedule_next();
+		}
+
+		scheduler->complete_operation(1);
+	});
+
+	while (!has_run)
+	{
+		scheduler->schedule_next();
+	}
+
+	assert(scheduler->set_symmetry_class(1, WORKER_CLASS), ErrorCode::OperationAlreadyStarted);
+	is_checked = true;
+	scheduler->join_operation(1);
+	thread.join();
+	scheduler->detach();
+	delete scheduler;
+}
+
+int main()
+{
+	std::cout << "[test] started." << std::endl;
+	auto start_time = std::chrono::steady_clock::now();
+
+	try
+	{
+		// The first scheduling choice among the workers is canonical, so the schedules that only permute
+		// the workers at the start are enumerated once.
+		size_t full_count = count_schedules(false);
+		size_t reduced_count = count_schedules(true);
+		assert(reduced_count * WORKER_COUNT <= full_count, "schedules were not reduced by symmetry");
+
+		test_symmetry_class_errors();
+	}
+	catch (std::string error)
+	{
+		std::cout << "[test] failed: " << error << std::endl;
+		return 1;
+	}
+
+	std::cout << "[test] done in " << total_time(start_time) << "ms." << std::endl;
+	return 0;
+}
@@ -0,0 +1,99 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <thread>
+#include "test.h"
+
+using namespace coyote;
+
+constexpr auto WORK_THREAD_1_ID = 1;
+constexpr auto WORK_THREAD_2_ID = 2;
+constexpr auto RESOURCE_ID = 0;
+
+Scheduler* scheduler;
+
+void work(size_t operation_id)
+{
+	scheduler->start_operation(operation_id);
+	assert(scheduler->schedule_next(), ErrorCode::Success);
+	assert(scheduler->signal_resource(RESOURCE_ID), ErrorCode::Success);
+	scheduler->complete_operation(operation_id);
+}
+
+void run_controlled_iteration()
+{
+	scheduler->attach();
+	scheduler->create_resource(RESOURCE_ID);
+
+	scheduler->create_operation(WORK_THREAD_1_ID);
+	std::thread t1(work, WORK_THREAD_1_ID);
+
+	scheduler->create_operation(WORK_THREAD_2_ID);
+	std::thread t2(work, WORK_THREAD_2_ID);
+
+	scheduler->schedule_next();
+	scheduler->join_operation(WORK_THREAD_1_ID);
+	scheduler->join_operation(WORK_THREAD_2_ID);
+	t1.join();
+	t2.join();
+
+	scheduler->delete_resource(RESOURCE_ID);
+	scheduler->detach();
+	assert(scheduler->error_code(), ErrorCode::Success);
+}
+
+void run_uncontrolled_iteration(ErrorCode expected_error_code)
+{
+	scheduler->attach();
+	assert(scheduler->create_resource(RESOURCE_ID), ErrorCode::Success);
+
+	// This thread never starts an operation, so the scheduler does not control it.
+	ErrorCode error_code = ErrorCode::Success;
+	std::thread t([&error_code]() { error_code = scheduler->signal_resource(RESOURCE_ID); });
+	t.join();
+	assert(error_code, expected_error_code);
+
+	// The rejected call leaves the scheduler usable, and its error is reported at the end of the iteration.
+	assert(scheduler->schedule_next(), expected_error_code);
+	assert(scheduler->scheduled_operation_id() == 0, "the main operation is not scheduled");
+	scheduler->delete_resource(RESOURCE_ID);
+	assert(scheduler->detach(), expected_error_code);
+}
+
+int main()
+{
+	std::cout << "[test] started." << std::endl;
+	auto start_time = std::chrono::steady_clock::now();
+
+	try
+	{
+		auto settings = std::make_unique<Settings>();
+		settings->enable_thread_validation();
+		scheduler = new Scheduler(std::move(settings));
+
+		for (int i = 0; i < 100; i++)
+		{
+#ifdef COYOTE_DEBUG_LOG
+			std::cout << "[test] iteration " << i << std::endl;
+#endif // COYOTE_DEBUG_LOG
+			run_controlled_iteration();
+		}
+
+		run_uncontrolled_iteration(ErrorCode::UncontrolledThread);
+		run_controlled_iteration();
+		delete scheduler;
+
+		// Without validation, the call of the uncontrolled thread is not detected.
+		scheduler = new Scheduler();
+		run_uncontrolled_iteration(ErrorCode::Success);
+		delete scheduler;
+	}
+	catch (std::string error)
+	{
+		std::cout << "[test] failed: " << error << std::endl;
+		return 1;
+	}
+
+	std::cout << "[test] done in " << total_time(start_time) << "ms." << std::endl;
+	return 0;
+}
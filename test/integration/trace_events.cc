@@ -0,0 +1,128 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <cstdio>
+#include <filesystem>
+#include <thread>
+#include "test.h"
+#include "coyote/tracing/trace_reader.h"
+
+using namespace coyote;
+
+constexpr auto WORK_THREAD_1_ID = 1;
+constexpr auto WORK_THREAD_2_ID = 2;
+constexpr auto RESOURCE_ID = 1;
+constexpr auto ITERATIONS = 100;
+
+Scheduler* scheduler;
+
+bool is_signaled;
+
+void work_1()
+{
+	scheduler->start_operation(WORK_THREAD_1_ID);
+	while (!is_signaled)
+	{
+		scheduler->wait_resource(RESOURCE_ID);
+	}
+
+	scheduler->complete_operation(WORK_THREAD_1_ID);
+}
+
+void work_2()
+{
+	scheduler->start_operation(WORK_THREAD_2_ID);
+	scheduler->schedule_next();
+	is_signaled = true;
+	scheduler->signal_resource(RESOURCE_ID);
+	scheduler->complete_operation(WORK_THREAD_2_ID);
+}
+
+void run_iteration()
+{
+	is_signaled = false;
+	scheduler->attach();
+	scheduler->create_resource(RESOURCE_ID);
+
+	scheduler->create_operation(WORK_THREAD_1_ID);
+	std::thread t1(work_1);
+
+	scheduler->create_operation(WORK_THREAD_2_ID);
+	std::thread t2(work_2);
+
+	scheduler->join_operation(WORK_THREAD_1_ID);
+	scheduler->join_operation(WORK_THREAD_2_ID);
+	t1.join();
+	t2.join();
+
+	scheduler->detach();
+	assert(scheduler->error_code(), ErrorCode::Success);
+}
+
+int main()
+{
+	std::cout << "[test] started." << std::endl;
+	auto start_time = std::chrono::steady_clock::now();
+
+	std::string path = (std::filesystem::temp_directory_path() / "coyote_trace_events.bin").string();
+
+	try
+	{
+		auto settings = std::make_unique<Settings>();
+		settings->enable_tracing(path);
+		scheduler = new Scheduler(std::move(settings));
+
+		for (int i = 0; i < ITERATIONS; i++)
+		{
+#ifdef COYOTE_DEBUG_LOG
+			std::cout << "[test] iteration " << i << std::endl;
+#endif // COYOTE_DEBUG_LOG
+			run_iteration();
+		}
+
+		// Deleting the scheduler flushes the trace.
+		delete scheduler;
+
+		TraceReader reader;
+		assert(reader.open(path), "failed to open the trace");
+
+		size_t attach_count = 0;
+		size_t detach_count = 0;
+		size_t schedule_count = 0;
+		size_t last_timestamp = 0;
+		TraceRecord record;
+		while (reader.next(record))
+		{
+			assert(record.type != TraceEventType::DroppedEvents, "unexpected dropped events");
+			assert(record.timestamp >= last_timestamp, "unexpected timestamp");
+			last_timestamp = record.timestamp;
+			if (record.type == TraceEventType::Attach)
+			{
+				attach_count++;
+				assert(record.iteration == attach_count, "unexpected iteration");
+			}
+			else if (record.type == TraceEventType::Detach)
+			{
+				detach_count++;
+			}
+			else if (record.type == TraceEventType::ScheduleNext)
+			{
+				schedule_count++;
+			}
+		}
+
+		assert(attach_count == ITERATIONS, "unexpected attach count");
+		assert(detach_count == ITERATIONS, "unexpected detach count");
+		assert(schedule_count >= ITERATIONS * 3, "unexpected schedule count");
+	}
+	catch (std::string error)
+	{
+		std::cout << "[test] failed: " << error << std::endl;
+		std::remove(path.c_str());
+		return 1;
+	}
+
+	std::remove(path.c_str());
+	std::cout << "[test] done in " << total_time(start_time) << "ms." << std::endl;
+	return 0;
+}
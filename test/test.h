@@ -44,10 +44,14 @@ std::string error_message(ErrorCode error_code)
 				return "client is already attached to the scheduler";
 		case ErrorCode::ClientNotAttached:
 				return "client is not attached to the scheduler";
+		case ErrorCode::UncontrolledThread:
+				return "call from a thread that does not run the scheduled operation";
 		case ErrorCode::InternalError:
 				return "internal error";
 		case ErrorCode::SchedulerDisabled:
 				return "scheduler is disabled";
+		case ErrorCode::InvalidCheckpoint:
+				return "checkpoint is invalid or belongs to another campaign";
 		default:
 				return "(unknown error)";
 		}
@@ -0,0 +1,101 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "test.h"
+#include "coyote/strategies/portfolio_strategy.h"
+
+using namespace coyote;
+
+int main()
+{
+	std::cout << "[test] started." << std::endl;
+	auto start_time = std::chrono::steady_clock::now();
+
+	try
+	{
+		uint64_t seed = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+#ifdef COYOTE_DEBUG_LOG
+		std::cout << "[test] seed: " << seed << std::endl;
+#endif // COYOTE_DEBUG_LOG
+
+		auto settings = std::make_unique<Settings>();
+		settings->use_bandit_strategy(seed);
+		settings->add_portfolio_member(StrategyType::Random, 100);
+		settings->add_portfolio_member(StrategyType::PCT, 1);
+		settings->add_portfolio_member(StrategyType::PCT, 3);
+		settings->add_portfolio_member(StrategyType::Random, 10);
+
+		// Only the third arm is rewarded, by finding a failure in every other iteration.
+		const size_t rewarded_arm = 2;
+		const size_t num_iterations = 1000;
+		auto strategy = std::make_unique<PortfolioStrategy>(settings.get());
+		size_t rewarded_arm_failures = 0;
+		for (size_t i = 1; i <= num_iterations; i++)
+		{
+			if (i > 1)
+			{
+				strategy->prepare_next_iteration(i);
+			}
+
+			uint64_t failure = 0;
+			if (strategy->current_strategy() == rewarded_arm && rewarded_arm_failures++ % 2 == 0)
+			{
+				failure = 1;
+			}
+
+			strategy->complete_iteration({ failure, 0, 0 });
+		}
+
+		const auto& statistics = strategy->statistics();
+		size_t total_iterations = 0;
+		for (size_t i = 0; i < statistics.size(); i++)
+		{
+			assert(statistics[i].iterations > 0, "an arm was never tried");
+			total_iterations += statistics[i].iterations;
+		}
+
+		assert(total_iterations == num_iterations, "unexpected iteration count");
+		assert(statistics[rewarded_arm].iterations > num_iterations * 3 / 4, "the bandit did not converge");
+
+		// Only the first iteration explored a new schedule.
+		size_t new_schedules = 0;
+		for (const auto& member : statistics)
+		{
+			new_schedules += member.new_schedules;
+		}
+
+		assert(new_schedules == 1, "unexpected new schedule count");
+
+		// The choices of the bandit only depend on the outcomes, so they are reproducible.
+		auto replay_strategy = std::make_unique<PortfolioStrategy>(settings.get());
+		rewarded_arm_failures = 0;
+		for (size_t i = 1; i <= num_iterations; i++)
+		{
+			if (i > 1)
+			{
+				replay_strategy->prepare_next_iteration(i);
+			}
+
+			uint64_t failure = 0;
+			if (replay_strategy->current_strategy() == rewarded_arm && rewarded_arm_failures++ % 2 == 0)
+			{
+				failure = 1;
+			}
+
+			replay_strategy->complete_iteration({ failure, 0, 0 });
+		}
+
+		for (size_t i = 0; i < statistics.size(); i++)
+		{
+			assert(replay_strategy->statistics()[i].iterations == statistics[i].iterations, "unexpected replayed choices");
+		}
+	}
+	catch (std::string error)
+	{
+		std::cout << "[test] failed: " << error << std::endl;
+		return 1;
+	}
+
+	std::cout << "[test] done in " << total_time(start_time) << "ms." << std::endl;
+	return 0;
+}
@@ -0,0 +1,89 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <sstream>
+#include "test.h"
+#include "coyote/tracing/chrome_trace.h"
+
+using namespace coyote;
+
+size_t count_occurrences(const std::string& text, const std::string& pattern)
+{
+	size_t count = 0;
+	for (size_t pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + 1))
+	{
+		count++;
+	}
+
+	return count;
+}
+
+int main()
+{
+	std::cout << "[test] started." << std::endl;
+	auto start_time = std::chrono::steady_clock::now();
+
+	try
+	{
+		// Operation '0' creates operation '1', joins it, and then resumes once it completes.
+		TraceRecord records[] = {
+			{ 1000, TraceEventType::Attach, 1, 0, 1 },
+			{ 2000, TraceEventType::CreateOperation, 1, 1, 0 },
+			{ 3000, TraceEventType::JoinOperation, 1, 0, 1 },
+			{ 3500, TraceEventType::WaitPendingOperations, 1, 0, 0 },
+			{ 4000, TraceEventType::StartOperation, 1, 1, 0 },
+			{ 4500, TraceEventType::ResumePendingOperations, 1, 0, 0 },
+			{ 5000, TraceEventType::ScheduleNext, 1, 0, 1 },
+			{ 6000, TraceEventType::CompleteOperation, 1, 1, 0 },
+			{ 6000, TraceEventType::EnableOperation, 1, 0, 1 },
+			{ 6500, TraceEventType::ScheduleNext, 1, 1, 0 },
+			{ 9250, TraceEventType::Detach, 1, 0, 1 }
+		};
+
+		std::ostringstream out;
+		ChromeTraceWriter writer(out);
+		for (auto& record : records)
+		{
+			writer.write(record);
+		}
+
+		writer.finish();
+		std::string json = out.str();
+#ifdef COYOTE_DEBUG_LOG
+		std::cout << json << std::endl;
+#endif // COYOTE_DEBUG_LOG
+
+		assert(json.rfind("{\"traceEvents\":[", 0) == 0, "missing trace events array");
+		assert(json.find("]}") == json.size() - 3, "unterminated trace events array");
+		assert(count_occurrences(json, "{") == count_occurrences(json, "}"), "unbalanced braces");
+		assert(count_occurrences(json, "\"process_name\"") == 1, "unexpected process names");
+		assert(count_occurrences(json, "\"thread_name\"") == 1, "unexpected thread names");
+
+		// The main operation runs until it joins, and resumes after operation '1' completes.
+		assert(json.find("{\"name\":\"running\",\"cat\":\"coyote\",\"ph\":\"X\",\"pid\":1,\"tid\":0,"
+			"\"ts\":1.000,\"dur\":2.000}") != std::string::npos, "missing first running span");
+		assert(json.find("{\"name\":\"running\",\"cat\":\"coyote\",\"ph\":\"X\",\"pid\":1,\"tid\":0,"
+			"\"ts\":6.500,\"dur\":2.750}") != std::string::npos, "missing last running span");
+
+		// The main operation stays blocked on the join after the pending operation starts.
+		assert(count_occurrences(json, "\"join operation 1\"") == 2, "unexpected join spans");
+		assert(json.find("\"name\":\"join operation 1\",\"cat\":\"coyote\",\"ph\":\"X\",\"pid\":1,\"tid\":0,"
+			"\"ts\":4.500,\"dur\":1.500}") != std::string::npos, "missing resumed join span");
+		assert(count_occurrences(json, "\"wait pending operations\"") == 1, "missing pending span");
+
+		// Operation '1' runs between the two handoffs.
+		assert(json.find("{\"name\":\"running\",\"cat\":\"coyote\",\"ph\":\"X\",\"pid\":1,\"tid\":1,"
+			"\"ts\":5.000,\"dur\":1.000}") != std::string::npos, "missing operation span");
+		assert(count_occurrences(json, "\"ph\":\"s\"") == 2, "unexpected flow starts");
+		assert(count_occurrences(json, "\"ph\":\"f\"") == 2, "unexpected flow ends");
+		assert(count_occurrences(json, "\"complete\"") == 1, "missing completion");
+	}
+	catch (std::string error)
+	{
+		std::cout << "[test] failed: " << error << std::endl;
+		return 1;
+	}
+
+	std::cout << "[test] done in " << total_time(start_time) << "ms." << std::endl;
+	return 0;
+}
@@ -59,6 +59,8 @@ int main()
 	}
 
 	strategy->prepare_next_iteration(2);
+	ReproductionToken token = strategy->reproduction_token();
+	assert(token.iteration == 2 && token.schedule_length == num_ops, "unexpected reproduction token");
 
 	size_t num_priority_changes = 0;
 	op = 0;
@@ -138,6 +140,30 @@ int main()
 		assert(int_choices[i] == value, "unexpected int choice");
 	}
 
+	// The token reproduces the second iteration on a new strategy, without running the first iteration.
+	ReproductionToken parsed_token;
+	assert(ReproductionToken::parse(token.to_string(), parsed_token), "failed to parse the reproduction token");
+	auto token_settings = std::make_unique<Settings>();
+	token_settings->reproduce(parsed_token);
+	auto token_strategy = std::make_unique<PCTStrategy>(token_settings.get());
+
+	op = 0;
+	for (int i = 0; i < num_ops; i++)
+	{
+		op = token_strategy->next_operation(ops, op);
+		assert(op_choices[i] == op, "unexpected op of the reproduced iteration");
+	}
+
+	for (int i = 0; i < num_bool_choices; i++)
+	{
+		assert(bool_choices[i] == token_strategy->next_boolean(), "unexpected bool choice of the reproduced iteration");
+	}
+
+	for (int i = 0; i < num_int_choices; i++)
+	{
+		assert(int_choices[i] == (size_t)token_strategy->next_integer(10), "unexpected int choice of the reproduced iteration");
+	}
+
 	std::cout << "[test] done in " << total_time(start_time) << "ms." << std::endl;
 	return 0;
 }
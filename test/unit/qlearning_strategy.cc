@@ -0,0 +1,92 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <vector>
+#include "test.h"
+#include "coyote/strategies/qlearning_strategy.h"
+
+using namespace coyote;
+
+// Runs iterations of a program in which the first choice between operations '1' and '2' decides the state
+// of the program, and returns the first choice of each iteration.
+std::vector<size_t> run_iterations(QLearningStrategy& strategy, size_t num_iterations)
+{
+	Operations ops;
+	ops.insert(1);
+	ops.insert(2);
+
+	std::vector<size_t> choices;
+	for (size_t i = 1; i <= num_iterations; i++)
+	{
+		if (i > 1)
+		{
+			strategy.prepare_next_iteration(i);
+		}
+
+		size_t op = strategy.next_operation(ops, 0);
+		strategy.report_state_hash(op);
+		strategy.next_operation(ops, op);
+		strategy.complete_iteration({ 0, 0, 0 });
+		choices.push_back(op);
+	}
+
+	return choices;
+}
+
+int main()
+{
+	std::cout << "[test] started." << std::endl;
+	auto start_time = std::chrono::steady_clock::now();
+
+	try
+	{
+		// The table keeps at most its capacity of entries, and remembers the entries that were not evicted.
+		QTable table(64);
+		assert(table.capacity() == 64, "unexpected table capacity");
+		for (uint64_t key = 0; key < 1000; key++)
+		{
+			table.at(key) = (double)key;
+		}
+
+		assert(table.size() <= table.capacity(), "the table exceeded its capacity");
+		assert(table.get(999) == 999, "the last added key was not found");
+		table.clear();
+		assert(table.size() == 0 && table.get(999) == 0, "the table was not cleared");
+
+		uint64_t seed = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+#ifdef COYOTE_DEBUG_LOG
+		std::cout << "[test] seed: " << seed << std::endl;
+#endif // COYOTE_DEBUG_LOG
+
+		// Without random exploration, the penalty of visited states makes the strategy alternate between
+		// the two states of the program.
+		auto settings = std::make_unique<Settings>();
+		settings->use_qlearning_strategy(seed, 0, 1024);
+		auto strategy = std::make_unique<QLearningStrategy>(settings.get());
+		std::vector<size_t> choices = run_iterations(*strategy, 40);
+		size_t first_op_count = 0;
+		for (size_t op : choices)
+		{
+			first_op_count += op == 1 ? 1 : 0;
+		}
+
+		assert(first_op_count >= 15 && first_op_count <= 25, "the strategy did not prefer less visited states");
+		assert(strategy->learned_values() <= 1024, "the strategy exceeded its capacity");
+
+		// Only the first iteration can be reproduced from a token, as later ones depend on learned values.
+		assert(!strategy->reproduction_token().is_reproducible(), "unexpected reproducible token");
+
+		// The choices only depend on the seed and the program.
+		auto replay_strategy = std::make_unique<QLearningStrategy>(settings.get());
+		assert(replay_strategy->reproduction_token().is_reproducible(), "unexpected non-reproducible token");
+		assert(run_iterations(*replay_strategy, 40) == choices, "unexpected replayed choices");
+	}
+	catch (std::string error)
+	{
+		std::cout << "[test] failed: " << error << std::endl;
+		return 1;
+	}
+
+	std::cout << "[test] done in " << total_time(start_time) << "ms." << std::endl;
+	return 0;
+}
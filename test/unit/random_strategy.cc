@@ -93,6 +93,22 @@ int main()
 		assert(int_choices[i] == value, "unexpected int choice");
 	}
 
+	// The token of a later iteration of another worker reproduces it directly.
+	settings->use_worker(1);
+	auto worker_strategy = std::make_unique<RandomStrategy>(settings.get());
+	for (size_t iteration = 2; iteration <= 5; iteration++)
+	{
+		worker_strategy->prepare_next_iteration(iteration);
+	}
+
+	auto token_settings = std::make_unique<Settings>();
+	token_settings->reproduce(worker_strategy->reproduction_token());
+	auto token_strategy = std::make_unique<RandomStrategy>(token_settings.get());
+	for (int i = 0; i < num_int_choices; i++)
+	{
+		assert(worker_strategy->next_integer(1000) == token_strategy->next_integer(1000), "unexpected worker choice");
+	}
+
 	std::cout << "[test] done in " << total_time(start_time) << "ms." << std::endl;
 	return 0;
 }
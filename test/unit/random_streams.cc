@@ -0,0 +1,87 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include "test.h"
+#include "coyote/strategies/random.h"
+
+using namespace coyote;
+
+// Returns true if both generators return the same next numbers.
+bool is_same_position(Random& left, Random& right)
+{
+	for (int i = 0; i < 16; i++)
+	{
+		if (left.next() != right.next())
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+int main()
+{
+	std::cout << "[test] started." << std::endl;
+	auto start_time = std::chrono::steady_clock::now();
+
+	try
+	{
+		uint64_t seed = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+#ifdef COYOTE_DEBUG_LOG
+		std::cout << "[test] seed: " << seed << std::endl;
+#endif // COYOTE_DEBUG_LOG
+
+		// The matrix of 2^64 steps, which is computed by squaring the matrix of a single step, must agree
+		// with the published jump polynomial.
+		Random left(seed);
+		Random right(seed);
+		left.jump();
+		right.jump(1);
+		assert(is_same_position(left, right), "jump matrix does not match the jump polynomial");
+
+		left.seed(seed);
+		right.seed(seed);
+		for (int i = 0; i < 13; i++)
+		{
+			left.jump();
+		}
+
+		right.jump(5);
+		right.jump(8);
+		assert(is_same_position(left, right), "jumps do not compose");
+
+		left.seed(seed);
+		right.seed(seed);
+		left.long_jump();
+		right.jump(1ull << 32);
+		assert(is_same_position(left, right), "unexpected long jump");
+
+		// Stream 'k' of worker 'w' is reached from the seed by 'w' long jumps and 'k' jumps.
+		left.seed(seed, 3, 7);
+		right.seed(seed);
+		for (int i = 0; i < 3; i++)
+		{
+			right.long_jump();
+		}
+
+		right.jump(7);
+		assert(is_same_position(left, right), "unexpected stream position");
+
+		left.seed(seed, 0, 0);
+		right.seed(seed);
+		assert(is_same_position(left, right), "the first stream does not start at the seed");
+
+		left.seed(seed, 1, 0);
+		right.seed(seed, 0, 1);
+		assert(!is_same_position(left, right), "streams of different workers overlap");
+	}
+	catch (std::string error)
+	{
+		std::cout << "[test] failed: " << error << std::endl;
+		return 1;
+	}
+
+	std::cout << "[test] done in " << total_time(start_time) << "ms." << std::endl;
+	return 0;
+}
@@ -0,0 +1,162 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <vector>
+#include "test.h"
+#include "coyote/schedules/schedule_diff.h"
+
+using namespace coyote;
+
+ScheduleTrace make_schedule(const std::vector<uint64_t>& ops)
+{
+	ScheduleTrace schedule;
+	for (uint64_t op : ops)
+	{
+		schedule.add_operation(op);
+	}
+
+	return schedule;
+}
+
+// Returns the number of steps that differ in an optimal alignment of the schedules.
+size_t edit_distance(const ScheduleTrace& left, const ScheduleTrace& right)
+{
+	std::vector<std::vector<size_t>> lcs(left.size() + 1, std::vector<size_t>(right.size() + 1, 0));
+	for (size_t i = 1; i <= left.size(); i++)
+	{
+		for (size_t j = 1; j <= right.size(); j++)
+		{
+			lcs[i][j] = left[i - 1] == right[j - 1] ? lcs[i - 1][j - 1] + 1 : std::max(lcs[i - 1][j], lcs[i][j - 1]);
+		}
+	}
+
+	return left.size() + right.size() - 2 * lcs[left.size()][right.size()];
+}
+
+size_t hunk_cost(const std::vector<ScheduleHunk>& hunks)
+{
+	size_t cost = 0;
+	for (auto& hunk : hunks)
+	{
+		cost += hunk.left_count + hunk.right_count;
+	}
+
+	return cost;
+}
+
+void test_diff(const ScheduleTrace& left, const ScheduleTrace& right)
+{
+	auto hunks = ScheduleDiff::diff(left.view(), right.view());
+	assert(ScheduleDiff::apply(left.view(), right.view(), hunks, hunks.size()) == right, "diff does not apply");
+	assert(ScheduleDiff::apply(left.view(), right.view(), hunks, 0) == left, "empty diff changed the schedule");
+	assert(hunk_cost(hunks) == edit_distance(left, right), "diff is not minimal");
+	for (size_t i = 1; i < hunks.size(); i++)
+	{
+		assert(hunks[i].left_start > hunks[i - 1].left_start + hunks[i - 1].left_count, "hunks are not separated");
+	}
+
+	// A diff that exceeds its cost bound falls back to a single hunk.
+	auto bounded_hunks = ScheduleDiff::diff(left.view(), right.view(), 0);
+	assert(bounded_hunks.size() <= 1, "unexpected bounded diff");
+	assert(ScheduleDiff::apply(left.view(), right.view(), bounded_hunks, 1) == right, "bounded diff does not apply");
+}
+
+int main()
+{
+	std::cout << "[test] started." << std::endl;
+	auto start_time = std::chrono::steady_clock::now();
+
+	try
+	{
+		ScheduleTrace left = make_schedule({ 1, 1, 2, 1, 2, 2, 0 });
+		ScheduleTrace right = make_schedule({ 1, 1, 2, 2, 2, 0, 0 });
+		assert(ScheduleDiff::first_divergence(left.view(), right.view()) == 3, "unexpected first divergence");
+		assert(ScheduleDiff::first_divergence(left.view(), left.view()) == left.size(), "unexpected divergence");
+		assert(ScheduleDiff::diff(left.view(), left.view()).empty(), "unexpected hunks of equal schedules");
+
+		// The fourth step is chosen by operation '2', the first time it makes a choice.
+		ScheduleDecision decision = ScheduleDiff::decision(left.view(), 3);
+		assert(decision.operation_id == 2 && decision.choice == 0, "unexpected decision");
+		decision = ScheduleDiff::decision(left.view(), 2);
+		assert(decision.operation_id == 1 && decision.choice == 1, "unexpected decision");
+		test_diff(left, right);
+
+		Random generator(std::chrono::high_resolution_clock::now().time_since_epoch().count());
+		for (int i = 0; i < 500; i++)
+		{
+			std::vector<uint64_t> left_ops(generator.next() % 40);
+			for (auto& op : left_ops)
+			{
+				op = generator.next() % 3;
+			}
+
+			// Edit a copy of the schedule, so that the schedules are close.
+			std::vector<uint64_t> right_ops(left_ops);
+			for (size_t edits = generator.next() % 6; edits > 0; edits--)
+			{
+				size_t position = right_ops.empty() ? 0 : generator.next() % right_ops.size();
+				switch (generator.next() % 3)
+				{
+				case 0:
+					right_ops.insert(right_ops.begin() + position, generator.next() % 3);
+					break;
+				case 1:
+					if (!right_ops.empty())
+					{
+						right_ops.erase(right_ops.begin() + position);
+					}
+
+					break;
+				default:
+					if (!right_ops.empty())
+					{
+						right_ops[position] = generator.next() % 3;
+					}
+
+					break;
+				}
+			}
+
+			test_diff(make_schedule(left_ops), make_schedule(right_ops));
+		}
+
+		// The failure happens whenever operation '7' gets scheduled, which only a single hunk does.
+		ScheduleTrace passing = make_schedule({ 0, 1, 0, 1, 1, 0, 1, 0, 0, 1, 1, 1, 0, 0, 1 });
+		ScheduleTrace failing = make_schedule({ 0, 1, 5, 1, 1, 0, 5, 0, 0, 1, 7, 1, 0, 5, 1 });
+		auto hunks = ScheduleDiff::diff(passing.view(), failing.view());
+		assert(hunks.size() >= 4, "unexpected hunk count");
+
+		auto evaluator = [](const ScheduleTrace& candidate)
+		{
+			ScheduleOutcome outcome = { 0, candidate };
+			for (size_t i = 0; i < candidate.size(); i++)
+			{
+				if (candidate[i].value == 7)
+				{
+					outcome.failure = 1;
+				}
+			}
+
+			return outcome;
+		};
+
+		ScheduleBisection bisection = ScheduleDiff::bisect(passing.view(), failing.view(), hunks, evaluator, 1);
+		assert(bisection.hunk < hunks.size(), "no decisive hunk was found");
+		const ScheduleHunk& hunk = hunks[bisection.hunk];
+		assert(hunk.right_start <= 10 && hunk.right_start + hunk.right_count > 10, "unexpected decisive hunk");
+		assert(bisection.evaluations <= 4, "unexpected evaluation count");
+		assert(bisection.schedule == ScheduleDiff::apply(passing.view(), failing.view(), hunks, bisection.hunk + 1),
+			"unexpected schedule");
+
+		bisection = ScheduleDiff::bisect(passing.view(), passing.view(), {}, evaluator, 1);
+		assert(bisection.hunk == 0 && bisection.schedule.empty(), "unexpected bisection of passing schedules");
+	}
+	catch (std::string error)
+	{
+		std::cout << "[test] failed: " << error << std::endl;
+		return 1;
+	}
+
+	std::cout << "[test] done in " << total_time(start_time) << "ms." << std::endl;
+	return 0;
+}
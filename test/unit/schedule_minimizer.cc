@@ -0,0 +1,145 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <array>
+#include "test.h"
+#include "coyote/schedules/schedule_minimizer.h"
+
+using namespace coyote;
+
+constexpr size_t NUM_OPS = 3;
+constexpr size_t NUM_STEPS = 20;
+constexpr uint64_t ATOMICITY_VIOLATION = 42;
+
+// Simulates three operations that each take a number of steps under the replay strategy, without any
+// threads. The program fails if operation '2' runs while operation '1' is in the middle of its steps.
+ScheduleOutcome simulate(const ScheduleTrace& candidate)
+{
+	auto settings = std::make_unique<Settings>();
+	settings->use_replay_strategy(candidate, 0);
+	ReplayStrategy strategy(settings.get());
+
+	Operations ops;
+	for (size_t i = 0; i < NUM_OPS; i++)
+	{
+		ops.insert(i);
+	}
+
+	std::array<size_t, NUM_OPS> steps = {};
+	ScheduleOutcome outcome;
+	size_t current = 0;
+	while (ops.size() > 0)
+	{
+		current = strategy.next_operation(ops, current);
+		outcome.schedule.add_operation(current);
+		if (current == 2 && steps[1] == NUM_STEPS / 2)
+		{
+			outcome.failure = ATOMICITY_VIOLATION;
+			break;
+		}
+
+		if (++steps[current] == NUM_STEPS)
+		{
+			ops.disable(current);
+		}
+	}
+
+	return outcome;
+}
+
+// Returns a random failing schedule with many context switches.
+ScheduleTrace find_failing_schedule(uint64_t seed)
+{
+	Random generator(seed);
+	while (true)
+	{
+		ScheduleTrace schedule;
+		for (size_t i = 0; i < NUM_OPS * NUM_STEPS; i++)
+		{
+			schedule.add_operation(generator.next() % NUM_OPS);
+		}
+
+		ScheduleOutcome outcome = simulate(schedule);
+		if (outcome.failure == ATOMICITY_VIOLATION)
+		{
+			return outcome.schedule;
+		}
+	}
+}
+
+// Returns true if dropping any single context switch of the failing schedule does not give a smaller
+// failing schedule.
+bool is_one_minimal(const ScheduleTrace& schedule)
+{
+	std::vector<size_t> switches = ScheduleMinimizer::context_switches(schedule);
+	for (size_t index : switches)
+	{
+		ScheduleTrace candidate = schedule;
+		candidate[index].flags |= SCHEDULE_STEP_SKIPPED;
+		ScheduleOutcome outcome = simulate(candidate);
+		if (outcome.failure == ATOMICITY_VIOLATION &&
+			ScheduleMinimizer::context_switches(outcome.schedule).size() < switches.size())
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+int main()
+{
+	std::cout << "[test] started." << std::endl;
+	auto start_time = std::chrono::steady_clock::now();
+
+	try
+	{
+		size_t seed = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+#ifdef COYOTE_DEBUG_LOG
+		std::cout << "[test] seed: " << seed << std::endl;
+#endif // COYOTE_DEBUG_LOG
+
+		ScheduleTrace failing_schedule = find_failing_schedule(seed);
+		size_t original_switches = ScheduleMinimizer::context_switches(failing_schedule).size();
+
+		// Replaying the failing schedule reproduces it exactly.
+		ScheduleOutcome replayed = simulate(failing_schedule);
+		assert(replayed.failure == ATOMICITY_VIOLATION, "replay did not reproduce the failure");
+		assert(replayed.schedule == failing_schedule, "replay diverged from the schedule");
+
+		size_t results[2];
+		for (size_t parallelism = 1; parallelism <= 2; parallelism++)
+		{
+			ScheduleMinimizer minimizer(simulate, parallelism * 4);
+			ScheduleTrace minimized = minimizer.minimize(failing_schedule, ATOMICITY_VIOLATION);
+			size_t switches = ScheduleMinimizer::context_switches(minimized).size();
+#ifdef COYOTE_DEBUG_LOG
+			std::cout << "[test] minimized " << original_switches << " switches and " << failing_schedule.size() <<
+				" steps to " << switches << " switches and " << minimized.size() << " steps in " <<
+				minimizer.evaluations() << " evaluations" << std::endl;
+#endif // COYOTE_DEBUG_LOG
+
+			assert(simulate(minimized).failure == ATOMICITY_VIOLATION, "minimized schedule does not fail");
+			assert(switches < original_switches, "schedule was not minimized");
+			assert(is_one_minimal(minimized), "schedule is not one-minimal");
+			assert(minimizer.evaluations() > 0, "no candidate was evaluated");
+			results[parallelism - 1] = minimized.size();
+		}
+
+		// The result does not depend on the number of threads.
+		assert(results[0] == results[1], "minimization is not deterministic");
+
+		// The evaluation budget is respected.
+		ScheduleMinimizer bounded_minimizer(simulate, 4, 3);
+		bounded_minimizer.minimize(failing_schedule, ATOMICITY_VIOLATION);
+		assert(bounded_minimizer.evaluations() <= 3, "evaluation budget was exceeded");
+	}
+	catch (std::string error)
+	{
+		std::cout << "[test] failed: " << error << std::endl;
+		return 1;
+	}
+
+	std::cout << "[test] done in " << total_time(start_time) << "ms." << std::endl;
+	return 0;
+}
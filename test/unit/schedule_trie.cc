@@ -0,0 +1,254 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <cstddef>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <vector>
+#include "test.h"
+#include "coyote/schedules/schedule_trie.h"
+#include "coyote/strategies/random.h"
+
+using namespace coyote;
+
+// The number of alternatives at each depth of the tree, where choice points without alternatives are
+// compressed into the labels of the trie.
+const std::vector<size_t> COUNTS = { 2, 1, 3, 1, 1, 2 };
+
+std::vector<ChoicePoint> to_branch(const std::vector<size_t>& indexes)
+{
+	std::vector<ChoicePoint> branch;
+	for (size_t i = 0; i < indexes.size(); i++)
+	{
+		branch.push_back({ COUNTS[i], indexes[i], COUNTS[i] });
+	}
+
+	return branch;
+}
+
+// Adds each prefix of the tree, from the root to the leaves.
+void add_prefixes(std::vector<size_t>& indexes, std::vector<std::vector<size_t>>& prefixes)
+{
+	prefixes.push_back(indexes);
+	if (indexes.size() < COUNTS.size())
+	{
+		for (size_t i = 0; i < COUNTS[indexes.size()]; i++)
+		{
+			indexes.push_back(i);
+			add_prefixes(indexes, prefixes);
+			indexes.pop_back();
+		}
+	}
+}
+
+// Returns true if all leaves that start with the specified prefix were marked.
+bool is_covered(const std::vector<size_t>& prefix, const std::set<std::vector<size_t>>& marked)
+{
+	for (size_t length = 0; length <= prefix.size(); length++)
+	{
+		if (marked.count(std::vector<size_t>(prefix.begin(), prefix.begin() + length)) > 0)
+		{
+			return true;
+		}
+	}
+
+	if (prefix.size() == COUNTS.size())
+	{
+		return false;
+	}
+
+	std::vector<size_t> child = prefix;
+	child.push_back(0);
+	for (size_t i = 0; i < COUNTS[prefix.size()]; i++)
+	{
+		child.back() = i;
+		if (!is_covered(child, marked))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// Checks each query of the trie against the marked branches.
+void check(ScheduleTrieView trie, const std::vector<std::vector<size_t>>& prefixes,
+	const std::set<std::vector<size_t>>& marked)
+{
+	for (auto& prefix : prefixes)
+	{
+		assert(trie.is_explored(to_branch(prefix)) == is_covered(prefix, marked), "unexpected explored prefix");
+		if (prefix.empty())
+		{
+			continue;
+		}
+
+		size_t expected = 0;
+		bool has_expected = false;
+		std::vector<size_t> sibling = prefix;
+		for (size_t i = prefix.back() + 1; i < COUNTS[prefix.size() - 1] && !has_expected; i++)
+		{
+			sibling.back() = i;
+			if (!is_covered(sibling, marked))
+			{
+				expected = i;
+				has_expected = true;
+			}
+		}
+
+		size_t index = 0;
+		assert(trie.next_unexplored(to_branch(prefix), index) == has_expected, "unexpected unexplored sibling");
+		assert(!has_expected || index == expected, "unexpected unexplored sibling");
+	}
+}
+
+void test_binary_tree()
+{
+	ScheduleTrie trie;
+	assert(!trie.is_explored({}), "empty trie is explored");
+	trie.mark_explored({ { 2, 0, 2 }, { 2, 1, 2 } });
+	assert(trie.is_explored({ { 2, 0, 2 }, { 2, 1, 2 } }), "branch was not marked");
+	assert(!trie.is_explored({ { 2, 0, 2 } }), "unexpected explored prefix");
+
+	size_t index = 0;
+	assert(trie.next_unexplored({ { 2, 0, 2 } }, index) && index == 1, "unexpected unexplored sibling");
+	assert(!trie.next_unexplored({ { 2, 0, 2 }, { 2, 0, 2 } }, index), "unexpected unexplored sibling");
+
+	// Once all alternatives of a choice point are explored, so is its prefix.
+	trie.mark_explored({ { 2, 0, 2 }, { 2, 0, 2 } });
+	assert(trie.is_explored({ { 2, 0, 2 } }), "explored subtree was not merged");
+	assert(trie.is_explored({ { 2, 0, 2 }, { 2, 0, 2 }, { 5, 3, 5 } }), "subtree of explored prefix is not explored");
+	trie.mark_explored({ { 2, 1, 2 } });
+	assert(trie.is_explored({}), "explored tree was not merged");
+}
+
+void test_path_compression()
+{
+	// A long branch of choices without other explored alternatives takes a single node.
+	std::vector<ChoicePoint> branch;
+	for (size_t i = 0; i < 1000; i++)
+	{
+		branch.push_back({ 3, i % 3, 3 });
+	}
+
+	ScheduleTrie trie;
+	trie.mark_explored(branch);
+	assert(trie.size() == 2, "branch was not compressed");
+	assert(trie.memory_size() < 2 * sizeof(ScheduleTrieNode) + 2 * branch.size() + 1, "choices were not compact");
+
+	// A diverging branch splits the node in two and adds a leaf.
+	branch[500].index = (branch[500].index + 1) % 3;
+	trie.mark_explored(branch);
+	assert(trie.size() == 4, "branch was not split");
+	assert(trie.is_explored(branch), "diverging branch was not marked");
+	branch.resize(501);
+	assert(!trie.is_explored(branch), "unexpected explored prefix");
+	size_t index = 0;
+	assert(trie.next_unexplored(branch, index), "unexplored sibling was not found");
+}
+
+void test_random_tree()
+{
+	std::vector<std::vector<size_t>> prefixes;
+	std::vector<size_t> indexes;
+	add_prefixes(indexes, prefixes);
+
+	for (uint64_t seed = 0; seed < 20; seed++)
+	{
+		Random generator(seed);
+		ScheduleTrie trie;
+		std::set<std::vector<size_t>> marked;
+		for (size_t i = 0; i < 12; i++)
+		{
+			auto& prefix = prefixes[generator.next() % prefixes.size()];
+			trie.mark_explored(to_branch(prefix));
+			marked.insert(prefix);
+			check(trie.view(), prefixes, marked);
+		}
+	}
+}
+
+void test_persistence()
+{
+	std::string path = (std::filesystem::temp_directory_path() / "coyote_schedule_trie.bin").string();
+	std::remove(path.c_str());
+
+	std::vector<std::vector<size_t>> prefixes;
+	std::vector<size_t> indexes;
+	add_prefixes(indexes, prefixes);
+
+	std::set<std::vector<size_t>> marked = { { 0, 0, 1 }, { 1 }, { 0, 0, 2, 0, 0, 1 } };
+	ScheduleTrie trie;
+	for (auto& prefix : marked)
+	{
+		trie.mark_explored(to_branch(prefix));
+	}
+
+	assert(trie.save(path), "failed to save the trie");
+	{
+		// The mapped file answers the same queries in place.
+		ScheduleTrieFile file;
+		assert(file.open(path), "failed to open the trie");
+		check(file.view(), prefixes, marked);
+
+		// A trie loaded from the file can be extended.
+		ScheduleTrie loaded(file.view());
+		loaded.mark_explored(to_branch({ 0, 0, 0 }));
+		marked.insert({ 0, 0, 0 });
+		check(loaded.view(), prefixes, marked);
+
+		// The new node is linked before an older sibling, and is saved after it.
+		file.close();
+		assert(loaded.save(path), "failed to save the extended trie");
+		assert(file.open(path), "failed to open the extended trie");
+		check(file.view(), prefixes, marked);
+	}
+
+	{
+		// A file whose links go backwards, which could form a cycle, is rejected.
+		ScheduleTrieFile file;
+		assert(file.open(path) && file.view().size() > 2, "failed to open the trie");
+		size_t last = file.view().size() - 1;
+		file.close();
+
+		std::fstream stream(path, std::ios::binary | std::ios::in | std::ios::out);
+		uint32_t sibling = 1;
+		stream.seekp(sizeof(ScheduleTrieHeader) + last * sizeof(ScheduleTrieNode) + offsetof(ScheduleTrieNode, next_sibling));
+		stream.write((const char*)&sibling, sizeof(sibling));
+		stream.close();
+		assert(!file.open(path), "trie with a cycle was opened");
+	}
+
+	{
+		// A truncated file is rejected.
+		std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+		ScheduleTrieFile file;
+		assert(!file.open(path), "truncated trie was opened");
+	}
+
+	std::remove(path.c_str());
+}
+
+int main()
+{
+	std::cout << "[test] started." << std::endl;
+	auto start_time = std::chrono::steady_clock::now();
+
+	try
+	{
+		test_binary_tree();
+		test_path_compression();
+		test_random_tree();
+		test_persistence();
+	}
+	catch (std::string error)
+	{
+		std::cout << "[test] failed: " << error << std::endl;
+		return 1;
+	}
+
+	std::cout << "[test] done in " << total_time(start_time) << "ms." << std::endl;
+	return 0;
+}
@@ -0,0 +1,110 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <set>
+#include <tuple>
+#include "test.h"
+#include "coyote/strategies/dfs_strategy.h"
+#include "coyote/strategies/visited_states.h"
+
+using namespace coyote;
+
+constexpr size_t STEPS = 4;
+
+// Enumerates the interleavings of two operations that each make the specified number of steps, where the
+// program state is the progress of each operation. Adds each reached state and the current operation to
+// the covered states, and returns the number of iterations that the enumeration took.
+size_t enumerate(DFSStrategy& strategy, std::set<std::tuple<size_t, size_t, size_t>>& covered_states)
+{
+	size_t iteration = 0;
+	while (strategy.enumerations() == 0)
+	{
+		iteration++;
+		if (iteration > 1)
+		{
+			strategy.prepare_next_iteration(iteration);
+		}
+
+		Operations ops;
+		ops.insert(1);
+		ops.insert(2);
+		size_t progress[3] = { 0, 0, 0 };
+		size_t current = 0;
+		while (ops.size() > 0)
+		{
+			covered_states.insert(std::make_tuple(progress[1], progress[2], current));
+			strategy.report_state_hash(progress[1] * (STEPS + 1) + progress[2]);
+			current = strategy.next_operation(ops, current);
+			if (++progress[current] == STEPS)
+			{
+				ops.remove(current);
+			}
+		}
+
+		strategy.complete_iteration({ 0, 0, 0 });
+	}
+
+	return iteration;
+}
+
+void test_visited_states()
+{
+	VisitedStates states(100);
+	assert(states.capacity() == 128, "unexpected capacity");
+	assert(states.insert(0) && states.insert(42), "new state was not added");
+	assert(!states.insert(42) && states.contains(0) && states.contains(42), "visited state was not found");
+	assert(!states.contains(7) && states.size() == 2, "unexpected states");
+
+	// The memory is bounded, so old states are forgotten once it is full.
+	for (uint64_t state = 100; state < 10000; state++)
+	{
+		states.insert(state);
+	}
+
+	assert(states.size() <= states.capacity(), "visited states exceeded their capacity");
+	states.clear();
+	assert(states.size() == 0 && !states.contains(42), "visited states were not cleared");
+}
+
+void test_dfs_pruning()
+{
+	Settings settings;
+	settings.use_dfs_strategy();
+	DFSStrategy stateless_strategy(&settings);
+	std::set<std::tuple<size_t, size_t, size_t>> stateless_states;
+	size_t stateless_iterations = enumerate(stateless_strategy, stateless_states);
+	assert(stateless_strategy.pruned_iterations() == 0, "unexpected pruned iterations");
+
+	settings.enable_state_caching(1 << 10);
+	DFSStrategy stateful_strategy(&settings);
+	std::set<std::tuple<size_t, size_t, size_t>> stateful_states;
+	size_t stateful_iterations = enumerate(stateful_strategy, stateful_states);
+
+	// Pruning the interleavings that reach a visited state covers the same states in fewer iterations.
+	assert(stateful_states == stateless_states, "pruning lost states");
+	assert(stateful_iterations < stateless_iterations, "visited states were not pruned");
+	assert(stateful_strategy.pruned_iterations() > 0, "unexpected pruned iterations");
+
+	// The visited states are forgotten once the enumeration completes, so the next one explores again.
+	assert(stateful_strategy.visited_state_count() == 0, "visited states were not cleared");
+}
+
+int main()
+{
+	std::cout << "[test] started." << std::endl;
+	auto start_time = std::chrono::steady_clock::now();
+
+	try
+	{
+		test_visited_states();
+		test_dfs_pruning();
+	}
+	catch (std::string error)
+	{
+		std::cout << "[test] failed: " << error << std::endl;
+		return 1;
+	}
+
+	std::cout << "[test] done in " << total_time(start_time) << "ms." << std::endl;
+	return 0;
+}
@@ -0,0 +1,81 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include "coyote/service/campaign_coordinator.h"
+
+using namespace coyote;
+
+// Coordinates a campaign that is split into shards across local or remote workers, and prints the merged
+// results once all shards completed.
+// Usage: coyote_coordinator <socket-path> <random|pct|pos|portfolio|bandit> <seed> <bound> <shards> <iterations>
+int main(int argc, char** argv)
+{
+	if (argc < 7)
+	{
+		std::cerr << "usage: " << argv[0] <<
+			" <socket-path> <random|pct|pos|portfolio|bandit> <seed> <bound> <shards> <iterations>" << std::endl;
+		return 1;
+	}
+
+	std::string strategy_name(argv[2]);
+	StrategyType strategy;
+	if (strategy_name == "random")
+	{
+		strategy = StrategyType::Random;
+	}
+	else if (strategy_name == "pct")
+	{
+		strategy = StrategyType::PCT;
+	}
+	else if (strategy_name == "pos")
+	{
+		strategy = StrategyType::POS;
+	}
+	else if (strategy_name == "portfolio")
+	{
+		strategy = StrategyType::Portfolio;
+	}
+	else if (strategy_name == "bandit")
+	{
+		strategy = StrategyType::Bandit;
+	}
+	else
+	{
+		std::cerr << "unknown strategy '" << strategy_name << "'" << std::endl;
+		return 1;
+	}
+
+	uint64_t seed = std::strtoull(argv[3], nullptr, 10);
+	uint64_t bound = std::strtoull(argv[4], nullptr, 10);
+	size_t shard_count = (size_t)std::strtoull(argv[5], nullptr, 10);
+	uint64_t shard_iterations = std::strtoull(argv[6], nullptr, 10);
+	if (shard_count == 0 || shard_iterations == 0)
+	{
+		std::cerr << "the campaign must have at least one shard and one iteration per shard" << std::endl;
+		return 1;
+	}
+
+	CampaignCoordinator coordinator(argv[1], strategy, seed, bound, shard_count, shard_iterations);
+	if (coordinator.start() != ErrorCode::Success)
+	{
+		std::cerr << "failed to listen on '" << argv[1] << "'" << std::endl;
+		return 1;
+	}
+
+	std::cout << "[coyote_coordinator] listening on " << argv[1] << " with " << shard_count << " shards" << std::endl;
+	CampaignSummary summary = coordinator.wait();
+	coordinator.stop();
+
+	std::cout << "iterations: " << summary.iterations << std::endl;
+	std::cout << "failures: " << summary.failures << std::endl;
+	std::cout << "distinct schedules: " << summary.coverage.size() << std::endl;
+	for (auto& kvp : summary.bugs)
+	{
+		std::cout << "bug " << kvp.first << ": " << kvp.second.token.to_string() << std::endl;
+	}
+
+	return summary.bugs.empty() ? 0 : 2;
+}
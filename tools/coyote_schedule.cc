@@ -0,0 +1,167 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include "coyote/schedules/schedule_corpus.h"
+#include "coyote/schedules/schedule_diff.h"
+
+using namespace coyote;
+
+void print_step(const ScheduleStep& step)
+{
+	switch (step.kind)
+	{
+	case ScheduleStepKind::Operation:
+		std::cout << "op " << step.value;
+		break;
+	case ScheduleStepKind::Boolean:
+		std::cout << "bool " << (step.value != 0 ? "true" : "false");
+		break;
+	case ScheduleStepKind::Integer:
+		std::cout << "int " << (int64_t)step.value;
+		break;
+	}
+}
+
+// Prints the steps in the [start, start + count) range, along with the decision that each step made.
+void print_steps(const char* prefix, ScheduleView schedule, size_t start, size_t count)
+{
+	std::unordered_map<uint64_t, size_t> choice_counts;
+	uint64_t current = 0;
+	for (size_t i = 0; i < start + count; i++)
+	{
+		size_t choice = 0;
+		uint64_t operation_id = current;
+		if (schedule[i].kind == ScheduleStepKind::Operation)
+		{
+			choice = choice_counts[current]++;
+			current = schedule[i].value;
+		}
+
+		if (i >= start)
+		{
+			std::cout << prefix << " [" << i << "] op " << operation_id << " choice " << choice << ": ";
+			print_step(schedule[i]);
+			std::cout << std::endl;
+		}
+	}
+}
+
+int list(ScheduleCorpus& corpus)
+{
+	for (size_t i = 0; i < corpus.size(); i++)
+	{
+		ScheduleView schedule = corpus.schedule(i);
+		std::cout << "[" << i << "] seed " << corpus.seed(i) << " tag " << corpus.tag(i) << " steps " <<
+			schedule.size() << (corpus.is_valid(i) ? "" : " (corrupted)") << std::endl;
+	}
+
+	if (corpus.is_truncated())
+	{
+		std::cout << "the corpus ends with a torn record" << std::endl;
+	}
+
+	return 0;
+}
+
+int show(ScheduleCorpus& corpus, size_t index)
+{
+	ScheduleView schedule = corpus.schedule(index);
+	print_steps(" ", schedule, 0, schedule.size());
+	return 0;
+}
+
+int diff(ScheduleCorpus& corpus, size_t left_index, size_t right_index)
+{
+	ScheduleView left = corpus.schedule(left_index);
+	ScheduleView right = corpus.schedule(right_index);
+	auto hunks = ScheduleDiff::diff(left, right);
+	if (hunks.empty())
+	{
+		std::cout << "the schedules are equal" << std::endl;
+		return 0;
+	}
+
+	size_t step = ScheduleDiff::first_divergence(left, right);
+	ScheduleDecision decision = ScheduleDiff::decision(left, step);
+	std::cout << "first divergence at step " << step << ", choice " << decision.choice << " of op " <<
+		decision.operation_id << std::endl;
+	for (auto& hunk : hunks)
+	{
+		std::cout << "@@ -" << hunk.left_start << "," << hunk.left_count << " +" << hunk.right_start << "," <<
+			hunk.right_count << " @@" << std::endl;
+		print_steps("-", left, hunk.left_start, hunk.left_count);
+		print_steps("+", right, hunk.right_start, hunk.right_count);
+	}
+
+	return 1;
+}
+
+// Inspects a schedule corpus that was recorded by the scheduler.
+// Usage: coyote_schedule <corpus> [list | show <index> | diff <left-index> <right-index> | verify | compact]
+int main(int argc, char** argv)
+{
+	std::string command = argc > 2 ? argv[2] : "list";
+	size_t argument_count = command == "show" ? 1 : command == "diff" ? 2 : 0;
+	size_t expected_argc = argc > 2 ? 3 + argument_count : 2;
+	if (argc < 2 || (size_t)argc != expected_argc)
+	{
+		std::cerr << "usage: " << argv[0] << " <corpus> [list | show <index> | diff <left-index> <right-index> | "
+			"verify | compact]" << std::endl;
+		return 1;
+	}
+
+	if (command == "compact")
+	{
+		if (!ScheduleCorpus::compact(argv[1]))
+		{
+			std::cerr << "failed to compact '" << argv[1] << "'" << std::endl;
+			return 1;
+		}
+
+		return 0;
+	}
+
+	ScheduleCorpus corpus;
+	if (!corpus.open(argv[1]))
+	{
+		std::cerr << "'" << argv[1] << "' is not a valid schedule corpus" << std::endl;
+		return 1;
+	}
+
+	size_t indexes[2] = { 0, 0 };
+	for (size_t i = 0; i < argument_count; i++)
+	{
+		indexes[i] = std::strtoull(argv[3 + i], nullptr, 10);
+		if (indexes[i] >= corpus.size())
+		{
+			std::cerr << "the corpus has " << corpus.size() << " schedules" << std::endl;
+			return 1;
+		}
+	}
+
+	if (command == "list")
+	{
+		return list(corpus);
+	}
+	else if (command == "show")
+	{
+		return show(corpus, indexes[0]);
+	}
+	else if (command == "diff")
+	{
+		return diff(corpus, indexes[0], indexes[1]);
+	}
+	else if (command == "verify")
+	{
+		bool is_valid = corpus.verify() && !corpus.is_truncated();
+		std::cout << (is_valid ? "the corpus is intact" : "the corpus is corrupted") << std::endl;
+		return is_valid ? 0 : 1;
+	}
+
+	std::cerr << "unknown command '" << command << "'" << std::endl;
+	return 1;
+}
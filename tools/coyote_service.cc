@@ -0,0 +1,64 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include "coyote/service/scheduler_server.h"
+
+using namespace coyote;
+
+// Runs a scheduler as a local daemon that controls operations living in several processes.
+// Usage: coyote_service <socket-path> [random|pct] [seed] [bound]
+int main(int argc, char** argv)
+{
+	if (argc < 2)
+	{
+		std::cerr << "usage: " << argv[0] << " <socket-path> [random|pct] [seed] [bound]" << std::endl;
+		return 1;
+	}
+
+	std::string socket_path(argv[1]);
+	std::string strategy = argc > 2 ? argv[2] : "random";
+	auto settings = std::make_unique<Settings>();
+	uint64_t seed = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : settings->random_seed();
+	if (strategy == "pct")
+	{
+		settings->use_pct_strategy(seed, argc > 4 ? std::strtoull(argv[4], nullptr, 10) : 10);
+	}
+	else if (strategy == "random")
+	{
+		settings->use_random_strategy(seed, argc > 4 ? std::strtoull(argv[4], nullptr, 10) : 100);
+	}
+	else
+	{
+		std::cerr << "unknown strategy '" << strategy << "'" << std::endl;
+		return 1;
+	}
+
+	// Block the termination signals before starting any thread, so that only this thread receives them.
+	sigset_t signals;
+	sigemptyset(&signals);
+	sigaddset(&signals, SIGINT);
+	sigaddset(&signals, SIGTERM);
+	pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+	Scheduler scheduler(std::move(settings));
+	SchedulerServer server(&scheduler, socket_path);
+	if (server.start() != ErrorCode::Success)
+	{
+		std::cerr << "failed to listen on '" << socket_path << "'" << std::endl;
+		return 1;
+	}
+
+	std::cout << "[coyote_service] listening on " << socket_path << " with seed " << seed << std::endl;
+
+	int signal = 0;
+	sigwait(&signals, &signal);
+
+	// Release any operations that are still paused, so that their connections can close.
+	scheduler.detach();
+	server.stop();
+	return 0;
+}
@@ -0,0 +1,101 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include "coyote/tracing/chrome_trace.h"
+#include "coyote/tracing/trace_reader.h"
+
+using namespace coyote;
+
+// Exports the trace to the Chrome Trace Event JSON format.
+int export_chrome_trace(TraceReader& reader, const std::string& path)
+{
+	std::ofstream file(path);
+	if (!file.is_open())
+	{
+		std::cerr << "failed to create '" << path << "'" << std::endl;
+		return 1;
+	}
+
+	ChromeTraceWriter writer(file);
+	TraceRecord record;
+	while (reader.next(record))
+	{
+		writer.write(record);
+	}
+
+	writer.finish();
+	return 0;
+}
+
+// Renders a binary trace file that was written by the scheduler in a readable form, or exports it to the
+// Chrome Trace Event JSON format, which can be opened in 'chrome://tracing' or in the Perfetto UI.
+// Usage: coyote_trace <trace-file> [--chrome <json-file>]
+int main(int argc, char** argv)
+{
+	if (argc != 2 && !(argc == 4 && std::string(argv[2]) == "--chrome"))
+	{
+		std::cerr << "usage: " << argv[0] << " <trace-file> [--chrome <json-file>]" << std::endl;
+		return 1;
+	}
+
+	TraceReader reader;
+	if (!reader.open(argv[1]))
+	{
+		std::cerr << "'" << argv[1] << "' is not a valid trace file" << std::endl;
+		return 1;
+	}
+
+	if (argc == 4)
+	{
+		return export_chrome_trace(reader, argv[3]);
+	}
+
+	TraceRecord record;
+	while (reader.next(record))
+	{
+		std::cout << "[" << record.iteration << "] " << std::fixed << std::setprecision(3) <<
+			std::setw(12) << (record.timestamp / 1000.0) << "us " << std::left << std::setw(26) <<
+			trace_event_name(record.type) << std::right << " op " << record.operation_id;
+		switch (record.type)
+		{
+		case TraceEventType::Attach:
+		case TraceEventType::Detach:
+			std::cout << " iteration " << record.value;
+			break;
+		case TraceEventType::CreateOperation:
+			std::cout << " by op " << record.value;
+			break;
+		case TraceEventType::JoinOperation:
+			std::cout << " joins op " << record.value;
+			break;
+		case TraceEventType::CreateResource:
+		case TraceEventType::WaitResource:
+		case TraceEventType::SignalResource:
+		case TraceEventType::DeleteResource:
+			std::cout << " resource " << record.value;
+			break;
+		case TraceEventType::EnableOperation:
+			std::cout << " by op " << record.value;
+			break;
+		case TraceEventType::WaitPendingOperations:
+			std::cout << " pending " << record.value;
+			break;
+		case TraceEventType::ScheduleNext:
+			std::cout << " -> op " << record.value;
+			break;
+		case TraceEventType::DroppedEvents:
+			std::cout << " count " << record.value;
+			break;
+		default:
+			break;
+		}
+
+		std::cout << std::endl;
+	}
+
+	return 0;
+}